@@ -10,10 +10,20 @@
 #include "speechapi_cxx_common.h"
 #include "speechapi_cxx_string_helpers.h"
 #include "speechapi_cxx_smart_handle.h"
+#include "speechapi_cxx_async_executor.h"
+#include "speechapi_cxx_async_operation.h"
+#include "speechapi_cxx_cancellation_token.h"
 
 #include "speechapi_cxx_properties.h"
+#include "speechapi_cxx_property_traits.h"
 #include "speechapi_cxx_audio_stream_format.h"
 #include "speechapi_cxx_audio_stream.h"
+#include "speechapi_cxx_audio_ring_buffer.h"
+#include "speechapi_cxx_tee_audio_output_stream.h"
+#include "speechapi_cxx_wav_file_output_stream.h"
+#include "speechapi_cxx_mapped_wav_pull_stream.h"
+#include "speechapi_cxx_ring_pull_audio_input_stream.h"
+#include "speechapi_cxx_buffered_push_audio_input_stream.h"
 #include "speechapi_cxx_speech_config.h"
 #include "speechapi_cxx_embedded_speech_config.h"
 #include "speechapi_cxx_hybrid_speech_config.h"
@@ -78,7 +88,15 @@
 #include "speechapi_cxx_speech_synthesis_word_boundary_eventargs.h"
 #include "speechapi_cxx_speech_synthesis_viseme_eventargs.h"
 #include "speechapi_cxx_speech_synthesis_bookmark_eventargs.h"
+#include "speechapi_cxx_speech_synthesis_batch_eventargs.h"
 #include "speechapi_cxx_speech_synthesizer.h"
+#include "speechapi_cxx_ssml_writer.h"
+#include "speechapi_cxx_ssml_dialogue_converter.h"
+#include "speechapi_cxx_ssml_segmenter.h"
+#include "speechapi_cxx_parallel_speech_synthesizer.h"
+#include "speechapi_cxx_speech_synthesizer_pool.h"
+#include "speechapi_cxx_speech_synthesis_cache.h"
+#include "speechapi_cxx_speech_synthesis_coalescer.h"
 #include "speechapi_cxx_synthesis_voices_result.h"
 #include "speechapi_cxx_voice_info.h"
 
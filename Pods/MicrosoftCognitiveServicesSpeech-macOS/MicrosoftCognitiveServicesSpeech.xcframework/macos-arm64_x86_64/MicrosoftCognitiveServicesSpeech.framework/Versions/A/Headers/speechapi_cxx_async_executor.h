@@ -0,0 +1,344 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_async_executor.h: Public API declarations for AsyncExecutor and ThreadPoolAsyncExecutor C++ classes
+//
+
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "speechapi_cxx_common.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+
+/// <summary>
+/// Runs the work behind the *Async methods of the API, e.g. <see cref="SpeechSynthesizer::SpeakTextAsync"/>.
+/// Work items that wait for the native library, such as the body of SpeakTextAsync, run on the blocking executor
+/// (<see cref="GetBlocking"/>); short work items, such as continuations, run on the default executor (<see cref="GetDefault"/>).
+/// </summary>
+class AsyncExecutor
+{
+public:
+
+    /// <summary>
+    /// Destructor.
+    /// </summary>
+    virtual ~AsyncExecutor() = default;
+
+    /// <summary>
+    /// Schedules a work item. It must run exactly once, on any thread; exceptions it throws are already captured in its future.
+    /// </summary>
+    /// <param name="work">The work item.</param>
+    virtual void Post(std::function<void()> work) = 0;
+
+    /// <summary>
+    /// Replaces the executor running short work items. Work items already posted keep running on the previous executor.
+    /// </summary>
+    /// <param name="executor">The executor, or nullptr to restore the default bounded <see cref="ThreadPoolAsyncExecutor"/>.</param>
+    static void SetDefault(std::shared_ptr<AsyncExecutor> executor)
+    {
+        std::atomic_store(&Instance(), std::move(executor));
+    }
+
+    /// <summary>
+    /// Gets the executor running short work items, creating the default bounded <see cref="ThreadPoolAsyncExecutor"/> on first call.
+    /// </summary>
+    /// <returns>The executor.</returns>
+    static std::shared_ptr<AsyncExecutor> GetDefault();
+
+    /// <summary>
+    /// Replaces the executor running work items that block on the native library. Work items already posted keep running
+    /// on the previous executor. Work items posted while all of its threads are busy may wait in a queue; operations that
+    /// end others, e.g. <see cref="SpeechSynthesizer::StopSpeakingAsync"/>, start them on the calling thread.
+    /// </summary>
+    /// <param name="executor">The executor, or nullptr to restore the default bounded <see cref="ThreadPoolAsyncExecutor"/>.</param>
+    static void SetBlocking(std::shared_ptr<AsyncExecutor> executor)
+    {
+        std::atomic_store(&BlockingInstance(), std::move(executor));
+    }
+
+    /// <summary>
+    /// Gets the executor running work items that block on the native library, creating the default bounded
+    /// <see cref="ThreadPoolAsyncExecutor"/> on first call. Requests beyond its thread limit wait in its queue.
+    /// </summary>
+    /// <returns>The executor.</returns>
+    static std::shared_ptr<AsyncExecutor> GetBlocking();
+
+protected:
+
+    /*! \cond PROTECTED */
+
+    AsyncExecutor() = default;
+
+    /*! \endcond */
+
+private:
+
+    DISABLE_COPY_AND_MOVE(AsyncExecutor);
+
+    static std::shared_ptr<AsyncExecutor>& Instance()
+    {
+        static std::shared_ptr<AsyncExecutor> instance;
+        return instance;
+    }
+
+    static std::shared_ptr<AsyncExecutor>& BlockingInstance()
+    {
+        static std::shared_ptr<AsyncExecutor> instance;
+        return instance;
+    }
+
+    template <class Create>
+    static std::shared_ptr<AsyncExecutor> GetOrCreate(std::shared_ptr<AsyncExecutor>& instance, Create create)
+    {
+        auto executor = std::atomic_load(&instance);
+        if (executor == nullptr)
+        {
+            std::shared_ptr<AsyncExecutor> created = create();
+            executor = std::atomic_compare_exchange_strong(&instance, &executor, created) ? created : executor;
+        }
+        return executor;
+    }
+};
+
+/// <summary>
+/// Thread pool, the default <see cref="AsyncExecutor"/>. Threads are started on demand up to a maximum and exit
+/// after staying idle for a while; work items posted while all threads are busy wait in a queue.
+/// The default and the blocking executor (<see cref="AsyncExecutor::GetBlocking"/>) are separate instances.
+/// </summary>
+/// <remarks>
+/// A work item posted from one of the pool's own threads while the pool is saturated runs immediately on that thread,
+/// so *Async calls made from inside other *Async work cannot wait on themselves.
+/// </remarks>
+class ThreadPoolAsyncExecutor : public AsyncExecutor
+{
+public:
+
+    /// <summary>
+    /// Gets the default maximum number of threads: four per hardware thread, and at least 16.
+    /// </summary>
+    /// <returns>The number of threads.</returns>
+    static size_t GetDefaultMaxThreads()
+    {
+        return std::max<size_t>(16, 4 * static_cast<size_t>(std::thread::hardware_concurrency()));
+    }
+
+    /// <summary>
+    /// Constructor.
+    /// </summary>
+    /// <param name="maxThreads">Maximum number of threads running work items; std::numeric_limits&lt;size_t&gt;::max() for no limit.</param>
+    /// <param name="idleTimeout">Time after which an idle thread exits.</param>
+    explicit ThreadPoolAsyncExecutor(size_t maxThreads = GetDefaultMaxThreads(), std::chrono::milliseconds idleTimeout = std::chrono::seconds(30)) :
+        m_state(std::make_shared<State>(maxThreads, idleTimeout))
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, maxThreads == 0);
+    }
+
+    /// <summary>
+    /// Destructor. Queued work items still run; the threads exit once the queue is empty and are not waited for.
+    /// </summary>
+    ~ThreadPoolAsyncExecutor()
+    {
+        std::unique_lock<std::mutex> lock(m_state->mutex);
+        m_state->stopped = true;
+        m_state->workAvailable.notify_all();
+    }
+
+    /// <inheritdoc/>
+    void Post(std::function<void()> work) override
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, work == nullptr);
+
+        std::unique_lock<std::mutex> lock(m_state->mutex);
+        auto saturated = m_state->queue.size() >= m_state->idleThreads && m_state->threads >= m_state->maxThreads;
+        if (saturated && CurrentPool() == m_state.get())
+        {
+            lock.unlock();
+            work();
+            return;
+        }
+
+        m_state->queue.push_back(std::move(work));
+        if (m_state->queue.size() <= m_state->idleThreads)
+        {
+            m_state->workAvailable.notify_one();
+            return;
+        }
+
+        if (m_state->threads < m_state->maxThreads)
+        {
+            m_state->threads++;
+            try
+            {
+                auto state = m_state;
+                std::thread([state]() { RunWorker(state); }).detach();
+            }
+            catch (...)
+            {
+                // Leave the item queued for the running threads; only fail if there are none.
+                m_state->threads--;
+                if (m_state->threads == 0)
+                {
+                    m_state->queue.pop_back();
+                    throw;
+                }
+            }
+        }
+    }
+
+    /// <summary>
+    /// Gets the number of threads currently started.
+    /// </summary>
+    /// <returns>The number of threads.</returns>
+    size_t GetThreadCount() const
+    {
+        std::unique_lock<std::mutex> lock(m_state->mutex);
+        return m_state->threads;
+    }
+
+    /// <summary>
+    /// Gets the number of work items waiting for a thread.
+    /// </summary>
+    /// <returns>The number of work items.</returns>
+    size_t GetQueueLength() const
+    {
+        std::unique_lock<std::mutex> lock(m_state->mutex);
+        return m_state->queue.size();
+    }
+
+private:
+
+    DISABLE_COPY_AND_MOVE(ThreadPoolAsyncExecutor);
+
+    // Shared with the worker threads, which are detached and may outlive the executor.
+    struct State
+    {
+        State(size_t maxThreads, std::chrono::milliseconds idleTimeout) :
+            maxThreads(maxThreads),
+            idleTimeout(idleTimeout)
+        {
+        }
+
+        std::mutex mutex;
+        std::condition_variable workAvailable;
+        std::deque<std::function<void()>> queue;
+
+        const size_t maxThreads;
+        const std::chrono::milliseconds idleTimeout;
+
+        size_t threads = 0;
+        size_t idleThreads = 0;
+        bool stopped = false;
+    };
+
+    static const State*& CurrentPool()
+    {
+        static thread_local const State* pool = nullptr;
+        return pool;
+    }
+
+    static void RunWorker(std::shared_ptr<State> state)
+    {
+        CurrentPool() = state.get();
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        for (;;)
+        {
+            if (!state->queue.empty())
+            {
+                auto work = std::move(state->queue.front());
+                state->queue.pop_front();
+                lock.unlock();
+
+                try
+                {
+                    work();
+                }
+                catch (const std::exception& ex)
+                {
+                    SPX_TRACE_ERROR("Exception caught while running an asynchronous operation: %s", ex.what());
+                    (void)ex;
+                }
+                catch (...)
+                {
+                    SPX_TRACE_ERROR("Unknown exception caught while running an asynchronous operation.");
+                }
+                work = nullptr;
+
+                lock.lock();
+                continue;
+            }
+
+            if (state->stopped)
+            {
+                break;
+            }
+
+            state->idleThreads++;
+            auto woken = state->workAvailable.wait_for(lock, state->idleTimeout, [&state] { return !state->queue.empty() || state->stopped; });
+            state->idleThreads--;
+            if (!woken)
+            {
+                break;
+            }
+        }
+
+        state->threads--;
+        lock.unlock();
+        CurrentPool() = nullptr;
+    }
+
+    std::shared_ptr<State> m_state;
+};
+
+inline std::shared_ptr<AsyncExecutor> AsyncExecutor::GetDefault()
+{
+    return GetOrCreate(Instance(), []() { return std::make_shared<ThreadPoolAsyncExecutor>(); });
+}
+
+inline std::shared_ptr<AsyncExecutor> AsyncExecutor::GetBlocking()
+{
+    return GetOrCreate(BlockingInstance(), []() { return std::make_shared<ThreadPoolAsyncExecutor>(); });
+}
+
+/*! \cond PRIVATE */
+
+namespace Details {
+
+    /// <summary>
+    /// Runs a function that blocks on the native library on <see cref="AsyncExecutor::GetBlocking"/>; the replacement
+    /// for std::async(std::launch::async, ...). Unlike the future returned by std::async, the returned future does not
+    /// block in its destructor, and requests beyond the executor's thread limit are queued instead of each starting a thread.
+    /// </summary>
+    template <class Function>
+    std::future<decltype(std::declval<typename std::decay<Function>::type&>()())> RunAsync(Function&& function)
+    {
+        using Result = decltype(std::declval<typename std::decay<Function>::type&>()());
+
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+        auto future = task->get_future();
+        AsyncExecutor::GetBlocking()->Post([task]() { (*task)(); });
+        return future;
+    }
+
+}
+
+/*! \endcond */
+
+} } } // Microsoft::CognitiveServices::Speech
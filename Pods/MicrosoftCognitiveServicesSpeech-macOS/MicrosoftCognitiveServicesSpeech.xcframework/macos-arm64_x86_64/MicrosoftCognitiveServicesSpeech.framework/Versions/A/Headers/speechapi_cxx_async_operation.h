@@ -0,0 +1,252 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_async_operation.h: Public API declarations for the AsyncOperation<TResult> C++ awaitable template class
+//
+
+#pragma once
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "speechapi_cxx_common.h"
+#include "speechapi_cxx_async_executor.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+
+/*! \cond PRIVATE */
+
+namespace Details {
+
+    /// <summary>
+    /// State shared by an <see cref="AsyncOperation"/> and the code completing it.
+    /// </summary>
+    template <class TResult>
+    class AsyncOperationState
+    {
+    public:
+
+        AsyncOperationState() = default;
+
+        void SetResult(TResult result)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_result = std::move(result);
+            Complete(lock);
+        }
+
+        void SetException(std::exception_ptr error)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_error = std::move(error);
+            Complete(lock);
+        }
+
+        bool IsCompleted() const
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            return m_completed;
+        }
+
+        // Returns false, without storing the continuation, if the operation already completed.
+        bool SetContinuation(std::function<void()> continuation)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_completed)
+            {
+                return false;
+            }
+            m_continuation = std::move(continuation);
+            return true;
+        }
+
+        TResult GetResult()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            SPX_THROW_HR_IF(SPXERR_INVALID_STATE, !m_completed);
+            if (m_error != nullptr)
+            {
+                std::rethrow_exception(m_error);
+            }
+            return m_result;
+        }
+
+    private:
+
+        DISABLE_COPY_AND_MOVE(AsyncOperationState);
+
+        // The continuation is resumed on the default AsyncExecutor, not on the thread completing the operation,
+        // which is typically a native callback thread that must not run user code for long.
+        void Complete(std::unique_lock<std::mutex>& lock)
+        {
+            SPX_THROW_HR_IF(SPXERR_INVALID_STATE, m_completed);
+            m_completed = true;
+            auto continuation = std::move(m_continuation);
+            lock.unlock();
+
+            if (continuation != nullptr)
+            {
+                try
+                {
+                    AsyncExecutor::GetDefault()->Post(continuation);
+                }
+                catch (...)
+                {
+                    // Resuming on this thread is better than never resuming.
+                    SPX_TRACE_ERROR("Unable to schedule the continuation of an awaitable operation; resuming it inline.");
+                    continuation();
+                }
+            }
+        }
+
+        mutable std::mutex m_mutex;
+        bool m_completed = false;
+        std::function<void()> m_continuation;
+        TResult m_result{};
+        std::exception_ptr m_error;
+    };
+
+    /// <summary>
+    /// An awaitable operation completed from the native event that ends it, instead of by a thread waiting for it.
+    /// The native handle of the operation can only be released once the operation returned, which is just after that
+    /// event; <see cref="SetHandle"/> and <see cref="End"/> return it to the owner, once, when both happened.
+    /// </summary>
+    template <class TResult>
+    class EventCompletedOperation
+    {
+    public:
+
+        EventCompletedOperation() :
+            m_state(std::make_shared<AsyncOperationState<TResult>>())
+        {
+        }
+
+        std::shared_ptr<AsyncOperationState<TResult>> GetState() const
+        {
+            return m_state;
+        }
+
+        // Called once the start call returned the handle. Returns it if the operation already ended.
+        SPXASYNCHANDLE SetHandle(SPXASYNCHANDLE hasync)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_hasync = hasync;
+            return m_ended ? hasync : SPXHANDLE_INVALID;
+        }
+
+        // Called from the event ending the operation. Returns the handle if the start call already returned it.
+        SPXASYNCHANDLE End()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_ended = true;
+            return m_hasync;
+        }
+
+        // Completes the operation with makeResult(), unless it already completed; then makeResult is not called and
+        // false is returned. Called from native callbacks, so it does not throw.
+        template <class TMakeResult>
+        bool Complete(TMakeResult makeResult)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                if (m_completed)
+                {
+                    return false;
+                }
+                m_completed = true;
+            }
+
+            try
+            {
+                m_state->SetResult(makeResult());
+            }
+            catch (...)
+            {
+                try
+                {
+                    m_state->SetException(std::current_exception());
+                }
+                catch (...)
+                {
+                    SPX_TRACE_ERROR("Unable to complete an awaitable operation.");
+                }
+            }
+            return true;
+        }
+
+    private:
+
+        DISABLE_COPY_AND_MOVE(EventCompletedOperation);
+
+        std::shared_ptr<AsyncOperationState<TResult>> m_state;
+        std::mutex m_mutex;
+        SPXASYNCHANDLE m_hasync = SPXHANDLE_INVALID;
+        bool m_ended = false;
+        bool m_completed = false;
+    };
+
+}
+
+/*! \endcond */
+
+/// <summary>
+/// An asynchronous operation that can be awaited with co_await in a C++20 coroutine.
+/// The coroutine is resumed on the default <see cref="AsyncExecutor"/>; no thread is blocked while the operation runs.
+/// </summary>
+template <class TResult>
+class AsyncOperation
+{
+public:
+
+    /*! \cond PROTECTED */
+
+    /// <summary>
+    /// Constructor.
+    /// </summary>
+    /// <param name="state">State completed by the operation.</param>
+    explicit AsyncOperation(std::shared_ptr<Details::AsyncOperationState<TResult>> state) :
+        m_state(std::move(state))
+    {
+    }
+
+    /*! \endcond */
+
+    /// <summary>
+    /// Checks if the operation completed.
+    /// </summary>
+    /// <returns>true if the result is available.</returns>
+    bool IsCompleted() const { return m_state->IsCompleted(); }
+
+    /// <summary>
+    /// Awaiter interface: checks if the operation completed.
+    /// </summary>
+    bool await_ready() const { return m_state->IsCompleted(); }
+
+    /// <summary>
+    /// Awaiter interface: resumes the coroutine on completion.
+    /// </summary>
+    /// <param name="coroutine">Handle of the awaiting coroutine.</param>
+    /// <returns>false if the operation completed meanwhile and the coroutine continues right away.</returns>
+    template <class TCoroutineHandle>
+    bool await_suspend(TCoroutineHandle coroutine)
+    {
+        return m_state->SetContinuation([coroutine]() mutable { coroutine.resume(); });
+    }
+
+    /// <summary>
+    /// Awaiter interface: gets the result, or throws the error the operation failed with.
+    /// </summary>
+    /// <returns>The result.</returns>
+    TResult await_resume() { return m_state->GetResult(); }
+
+private:
+
+    std::shared_ptr<Details::AsyncOperationState<TResult>> m_state;
+};
+
+} } } // Microsoft::CognitiveServices::Speech
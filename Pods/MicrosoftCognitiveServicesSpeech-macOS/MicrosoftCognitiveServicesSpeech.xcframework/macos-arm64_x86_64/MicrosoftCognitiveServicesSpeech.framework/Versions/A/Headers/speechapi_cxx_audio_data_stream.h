@@ -7,9 +7,11 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 
 #include "speechapi_cxx_common.h"
+#include "speechapi_cxx_async_executor.h"
 #include "speechapi_cxx_smart_handle.h"
 #include "speechapi_cxx_properties.h"
 #include "speechapi_cxx_utils.h"
@@ -121,12 +123,13 @@ public:
     /// <summary>
     /// Check whether the stream has enough data to be read, starting from the specified position.
     /// </summary>
-    /// <param name="pos">The position counting from start of the stream.</param>
+    /// <param name="pos">The position counting from start of the stream, up to 4 GiB; larger positions throw SPXERR_INVALID_ARG.</param>
     /// <param name="bytesRequested">The requested data size in bytes.</param>
     /// <returns>A bool indicating whether the stream has enough data to be read.</returns>
-    bool CanReadData(uint32_t pos, uint32_t bytesRequested)
+    bool CanReadData(uint64_t pos, uint32_t bytesRequested)
     {
-        return audio_data_stream_can_read_data_from_position(m_haudioStream, bytesRequested, pos);
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, pos > MaxNativePosition);
+        return audio_data_stream_can_read_data_from_position(m_haudioStream, bytesRequested, static_cast<uint32_t>(pos));
     }
 
     /// <summary>
@@ -139,6 +142,7 @@ public:
     {
         uint32_t filledSize = 0;
         SPX_THROW_ON_FAIL(audio_data_stream_read(m_haudioStream, buffer, bufferSize, &filledSize));
+        m_position += filledSize;
 
         return filledSize;
     }
@@ -146,14 +150,17 @@ public:
     /// <summary>
     /// Reads a chunk of the audio data and fill it to given buffer, starting from the specified position.
     /// </summary>
-    /// <param name="pos">The position counting from start of the stream.</param>
+    /// <param name="pos">The position counting from start of the stream, up to 4 GiB; larger positions throw SPXERR_INVALID_ARG.</param>
     /// <param name="buffer">A buffer to receive read data.</param>
     /// <param name="bufferSize">Size of the buffer.</param>
     /// <returns>Size of data filled to the buffer, 0 means end of stream</returns>
-    uint32_t ReadData(uint32_t pos, uint8_t* buffer, uint32_t bufferSize)
+    uint32_t ReadData(uint64_t pos, uint8_t* buffer, uint32_t bufferSize)
     {
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, pos > MaxNativePosition);
+
         uint32_t filledSize = 0;
-        SPX_THROW_ON_FAIL(audio_data_stream_read_from_position(m_haudioStream, buffer, bufferSize, pos, &filledSize));
+        SPX_THROW_ON_FAIL(audio_data_stream_read_from_position(m_haudioStream, buffer, bufferSize, static_cast<uint32_t>(pos), &filledSize));
+        m_position = pos + filledSize;
 
         return filledSize;
     }
@@ -176,7 +183,7 @@ public:
     {
         auto keepAlive = this->shared_from_this();
 
-        auto future = std::async(std::launch::async, [keepAlive, this, fileName]() -> void {
+        auto future = Details::RunAsync([keepAlive, this, fileName]() -> void {
             SPX_THROW_ON_FAIL(audio_data_stream_save_to_wave_file(m_haudioStream, Utils::ToUTF8(fileName).c_str()));
         });
 
@@ -184,7 +191,8 @@ public:
     }
 
     /// <summary>
-    /// Get current position of the audio data stream.
+    /// Get current position of the audio data stream, as reported by the native stream. Use <see cref="GetPosition64"/>
+    /// for streams longer than 4 GiB.
     /// </summary>
     /// <returns>Current position</returns>
     uint32_t GetPosition()
@@ -194,13 +202,28 @@ public:
         return position;
     }
 
+    /// <summary>
+    /// Get current position of the audio data stream, including positions past 4 GiB reached by reading on sequentially.
+    /// The position is tracked by this object only, so it is wrong if the same native stream is read through another handle.
+    /// </summary>
+    /// <returns>Current position</returns>
+    uint64_t GetPosition64() const
+    {
+        return m_position;
+    }
+
     /// <summary>
     /// Set current position of the audio data stream.
     /// </summary>
+    /// <remarks>
+    /// The native stream addresses positions up to 4 GiB only; larger positions throw SPXERR_INVALID_ARG.
+    /// </remarks>
     /// <param name="pos">Position to be set.</param>
-    void SetPosition(uint32_t pos)
+    void SetPosition(uint64_t pos)
     {
-        SPX_THROW_ON_FAIL(audio_data_stream_set_position(m_haudioStream, pos));
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, pos > MaxNativePosition);
+        SPX_THROW_ON_FAIL(audio_data_stream_set_position(m_haudioStream, static_cast<uint32_t>(pos)));
+        m_position = pos;
     }
 
     /// <summary>
@@ -234,6 +257,13 @@ private:
     {
         SPX_DBG_TRACE_SCOPE(__FUNCTION__, __FUNCTION__);
     }
+
+    enum : uint32_t { MaxNativePosition = UINT32_MAX };
+
+    /// <summary>
+    /// Internal member variable that holds the position, which the native stream only reports up to 4 GiB.
+    /// </summary>
+    uint64_t m_position{ 0 };
 };
 
 } } } // Microsoft::CognitiveServices::Speech
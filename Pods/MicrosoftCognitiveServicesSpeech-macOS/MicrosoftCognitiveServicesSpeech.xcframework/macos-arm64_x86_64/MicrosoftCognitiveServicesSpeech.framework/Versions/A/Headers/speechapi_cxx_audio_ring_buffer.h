@@ -0,0 +1,293 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_audio_ring_buffer.h: Public API declarations for RingBufferOutputStreamCallback C++ class
+//
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#include "speechapi_cxx_common.h"
+#include "speechapi_cxx_audio_stream.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+
+/*! \cond PRIVATE */
+
+namespace Details {
+
+    // Lock-free ring of bytes for one producer thread and one consumer thread. The capacity is a power of two, so
+    // positions are free-running counters masked into the buffer. Each side keeps its own position and a cached copy
+    // of the other side's on separate cache lines, and only reloads the other side's position when the cached copy
+    // says the ring is full or empty.
+    class AudioRingBuffer
+    {
+    public:
+
+        explicit AudioRingBuffer(size_t capacity) :
+            m_capacity(RoundUpToPowerOfTwo(capacity)),
+            m_mask(m_capacity - 1),
+            m_buffer(new uint8_t[m_capacity])
+        {
+        }
+
+        size_t GetCapacity() const
+        {
+            return m_capacity;
+        }
+
+        // Number of bytes that can be read; exact on the consumer thread, a lower bound elsewhere.
+        size_t GetAvailable() const
+        {
+            return static_cast<size_t>(m_write.position.load(std::memory_order_acquire) - m_read.position.load(std::memory_order_acquire));
+        }
+
+        // Producer side. Copies as many bytes as fit and returns their number.
+        size_t Write(const uint8_t* data, size_t size)
+        {
+            auto write = m_write.position.load(std::memory_order_relaxed);
+            auto free = m_capacity - static_cast<size_t>(write - m_write.other);
+            if (free < size)
+            {
+                m_write.other = m_read.position.load(std::memory_order_acquire);
+                free = m_capacity - static_cast<size_t>(write - m_write.other);
+            }
+            size = std::min(size, free);
+            Copy(m_buffer.get(), static_cast<size_t>(write & m_mask), data, size);
+            m_write.position.store(write + size, std::memory_order_release);
+            return size;
+        }
+
+        // Consumer side. Copies as many bytes as are available and returns their number.
+        size_t Read(uint8_t* data, size_t size)
+        {
+            auto read = m_read.position.load(std::memory_order_relaxed);
+            auto available = static_cast<size_t>(m_read.other - read);
+            if (available < size)
+            {
+                m_read.other = m_write.position.load(std::memory_order_acquire);
+                available = static_cast<size_t>(m_read.other - read);
+            }
+            size = std::min(size, available);
+            auto offset = static_cast<size_t>(read & m_mask);
+            auto first = std::min(size, m_capacity - offset);
+            std::memcpy(data, m_buffer.get() + offset, first);
+            std::memcpy(data + first, m_buffer.get(), size - first);
+            m_read.position.store(read + size, std::memory_order_release);
+            return size;
+        }
+
+    private:
+
+        DISABLE_COPY_AND_MOVE(AudioRingBuffer);
+
+        static size_t RoundUpToPowerOfTwo(size_t size)
+        {
+            SPX_THROW_HR_IF(SPXERR_INVALID_ARG, size == 0 || size > (static_cast<size_t>(-1) >> 1) + 1);
+            size_t capacity = 1;
+            while (capacity < size)
+            {
+                capacity <<= 1;
+            }
+            return capacity;
+        }
+
+        void Copy(uint8_t* buffer, size_t offset, const uint8_t* data, size_t size)
+        {
+            auto first = std::min(size, m_capacity - offset);
+            std::memcpy(buffer + offset, data, first);
+            std::memcpy(buffer, data + first, size - first);
+        }
+
+        static constexpr size_t CacheLineSize = 64;
+
+        // The position owned by one side and its cached copy of the other side's, padded to a cache line.
+        struct Side
+        {
+            std::atomic<uint64_t> position{ 0 };
+            uint64_t other = 0;
+            char padding[CacheLineSize - sizeof(std::atomic<uint64_t>) - sizeof(uint64_t)];
+        };
+
+        const size_t m_capacity;
+        const size_t m_mask;
+        const std::unique_ptr<uint8_t[]> m_buffer;
+        char m_padding[CacheLineSize];
+        Side m_write;
+        Side m_read;
+    };
+
+}
+
+/*! \endcond */
+
+namespace Audio {
+
+/// <summary>
+/// Counters of a <see cref="RingBufferOutputStreamCallback"/>.
+/// </summary>
+struct RingBufferOutputStreamMetrics
+{
+    /// <summary>
+    /// Number of bytes written by the synthesizer and stored.
+    /// </summary>
+    uint64_t WrittenBytes = 0;
+
+    /// <summary>
+    /// Number of bytes read by the consumer.
+    /// </summary>
+    uint64_t ReadBytes = 0;
+
+    /// <summary>
+    /// Number of writes that did not fit completely because the ring was full.
+    /// </summary>
+    uint64_t Overruns = 0;
+
+    /// <summary>
+    /// Number of bytes dropped because the ring was full.
+    /// </summary>
+    uint64_t DroppedBytes = 0;
+
+    /// <summary>
+    /// Number of reads that got less than requested before the stream was closed.
+    /// </summary>
+    uint64_t Underruns = 0;
+};
+
+/// <summary>
+/// A <see cref="PushAudioOutputStreamCallback"/> storing the synthesized audio in a fixed-size ring, from which a
+/// playback thread reads without blocking.
+/// </summary>
+/// <remarks>
+/// The ring is lock-free for one writer, the synthesizer, and one reader. Nothing is allocated after construction and
+/// neither side ever waits for the other, so the callback can feed an audio render thread directly.
+/// Audio that does not fit in the ring is dropped and counted as an overrun; choose a capacity covering the longest
+/// expected gap between reads.
+/// </remarks>
+class RingBufferOutputStreamCallback : public PushAudioOutputStreamCallback
+{
+public:
+
+    /// <summary>
+    /// Creates a callback with a ring of at least the given capacity.
+    /// </summary>
+    /// <param name="capacity">The capacity in bytes, rounded up to a power of two.</param>
+    /// <returns>A shared pointer to the callback, to pass to <see cref="AudioOutputStream::CreatePushStream"/>.</returns>
+    static std::shared_ptr<RingBufferOutputStreamCallback> Create(size_t capacity)
+    {
+        return std::shared_ptr<RingBufferOutputStreamCallback>(new RingBufferOutputStreamCallback(capacity));
+    }
+
+    /// <summary>
+    /// Stores audio in the ring. Called by the synthesizer.
+    /// </summary>
+    /// <param name="dataBuffer">The audio data.</param>
+    /// <param name="size">The size of the audio data in bytes.</param>
+    /// <returns>The number of bytes stored; the others were dropped.</returns>
+    int Write(uint8_t* dataBuffer, uint32_t size) override
+    {
+        auto written = m_ring.Write(dataBuffer, size);
+        m_writtenBytes.fetch_add(written, std::memory_order_relaxed);
+        if (written < size)
+        {
+            m_overruns.fetch_add(1, std::memory_order_relaxed);
+            m_droppedBytes.fetch_add(size - written, std::memory_order_relaxed);
+        }
+        return static_cast<int>(written);
+    }
+
+    /// <summary>
+    /// Marks the end of the audio. Called by the synthesizer.
+    /// </summary>
+    void Close() override
+    {
+        m_closed.store(true, std::memory_order_release);
+    }
+
+    /// <summary>
+    /// Reads audio from the ring without blocking. Must be called from one thread at a time.
+    /// </summary>
+    /// <param name="dataBuffer">The buffer receiving the audio. Bytes past the returned count are left untouched.</param>
+    /// <param name="size">The size of the buffer in bytes.</param>
+    /// <returns>The number of bytes read, possibly 0.</returns>
+    uint32_t Read(uint8_t* dataBuffer, uint32_t size)
+    {
+        // Load the flag before reading, so that audio written before Close is not mistaken for the end.
+        auto closed = m_closed.load(std::memory_order_acquire);
+        auto read = static_cast<uint32_t>(m_ring.Read(dataBuffer, size));
+        m_readBytes.fetch_add(read, std::memory_order_relaxed);
+        if (read < size && !closed)
+        {
+            m_underruns.fetch_add(1, std::memory_order_relaxed);
+        }
+        return read;
+    }
+
+    /// <summary>
+    /// Gets the number of bytes that can be read.
+    /// </summary>
+    /// <returns>The number of bytes.</returns>
+    size_t GetAvailable() const
+    {
+        return m_ring.GetAvailable();
+    }
+
+    /// <summary>
+    /// Gets the capacity of the ring.
+    /// </summary>
+    /// <returns>The capacity in bytes.</returns>
+    size_t GetCapacity() const
+    {
+        return m_ring.GetCapacity();
+    }
+
+    /// <summary>
+    /// Gets whether the synthesizer closed the stream and all audio has been read.
+    /// </summary>
+    /// <returns>true at the end of the audio.</returns>
+    bool IsEndOfStream() const
+    {
+        return m_closed.load(std::memory_order_acquire) && m_ring.GetAvailable() == 0;
+    }
+
+    /// <summary>
+    /// Gets the counters of the callback.
+    /// </summary>
+    /// <returns>A copy of the counters.</returns>
+    RingBufferOutputStreamMetrics GetMetrics() const
+    {
+        RingBufferOutputStreamMetrics metrics;
+        metrics.WrittenBytes = m_writtenBytes.load(std::memory_order_relaxed);
+        metrics.ReadBytes = m_readBytes.load(std::memory_order_relaxed);
+        metrics.Overruns = m_overruns.load(std::memory_order_relaxed);
+        metrics.DroppedBytes = m_droppedBytes.load(std::memory_order_relaxed);
+        metrics.Underruns = m_underruns.load(std::memory_order_relaxed);
+        return metrics;
+    }
+
+private:
+
+    explicit RingBufferOutputStreamCallback(size_t capacity) :
+        m_ring(capacity)
+    {
+    }
+
+    DISABLE_COPY_AND_MOVE(RingBufferOutputStreamCallback);
+
+    Speech::Details::AudioRingBuffer m_ring;
+    std::atomic<bool> m_closed{ false };
+    std::atomic<uint64_t> m_writtenBytes{ 0 };
+    std::atomic<uint64_t> m_readBytes{ 0 };
+    std::atomic<uint64_t> m_overruns{ 0 };
+    std::atomic<uint64_t> m_droppedBytes{ 0 };
+    std::atomic<uint64_t> m_underruns{ 0 };
+};
+
+} } } } // Microsoft::CognitiveServices::Speech::Audio
@@ -14,6 +14,7 @@
 #include <cstring>
 #include "speechapi_cxx_common.h"
 #include "speechapi_cxx_smart_handle.h"
+#include "speechapi_cxx_string_helpers.h"
 #include "speechapi_cxx_audio_stream_format.h"
 #include "speechapi_cxx_enums.h"
 #include "speechapi_c_audio_stream.h"
@@ -353,6 +354,30 @@ public:
         }
     }
 
+    /// <summary>
+    /// Gets the DataBuffer_TimeStamp of the data returned by the last Read, without allocating. Called before
+    /// <see cref="GetProperty"/>, which is used when this returns false.
+    /// </summary>
+    /// <param name="timestamp">Receives the timestamp.</param>
+    /// <returns>true if the timestamp was set.</returns>
+    virtual bool GetTimeStamp(uint64_t& timestamp)
+    {
+        UNUSED(timestamp);
+        return false;
+    }
+
+    /// <summary>
+    /// Gets the DataBuffer_UserId of the data returned by the last Read, without allocating. Called before
+    /// <see cref="GetProperty"/>, which is used when this returns false.
+    /// </summary>
+    /// <param name="userId">Receives a null-terminated string owned by the callback, valid until the next Read.</param>
+    /// <returns>true if the user id was set.</returns>
+    virtual bool GetUserId(const char*& userId)
+    {
+        UNUSED(userId);
+        return false;
+    }
+
     /// <summary>
     /// This function is called to close the audio stream.
     /// </summary>
@@ -474,15 +499,22 @@ public:
     /// <returns>A shared pointer to PullAudioInputStream</returns>
     static std::shared_ptr<PullAudioInputStream> Create(std::shared_ptr<AudioStreamFormat> format, void* pvContext, CUSTOM_AUDIO_PULL_STREAM_READ_CALLBACK readCallback, CUSTOM_AUDIO_PULL_STREAM_CLOSE_CALLBACK closeCallback, CUSTOM_AUDIO_PULL_STREAM_GET_PROPERTY_CALLBACK getPropertyCallback)
     {
-        return Create(format,
-            [=](uint8_t* buffer, uint32_t size) -> int { return readCallback(pvContext, buffer, size); },
-            [=]() { if (closeCallback != nullptr) { closeCallback(pvContext); } },
-            [=](PropertyId id) -> SPXSTRING
-                {
-                    uint8_t result[m_maxPropertyLen];
-                    getPropertyCallback(pvContext, static_cast<int>(id), result, m_maxPropertyLen);
-                    return reinterpret_cast<char*>(result);
-             });
+        format = UseDefaultFormatIfNull(format);
+
+        SPXAUDIOSTREAMHANDLE haudioStream = SPXHANDLE_INVALID;
+        SPX_THROW_ON_FAIL(audio_stream_create_pull_audio_input_stream(&haudioStream, GetFormatHandle(format)));
+
+        // The callbacks already have the native signatures, so the native stream calls them directly; the property
+        // callback writes straight into the native buffer.
+        auto stream = new PullAudioInputStream(haudioStream);
+        std::shared_ptr<PullAudioInputStream> ptr(stream);
+        if (closeCallback == nullptr)
+        {
+            closeCallback = [](void*) {};
+        }
+        SPX_THROW_ON_FAIL(pull_audio_input_stream_set_callbacks(haudioStream, pvContext, readCallback, closeCallback));
+        SPX_THROW_ON_FAIL(pull_audio_input_stream_set_getproperty_callback(haudioStream, pvContext, getPropertyCallback));
+        return ptr;
     }
 
     /// <summary>
@@ -604,6 +636,22 @@ private:
     static void GetPropertyCallbackWrapper(void *pvContext, int id, uint8_t* result, uint32_t size)
     {
         PullAudioInputStream* ptr = (PullAudioInputStream*)pvContext;
+        auto text = reinterpret_cast<char*>(result);
+        uint64_t timestamp = 0;
+        const char* userId = nullptr;
+        if (static_cast<PropertyId>(id) == PropertyId::DataBuffer_TimeStamp && ptr->m_callback->GetTimeStamp(timestamp))
+        {
+            SPX_THROW_HR_IF(SPXERR_INVALID_ARG, Utils::FormatDecimal(timestamp, text, size) == 0);
+            return;
+        }
+        if (static_cast<PropertyId>(id) == PropertyId::DataBuffer_UserId && ptr->m_callback->GetUserId(userId))
+        {
+            auto userIdSize = userId != nullptr ? std::strlen(userId) + 1 : 1;
+            SPX_THROW_HR_IF(SPXERR_INVALID_ARG, userIdSize > size);
+            std::memcpy(text, userId != nullptr ? userId : "", userIdSize);
+            return;
+        }
+
         auto value = ptr->m_callback->GetProperty(static_cast<PropertyId>(id));
         auto valueSize = value.size() + 1;
         SPX_THROW_HR_IF(SPXERR_INVALID_ARG, valueSize > size);
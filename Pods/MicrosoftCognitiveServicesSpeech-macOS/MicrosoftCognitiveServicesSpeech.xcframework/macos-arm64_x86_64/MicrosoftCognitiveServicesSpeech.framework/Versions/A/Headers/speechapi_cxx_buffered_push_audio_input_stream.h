@@ -0,0 +1,267 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_buffered_push_audio_input_stream.h: Public API declarations for BufferedPushAudioInputStream C++ class
+//
+
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+#include "speechapi_cxx_common.h"
+#include "speechapi_cxx_enums.h"
+#include "speechapi_cxx_string_helpers.h"
+#include "speechapi_cxx_audio_stream_format.h"
+#include "speechapi_cxx_audio_stream.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+namespace Audio {
+
+/// <summary>
+/// Options of a <see cref="BufferedPushAudioInputStream"/>.
+/// </summary>
+struct BufferedPushAudioInputStreamOptions
+{
+    /// <summary>
+    /// Size of the blocks passed to the native stream, in bytes. The default is 100 ms of the default input format.
+    /// </summary>
+    uint32_t BlockSize = 3200;
+
+    /// <summary>
+    /// Size of an audio frame in bytes, e.g. 4 for 16 bit stereo. The block size is rounded down to a multiple of it.
+    /// </summary>
+    uint32_t BlockAlign = 2;
+
+    /// <summary>
+    /// A partial block is passed on by the first write after its oldest audio has been buffered this long.
+    /// </summary>
+    std::chrono::milliseconds MaxDelay{ 200 };
+};
+
+/// <summary>
+/// Counters of a <see cref="BufferedPushAudioInputStream"/>.
+/// </summary>
+struct BufferedPushAudioInputStreamMetrics
+{
+    /// <summary>
+    /// Number of writes to this stream.
+    /// </summary>
+    uint64_t Frames = 0;
+
+    /// <summary>
+    /// Number of writes to the native stream.
+    /// </summary>
+    uint64_t Blocks = 0;
+
+    /// <summary>
+    /// Number of bytes written.
+    /// </summary>
+    uint64_t Bytes = 0;
+};
+
+/// <summary>
+/// A push audio input stream gathering small writes, such as 10 ms capture frames, into larger blocks before passing
+/// them to the native stream, which copies each write.
+/// </summary>
+/// <remarks>
+/// A block is passed on when it is full, when its oldest audio is older than the maximum delay at the next write, on
+/// <see cref="Flush"/> and on <see cref="Close"/>. Writes larger than a block skip the buffer.
+/// A timestamp given with a write is set as the DataBuffer_TimeStamp property of the block starting with that write;
+/// it is formatted once per block. Write through this class, not through <see cref="PushAudioInputStream::Write"/>,
+/// so that buffered audio keeps its order.
+/// </remarks>
+class BufferedPushAudioInputStream : public PushAudioInputStream
+{
+public:
+
+    /// <summary>
+    /// Destructor. Passes on the buffered audio; the base class closes the stream.
+    /// </summary>
+    ~BufferedPushAudioInputStream()
+    {
+        try
+        {
+            Flush();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    /// <summary>
+    /// Creates a stream of the given format.
+    /// </summary>
+    /// <param name="format">The format of the audio, the default input format if nullptr.</param>
+    /// <param name="options">The options of the stream.</param>
+    /// <returns>A shared pointer to the stream, to pass to <see cref="AudioConfig::FromStreamInput"/>.</returns>
+    static std::shared_ptr<BufferedPushAudioInputStream> Create(std::shared_ptr<AudioStreamFormat> format = nullptr, const BufferedPushAudioInputStreamOptions& options = BufferedPushAudioInputStreamOptions())
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, options.BlockAlign == 0 || options.BlockSize < options.BlockAlign);
+        format = UseDefaultFormatIfNull(format);
+
+        SPXAUDIOSTREAMHANDLE haudioStream = SPXHANDLE_INVALID;
+        SPX_THROW_ON_FAIL(audio_stream_create_push_audio_input_stream(&haudioStream, GetFormatHandle(format)));
+
+        auto stream = new BufferedPushAudioInputStream(haudioStream, options);
+        return std::shared_ptr<BufferedPushAudioInputStream>(stream);
+    }
+
+    /// <summary>
+    /// Appends audio to the current block.
+    /// Note: The dataBuffer should not contain any audio header.
+    /// </summary>
+    /// <param name="dataBuffer">The audio data, copied before the call returns.</param>
+    /// <param name="size">The size of the audio data in bytes.</param>
+    void Write(const uint8_t* dataBuffer, uint32_t size)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        Append(dataBuffer, size);
+    }
+
+    /// <summary>
+    /// Appends audio to the current block, with the timestamp of its start.
+    /// Note: The dataBuffer should not contain any audio header.
+    /// </summary>
+    /// <param name="dataBuffer">The audio data, copied before the call returns.</param>
+    /// <param name="size">The size of the audio data in bytes.</param>
+    /// <param name="timestamp">The timestamp, set as DataBuffer_TimeStamp if the audio starts a block.</param>
+    void Write(const uint8_t* dataBuffer, uint32_t size, uint64_t timestamp)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_buffered == 0 && size > 0)
+        {
+            m_timestamp = timestamp;
+            m_hasTimestamp = true;
+        }
+        Append(dataBuffer, size);
+    }
+
+    /// <summary>
+    /// Passes the buffered audio on to the native stream.
+    /// </summary>
+    void Flush()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        FlushBlock();
+    }
+
+    /// <summary>
+    /// Passes the buffered audio on and closes the stream.
+    /// </summary>
+    void Close()
+    {
+        Flush();
+        PushAudioInputStream::Close();
+    }
+
+    /// <summary>
+    /// Gets the counters of the stream.
+    /// </summary>
+    /// <returns>A copy of the counters.</returns>
+    BufferedPushAudioInputStreamMetrics GetMetrics() const
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_metrics;
+    }
+
+protected:
+
+    /*! \cond PROTECTED */
+
+    /// <summary>
+    /// Internal constructor. Creates a new instance using the provided handle.
+    /// </summary>
+    BufferedPushAudioInputStream(SPXAUDIOSTREAMHANDLE haudioStream, const BufferedPushAudioInputStreamOptions& options) :
+        PushAudioInputStream(haudioStream),
+        m_blockSize(options.BlockSize - options.BlockSize % options.BlockAlign),
+        m_maxDelay(options.MaxDelay),
+        m_block(new uint8_t[m_blockSize])
+    {
+    }
+
+    /*! \endcond */
+
+private:
+
+    DISABLE_COPY_AND_MOVE(BufferedPushAudioInputStream);
+
+    void Append(const uint8_t* dataBuffer, uint32_t size)
+    {
+        m_metrics.Frames++;
+        if (size == 0)
+        {
+            return;
+        }
+        if (m_buffered == 0 && size >= m_blockSize)
+        {
+            WriteBlock(dataBuffer, size);
+            return;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (m_buffered == 0)
+        {
+            m_blockStarted = now;
+        }
+        while (size > 0)
+        {
+            auto count = std::min(size, m_blockSize - m_buffered);
+            std::memcpy(m_block.get() + m_buffered, dataBuffer, count);
+            m_buffered += count;
+            dataBuffer += count;
+            size -= count;
+            if (m_buffered == m_blockSize)
+            {
+                FlushBlock();
+                m_blockStarted = now;
+            }
+        }
+        if (m_buffered > 0 && now - m_blockStarted >= m_maxDelay)
+        {
+            FlushBlock();
+        }
+    }
+
+    void FlushBlock()
+    {
+        if (m_buffered > 0)
+        {
+            WriteBlock(m_block.get(), m_buffered);
+            m_buffered = 0;
+        }
+    }
+
+    void WriteBlock(const uint8_t* data, uint32_t size)
+    {
+        if (m_hasTimestamp)
+        {
+            char text[24];
+            Utils::FormatDecimal(m_timestamp, text, sizeof(text));
+            m_hasTimestamp = false;
+            SPX_THROW_ON_FAIL(push_audio_input_stream_set_property_by_id(m_haudioStream, static_cast<int>(PropertyId::DataBuffer_TimeStamp), text));
+        }
+        // The native stream copies the data before returning.
+        SPX_THROW_ON_FAIL(push_audio_input_stream_write(m_haudioStream, const_cast<uint8_t*>(data), size));
+        m_metrics.Blocks++;
+        m_metrics.Bytes += size;
+    }
+
+    const uint32_t m_blockSize;
+    const std::chrono::milliseconds m_maxDelay;
+    const std::unique_ptr<uint8_t[]> m_block;
+    mutable std::mutex m_mutex;
+    uint32_t m_buffered = 0;
+    std::chrono::steady_clock::time_point m_blockStarted;
+    uint64_t m_timestamp = 0;
+    bool m_hasTimestamp = false;
+    BufferedPushAudioInputStreamMetrics m_metrics;
+};
+
+} } } } // Microsoft::CognitiveServices::Speech::Audio
@@ -0,0 +1,246 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_cancellation_token.h: Public API declarations for CancellationToken and CancellationTokenSource C++ classes
+//
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "speechapi_cxx_common.h"
+#include "speechapi_cxx_async_executor.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+
+/// <summary>
+/// Bounds how long an asynchronous operation is waited for. A token expires when its deadline passes, or when the
+/// <see cref="CancellationTokenSource"/> it was obtained from is canceled. A default constructed token never expires.
+/// </summary>
+/// <remarks>
+/// When the token of an operation expires, the operation is stopped, e.g. with <see cref="SpeechSynthesizer::StopSpeakingAsync"/>.
+/// A single-shot recognition cannot be stopped, and is only given time to end on its own.
+/// A result that is still delivered then has the reason <see cref="ResultReason::TimedOut"/> if the deadline passed,
+/// or <see cref="ResultReason::Canceled"/> if the source was canceled. If the operation does not end within
+/// <see cref="GetStopTimeout"/>, an exception with SPXERR_TIMEOUT is thrown; the operation is then left to end in the
+/// background, and its native handles are released when it does.
+/// </remarks>
+class CancellationToken
+{
+public:
+
+    /// <summary>
+    /// Type of the deadline clock.
+    /// </summary>
+    using Clock_Type = std::chrono::steady_clock;
+
+    /// <summary>
+    /// Constructs a token that never expires.
+    /// </summary>
+    CancellationToken() = default;
+
+    /// <summary>
+    /// Creates a token that expires at the given time.
+    /// </summary>
+    /// <param name="deadline">The deadline.</param>
+    /// <returns>The token.</returns>
+    static CancellationToken FromDeadline(Clock_Type::time_point deadline)
+    {
+        return CancellationToken().WithDeadline(deadline);
+    }
+
+    /// <summary>
+    /// Creates a token that expires after the given time from now.
+    /// </summary>
+    /// <param name="timeout">The time until the deadline.</param>
+    /// <returns>The token.</returns>
+    static CancellationToken FromTimeout(std::chrono::milliseconds timeout)
+    {
+        return FromDeadline(Clock_Type::now() + timeout);
+    }
+
+    /// <summary>
+    /// Gets a copy of this token that also expires at the given time, if that is earlier than its current deadline.
+    /// </summary>
+    /// <param name="deadline">The deadline.</param>
+    /// <returns>The token.</returns>
+    CancellationToken WithDeadline(Clock_Type::time_point deadline) const
+    {
+        auto token = *this;
+        token.m_deadline = std::min(m_deadline, deadline);
+        return token;
+    }
+
+    /// <summary>
+    /// Gets a copy of this token with the time an expired operation is given to end after being stopped.
+    /// </summary>
+    /// <param name="timeout">The time to wait after stopping. The default is 5 seconds.</param>
+    /// <returns>The token.</returns>
+    CancellationToken WithStopTimeout(std::chrono::milliseconds timeout) const
+    {
+        auto token = *this;
+        token.m_stopTimeout = timeout;
+        return token;
+    }
+
+    /// <summary>
+    /// Gets the deadline, or Clock_Type::time_point::max() if there is none.
+    /// </summary>
+    /// <returns>The deadline.</returns>
+    Clock_Type::time_point GetDeadline() const { return m_deadline; }
+
+    /// <summary>
+    /// Gets the time an expired operation is given to end after being stopped.
+    /// </summary>
+    /// <returns>The timeout.</returns>
+    std::chrono::milliseconds GetStopTimeout() const { return m_stopTimeout; }
+
+    /// <summary>
+    /// Checks if the source of this token was canceled.
+    /// </summary>
+    /// <returns>true if cancellation was requested.</returns>
+    bool IsCancellationRequested() const
+    {
+        return m_canceled != nullptr && m_canceled->load(std::memory_order_acquire);
+    }
+
+    /// <summary>
+    /// Checks if the deadline passed.
+    /// </summary>
+    /// <returns>true if the deadline passed.</returns>
+    bool IsDeadlineExpired() const
+    {
+        return m_deadline != Clock_Type::time_point::max() && Clock_Type::now() >= m_deadline;
+    }
+
+    /// <summary>
+    /// Checks if the token expired, because its deadline passed or its source was canceled.
+    /// </summary>
+    /// <returns>true if the token expired.</returns>
+    bool IsExpired() const
+    {
+        return IsCancellationRequested() || IsDeadlineExpired();
+    }
+
+private:
+
+    friend class CancellationTokenSource;
+
+    std::shared_ptr<std::atomic<bool>> m_canceled;
+    Clock_Type::time_point m_deadline = Clock_Type::time_point::max();
+    std::chrono::milliseconds m_stopTimeout{ 5000 };
+};
+
+/// <summary>
+/// Issues <see cref="CancellationToken"/>s that expire when <see cref="Cancel"/> is called.
+/// </summary>
+class CancellationTokenSource
+{
+public:
+
+    /// <summary>
+    /// Constructor.
+    /// </summary>
+    CancellationTokenSource() :
+        m_canceled(std::make_shared<std::atomic<bool>>(false))
+    {
+    }
+
+    /// <summary>
+    /// Gets a token bound to this source.
+    /// </summary>
+    /// <returns>The token.</returns>
+    CancellationToken GetToken() const
+    {
+        CancellationToken token;
+        token.m_canceled = m_canceled;
+        return token;
+    }
+
+    /// <summary>
+    /// Requests cancellation of the operations waiting with a token of this source.
+    /// </summary>
+    void Cancel()
+    {
+        m_canceled->store(true, std::memory_order_release);
+    }
+
+    /// <summary>
+    /// Checks if <see cref="Cancel"/> was called.
+    /// </summary>
+    /// <returns>true if cancellation was requested.</returns>
+    bool IsCancellationRequested() const
+    {
+        return m_canceled->load(std::memory_order_acquire);
+    }
+
+private:
+
+    DISABLE_COPY_AND_MOVE(CancellationTokenSource);
+
+    std::shared_ptr<std::atomic<bool>> m_canceled;
+};
+
+/*! \cond PRIVATE */
+
+namespace Details {
+
+    /// <summary>
+    /// Waits for a native asynchronous operation in bounded slices, so cancellation is noticed while waiting.
+    /// wait(milliseconds) must return SPXERR_TIMEOUT while the operation is pending.
+    /// Returns SPXERR_TIMEOUT once the token expired, otherwise the result of wait.
+    /// </summary>
+    template <class TWait>
+    SPXHR WaitForAsync(TWait wait, const CancellationToken& token)
+    {
+        const auto maxSlice = std::chrono::milliseconds(100);
+        for (;;)
+        {
+            auto slice = maxSlice;
+            if (token.GetDeadline() != CancellationToken::Clock_Type::time_point::max())
+            {
+                auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(token.GetDeadline() - CancellationToken::Clock_Type::now());
+                slice = std::max(std::chrono::milliseconds(0), std::min(slice, remaining));
+            }
+
+            auto hr = wait(static_cast<uint32_t>(slice.count()));
+            if (hr != SPXERR_TIMEOUT)
+            {
+                return hr;
+            }
+            if (token.IsExpired())
+            {
+                return SPXERR_TIMEOUT;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Waits for a native asynchronous operation that outlived its token, and releases its handles, on the blocking
+    /// <see cref="AsyncExecutor"/>. Releasing the handle of an operation still running is not supported by the native
+    /// library, so finish() waits without a timeout. If it cannot be posted, it runs on the calling thread.
+    /// </summary>
+    template <class TFinish>
+    void FinishInBackground(TFinish finish)
+    {
+        try
+        {
+            AsyncExecutor::GetBlocking()->Post(finish);
+        }
+        catch (...)
+        {
+            finish();
+        }
+    }
+
+}
+
+/*! \endcond */
+
+} } } // Microsoft::CognitiveServices::Speech
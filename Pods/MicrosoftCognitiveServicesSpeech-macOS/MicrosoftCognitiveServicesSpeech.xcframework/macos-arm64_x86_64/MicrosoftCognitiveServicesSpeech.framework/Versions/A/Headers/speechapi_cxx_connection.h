@@ -5,6 +5,7 @@
 
 #pragma once
 #include "speechapi_cxx_common.h"
+#include "speechapi_cxx_async_executor.h"
 #include "speechapi_cxx_recognizer.h"
 #include "speechapi_cxx_eventsignal.h"
 #include "speechapi_cxx_connection_eventargs.h"
@@ -150,7 +151,7 @@ public:
     std::future<void> SendMessageAsync(const SPXSTRING& path, const SPXSTRING& payload)
     {
         auto keep_alive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [keep_alive, this, path, payload]() -> void {
+        auto future = Details::RunAsync([keep_alive, this, path, payload]() -> void {
             SPX_THROW_HR_IF(SPXERR_INVALID_HANDLE, m_connectionHandle == SPXHANDLE_INVALID);
             SPX_THROW_ON_FAIL(::connection_send_message(m_connectionHandle, Utils::ToUTF8(path.c_str()), Utils::ToUTF8(payload.c_str())));
         });
@@ -169,7 +170,7 @@ public:
     std::future<void> SendMessageAsync(const SPXSTRING& path, uint8_t* payload, uint32_t size)
     {
         auto keep_alive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [keep_alive, this, path, payload, size]() -> void {
+        auto future = Details::RunAsync([keep_alive, this, path, payload, size]() -> void {
             SPX_THROW_HR_IF(SPXERR_INVALID_HANDLE, m_connectionHandle == SPXHANDLE_INVALID);
             SPX_THROW_ON_FAIL(::connection_send_message_data(m_connectionHandle, Utils::ToUTF8(path.c_str()), payload, size));
         });
@@ -15,6 +15,7 @@
 
 #include "speechapi_c_conversation_translator.h"
 #include "speechapi_cxx_eventsignal.h"
+#include "speechapi_cxx_async_executor.h"
 #include "speechapi_cxx_audio_config.h"
 #include "speechapi_cxx_conversation.h"
 #include "speechapi_cxx_conversation_translator_events.h"
@@ -391,7 +392,7 @@ namespace Transcription {
         inline std::future<void> RunAsync(std::function<SPXHR(SPXCONVERSATIONHANDLE)> func)
         {
             auto keepalive = this->shared_from_this();
-            return std::async(std::launch::async, [keepalive, this, func]()
+            return Details::RunAsync([keepalive, this, func]()
             {
                 SPX_THROW_ON_FAIL(func(m_handle));
             });
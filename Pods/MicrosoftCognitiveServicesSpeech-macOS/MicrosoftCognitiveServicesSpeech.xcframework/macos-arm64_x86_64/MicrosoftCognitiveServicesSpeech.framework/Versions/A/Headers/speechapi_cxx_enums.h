@@ -996,7 +996,13 @@ enum class ResultReason
     /// Indicates the voices list has been retrieved successfully.
     /// Added in version 1.16.0
     /// </summary>
-    VoicesListRetrieved = 23
+    VoicesListRetrieved = 23,
+
+    /// <summary>
+    /// Indicates the operation was stopped because the deadline of its <see cref="CancellationToken"/> passed.
+    /// Set by the C++ API, never reported by the service.
+    /// </summary>
+    TimedOut = 1000
 };
 
 /// <summary>
@@ -1682,4 +1688,22 @@ enum class SegmentationStrategy
     Semantic = 2
 };
 
+/// <summary>
+/// Defines where <see cref="SsmlSegmenter"/> ends segments.
+/// </summary>
+enum class SsmlSegmentationMode
+{
+    /// <summary>
+    /// Segments are filled up to the maximum size, ending at the best place that fits.
+    /// </summary>
+    Packed = 0,
+
+    /// <summary>
+    /// Segments end after every child of &lt;speak&gt; and every &lt;p&gt;, &lt;mstts:express-as&gt; or &lt;prosody&gt;
+    /// element, and are split further only where they exceed the maximum size. Editing an element then changes only the
+    /// segments of that element, which lets a render reuse the audio of the others.
+    /// </summary>
+    PerElement = 1
+};
+
 } } } // Microsoft::CognitiveServices::Speech
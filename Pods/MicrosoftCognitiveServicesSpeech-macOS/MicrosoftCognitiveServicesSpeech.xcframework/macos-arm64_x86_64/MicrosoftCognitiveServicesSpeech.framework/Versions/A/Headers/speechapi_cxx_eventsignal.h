@@ -10,10 +10,13 @@
 #pragma once
 #include <algorithm>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <type_traits>
 
 #include "speechapi_cxx_eventsignalbase.h"
+#include "speechapi_cxx_eventsignal_dispatcher.h"
 
 namespace Microsoft {
 namespace CognitiveServices {
@@ -25,6 +28,7 @@ namespace Speech {
 /// <remarks>
 /// At construction time, connect and disconnect callbacks can be provided that are called when
 /// the number of connected clients changes from zero to one or one to zero, respectively.
+/// Events raised through <see cref="SignalOwned"/> can be delivered asynchronously on a dispatcher, see <see cref="EnableAsyncDispatch"/>.
 /// </remarks>
 // <typeparam name="T">
 template <class T>
@@ -47,6 +51,11 @@ public:
     /// </summary>
     using NotifyCallback_Type = std::function<void(EventSignal<T>&)>;
 
+    /// <summary>
+    /// Type of the event payload owned by the dispatch queue while an event waits for asynchronous delivery.
+    /// </summary>
+    using Payload_Type = typename std::remove_cv<typename std::remove_reference<T>::type>::type;
+
     /// <summary>
     /// Constructs an event signal with empty register and disconnect callbacks.
     /// <summary>
@@ -75,6 +84,14 @@ public:
     {
     }
 
+    /// <summary>
+    /// Destructor. Stops asynchronous dispatch, if enabled.
+    /// </summary>
+    ~EventSignal()
+    {
+        DisableAsyncDispatch();
+    }
+
     /// <summary>
     /// Addition assignment operator overload.
     /// Connects the provided callback <paramref name="callback"/> to the event signal, see also <see cref="Connect"/>.
@@ -107,12 +124,23 @@ public:
     /// </remarks>
     /// <param name="callback">Callback to connect.</param>
     void Connect(CallbackFunction callback)
+    {
+        (void)ConnectWithToken(std::move(callback));
+    }
+
+    /// <summary>
+    /// Connects given callback function to the event signal like <see cref="Connect"/>, and returns a token that
+    /// disconnects exactly this callback, see <see cref="DisconnectToken"/>.
+    /// </summary>
+    /// <param name="callback">Callback to connect.</param>
+    /// <returns>The token of the connection.</returns>
+    CallbackToken ConnectWithToken(CallbackFunction callback)
     {
         std::unique_lock<std::recursive_mutex> lock(m_mutex);
 
         auto shouldFireFirstConnected = m_callbacks.empty() && m_firstConnectedCallback != nullptr;
 
-        (void)EventSignalBase<T>::RegisterCallback(callback);
+        auto token = EventSignalBase<T>::RegisterCallback(std::move(callback));
 
         lock.unlock();
 
@@ -120,6 +148,26 @@ public:
         {
             m_firstConnectedCallback(*this);
         }
+        return token;
+    }
+
+    /// <summary>
+    /// Disconnects the callback connected with the given token. Unlike <see cref="Disconnect"/>, this does not
+    /// depend on the type of the callback, and does not require runtime type information.
+    /// </summary>
+    /// <remarks>
+    /// When the number of connected clients changes from one to zero, the disconnect callback will be called, if provided.
+    /// </remarks>
+    /// <param name="token">Token returned by <see cref="ConnectWithToken"/>.</param>
+    void DisconnectToken(CallbackToken token)
+    {
+        std::unique_lock<std::recursive_mutex> lock(m_mutex);
+        auto removeHappened = EventSignal<T>::UnregisterCallback(token);
+        lock.unlock();
+        if (removeHappened && m_callbacks.empty() && m_lastDisconnectedCallback != nullptr)
+        {
+            m_lastDisconnectedCallback(*this);
+        }
     }
 
 #ifndef AZAC_CONFIG_CXX_NO_RTTI
@@ -137,12 +185,13 @@ public:
         auto itMatchingCallback = std::find_if(
             m_callbacks.begin(),
             m_callbacks.end(),
-            [&](const std::pair<CallbackToken, CallbackFunction>& item)
+            [&](const typename decltype(m_callbacks)::value_type& item)
             {
-                return callback.target_type() == item.second.target_type();
+                return callback.target_type() == item.second->Callback.target_type();
             });
 
-        auto removeHappened = EventSignal<T>::UnregisterCallback(itMatchingCallback->first);
+        auto removeHappened = itMatchingCallback != m_callbacks.end() &&
+            EventSignal<T>::UnregisterCallback(itMatchingCallback->first);
         lock.unlock();
         if (removeHappened && m_callbacks.empty() && m_lastDisconnectedCallback != nullptr)
         {
@@ -185,6 +234,85 @@ public:
         EventSignalBase<T>::Signal(t);
     }
 
+    /// <summary>
+    /// Signals the event with the given owned arguments <paramref name="payload"/> to all connected callbacks.
+    /// If asynchronous dispatch is enabled, the payload is queued and this call returns without running the callbacks;
+    /// otherwise this is equivalent to <see cref="Signal"/>.
+    /// </summary>
+    /// <param name="payload">Event arguments to signal. Kept alive until the callbacks have run.</param>
+    void SignalOwned(const std::shared_ptr<Payload_Type>& payload)
+    {
+        auto queue = std::atomic_load_explicit(&m_dispatchQueue, std::memory_order_acquire);
+        if (queue == nullptr || !queue->Enqueue(payload))
+        {
+            EventSignalBase<T>::Signal(*payload);
+        }
+    }
+
+    /// <summary>
+    /// Enables asynchronous delivery of events raised through <see cref="SignalOwned"/>. Events are held in a bounded queue
+    /// and drained, in order, by a dedicated dispatcher thread or by the executor given in <paramref name="options"/>.
+    /// Calling this again replaces the current dispatcher after delivering the events it still holds.
+    /// </summary>
+    /// <param name="options">Queue capacity, overflow policy and optional executor.</param>
+    void EnableAsyncDispatch(const EventDispatchOptions& options = EventDispatchOptions())
+    {
+        auto queue = EventDispatchQueue<Payload_Type>::Create(options, [this](const Payload_Type& payload) {
+            EventSignalBase<T>::Signal(payload);
+        });
+
+        auto previous = std::atomic_exchange(&m_dispatchQueue, queue);
+        if (previous != nullptr)
+        {
+            previous->Stop();
+        }
+    }
+
+    /// <summary>
+    /// Disables asynchronous delivery. Events still queued are delivered before this call returns,
+    /// unless it is called from a callback running on the dispatcher.
+    /// </summary>
+    void DisableAsyncDispatch()
+    {
+        auto previous = std::atomic_exchange(&m_dispatchQueue, std::shared_ptr<EventDispatchQueue<Payload_Type>>());
+        if (previous != nullptr)
+        {
+            previous->Stop();
+        }
+    }
+
+    /// <summary>
+    /// Checks if asynchronous delivery is enabled.
+    /// </summary>
+    /// <returns>true if events raised through <see cref="SignalOwned"/> are queued.</returns>
+    bool IsAsyncDispatchEnabled() const
+    {
+        return std::atomic_load(&m_dispatchQueue) != nullptr;
+    }
+
+    /// <summary>
+    /// Waits until the events queued for asynchronous delivery before this call have been delivered or dropped.
+    /// Returns immediately if asynchronous delivery is disabled, or when called from a callback run by the dispatcher.
+    /// </summary>
+    void FlushAsyncDispatch()
+    {
+        auto queue = std::atomic_load(&m_dispatchQueue);
+        if (queue != nullptr)
+        {
+            queue->Flush();
+        }
+    }
+
+    /// <summary>
+    /// Gets queue depth, drop and coalesce counters of the current dispatcher.
+    /// </summary>
+    /// <returns>The counters, or all zeros if asynchronous delivery is disabled.</returns>
+    EventDispatchStatistics GetDispatchStatistics() const
+    {
+        auto queue = std::atomic_load(&m_dispatchQueue);
+        return queue != nullptr ? queue->GetStatistics() : EventDispatchStatistics();
+    }
+
 private:
     using EventSignalBase<T>::m_mutex;
     using EventSignalBase<T>::m_callbacks;
@@ -192,6 +320,8 @@ private:
     NotifyCallback_Type m_firstConnectedCallback;
     NotifyCallback_Type m_lastDisconnectedCallback;
 
+    std::shared_ptr<EventDispatchQueue<Payload_Type>> m_dispatchQueue;
+
     EventSignal(const EventSignal&) = delete;
     EventSignal(const EventSignal&&) = delete;
     EventSignal& operator=(const EventSignal&) = delete;
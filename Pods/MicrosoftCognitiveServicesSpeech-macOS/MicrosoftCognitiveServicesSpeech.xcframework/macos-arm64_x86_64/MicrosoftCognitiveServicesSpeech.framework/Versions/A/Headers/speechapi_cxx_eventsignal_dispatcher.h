@@ -0,0 +1,446 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_eventsignal_dispatcher.h: Public API declarations for the bounded event dispatch queue used by
+// EventSignal<T> to deliver events asynchronously, off the thread that raised them.
+//
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "speechapi_cxx_common.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+
+/// <summary>
+/// Defines what happens when an event is raised while the dispatch queue is full.
+/// </summary>
+enum class EventDispatchOverflowPolicy
+{
+    /// <summary>
+    /// The thread raising the event waits until the dispatcher frees a slot.
+    /// </summary>
+    Block = 0,
+
+    /// <summary>
+    /// The oldest queued event is discarded to make room for the new one.
+    /// </summary>
+    DropOldest = 1,
+
+    /// <summary>
+    /// The most recently queued event is replaced by the new one, so only the latest state is delivered.
+    /// </summary>
+    Coalesce = 2
+};
+
+/// <summary>
+/// Options for asynchronous event dispatch, see <see cref="EventSignal::EnableAsyncDispatch"/>.
+/// </summary>
+struct EventDispatchOptions
+{
+    /// <summary>
+    /// Type of a user-supplied executor. It must run the given work item exactly once, on any thread.
+    /// </summary>
+    using Executor_Type = std::function<void(std::function<void()>)>;
+
+    /// <summary>
+    /// Maximum number of events held in the queue.
+    /// </summary>
+    size_t Capacity = 256;
+
+    /// <summary>
+    /// Policy applied when an event is raised and the queue holds <see cref="Capacity"/> events.
+    /// </summary>
+    EventDispatchOverflowPolicy OverflowPolicy = EventDispatchOverflowPolicy::Block;
+
+    /// <summary>
+    /// Executor that drains the queue. If empty, a dedicated dispatcher thread is started.
+    /// </summary>
+    Executor_Type Executor;
+};
+
+/// <summary>
+/// Point-in-time counters of an event dispatch queue.
+/// </summary>
+struct EventDispatchStatistics
+{
+    /// <summary>
+    /// Number of events currently waiting to be delivered.
+    /// </summary>
+    uint64_t QueueDepth = 0;
+
+    /// <summary>
+    /// Highest queue depth observed.
+    /// </summary>
+    uint64_t MaxQueueDepth = 0;
+
+    /// <summary>
+    /// Number of events accepted into the queue.
+    /// </summary>
+    uint64_t Enqueued = 0;
+
+    /// <summary>
+    /// Number of events delivered to the connected callbacks.
+    /// </summary>
+    uint64_t Delivered = 0;
+
+    /// <summary>
+    /// Number of events discarded by <see cref="EventDispatchOverflowPolicy::DropOldest"/>.
+    /// </summary>
+    uint64_t Dropped = 0;
+
+    /// <summary>
+    /// Number of events replaced by <see cref="EventDispatchOverflowPolicy::Coalesce"/>.
+    /// </summary>
+    uint64_t Coalesced = 0;
+};
+
+/*! \cond PRIVATE */
+
+/// <summary>
+/// Bounded multi-producer, single-consumer ring of event payloads. Producers are the threads raising events;
+/// the consumer is either a dedicated dispatcher thread or work items posted to a user-supplied executor.
+/// At most one consumer runs at a time, so events are delivered in the order they were accepted.
+/// </summary>
+template <class Payload>
+class EventDispatchQueue : public std::enable_shared_from_this<EventDispatchQueue<Payload>>
+{
+public:
+
+    using Item = std::shared_ptr<Payload>;
+    using DeliverFunction = std::function<void(const Payload&)>;
+
+    /// <summary>
+    /// Creates a queue and starts its dispatcher thread when no executor is supplied.
+    /// </summary>
+    /// <param name="options">Dispatch options.</param>
+    /// <param name="deliver">Function invoked on the consumer side for each event.</param>
+    /// <returns>A shared pointer to the queue.</returns>
+    static std::shared_ptr<EventDispatchQueue> Create(const EventDispatchOptions& options, DeliverFunction deliver)
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, options.Capacity == 0);
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, deliver == nullptr);
+
+        auto queue = std::shared_ptr<EventDispatchQueue>(new EventDispatchQueue(options, std::move(deliver)));
+        if (queue->m_executor == nullptr)
+        {
+            auto self = queue;
+            queue->m_thread = std::thread([self]() { self->RunDispatcherThread(); });
+        }
+
+        return queue;
+    }
+
+    ~EventDispatchQueue()
+    {
+        if (m_thread.joinable())
+        {
+            m_thread.detach();
+        }
+    }
+
+    /// <summary>
+    /// Queues an event, applying the overflow policy if the queue is full.
+    /// </summary>
+    /// <param name="item">Event payload.</param>
+    /// <returns>false if the queue is stopped, or if the event is raised from the consumer itself while the queue
+    /// is full under the blocking policy; the caller then delivers the event synchronously.</returns>
+    bool Enqueue(const Item& item)
+    {
+        Item discarded;
+        bool scheduleDrain = false;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_stopped)
+            {
+                return false;
+            }
+
+            if (m_count == m_slots.size())
+            {
+                switch (m_policy)
+                {
+                case EventDispatchOverflowPolicy::Block:
+                    if (IsConsumerThread())
+                    {
+                        // Waiting here would wait on ourselves.
+                        return false;
+                    }
+                    m_notFull.wait(lock, [this] { return m_count < m_slots.size() || m_stopped; });
+                    if (m_stopped)
+                    {
+                        return false;
+                    }
+                    break;
+
+                case EventDispatchOverflowPolicy::DropOldest:
+                    discarded = std::move(m_slots[m_head]);
+                    m_head = (m_head + 1) % m_slots.size();
+                    m_count--;
+                    m_dropped.fetch_add(1, std::memory_order_relaxed);
+                    break;
+
+                case EventDispatchOverflowPolicy::Coalesce:
+                    discarded = std::move(m_slots[(m_head + m_count - 1) % m_slots.size()]);
+                    m_slots[(m_head + m_count - 1) % m_slots.size()] = item;
+                    m_coalesced.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+
+            m_slots[(m_head + m_count) % m_slots.size()] = item;
+            m_count++;
+            m_depth.store(m_count, std::memory_order_relaxed);
+            if (m_count > m_maxDepth.load(std::memory_order_relaxed))
+            {
+                m_maxDepth.store(m_count, std::memory_order_relaxed);
+            }
+            m_enqueued.fetch_add(1, std::memory_order_relaxed);
+
+            if (m_executor != nullptr && !m_drainScheduled)
+            {
+                m_drainScheduled = true;
+                scheduleDrain = true;
+            }
+        }
+
+        if (scheduleDrain)
+        {
+            auto self = this->shared_from_this();
+            m_executor([self]() { self->Drain(); });
+        }
+        else if (m_executor == nullptr)
+        {
+            m_notEmpty.notify_one();
+        }
+
+        return true;
+    }
+
+    /// <summary>
+    /// Stops accepting events, delivers the events still queued and waits for the consumer to finish.
+    /// When called from the consumer itself (e.g. a callback releasing the object that owns the signal),
+    /// queued events are discarded and the consumer exits after the current delivery returns.
+    /// </summary>
+    void Stop()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stopped = true;
+        m_notFull.notify_all();
+        m_notEmpty.notify_all();
+
+        if (IsConsumerThread())
+        {
+            m_abandoned = true;
+            m_flushed.notify_all();
+            lock.unlock();
+            if (m_thread.joinable())
+            {
+                m_thread.detach();
+            }
+            return;
+        }
+
+        if (m_executor != nullptr)
+        {
+            m_idle.wait(lock, [this] { return !m_drainScheduled; });
+            return;
+        }
+
+        lock.unlock();
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+    }
+
+    /// <summary>
+    /// Waits until the events queued before this call have been delivered or dropped. Returns immediately when
+    /// called from the consumer itself, or once the queue was abandoned.
+    /// </summary>
+    void Flush()
+    {
+        if (IsConsumerThread())
+        {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto queued = m_enqueued.load(std::memory_order_relaxed);
+        m_flushed.wait(lock, [this, queued] {
+            return m_abandoned || m_delivered.load(std::memory_order_relaxed) + m_dropped.load(std::memory_order_relaxed) >= queued;
+        });
+    }
+
+    /// <summary>
+    /// Gets the queue counters. Does not block producers or the consumer.
+    /// </summary>
+    /// <returns>The counters.</returns>
+    EventDispatchStatistics GetStatistics() const
+    {
+        EventDispatchStatistics statistics;
+        statistics.QueueDepth = m_depth.load(std::memory_order_relaxed);
+        statistics.MaxQueueDepth = m_maxDepth.load(std::memory_order_relaxed);
+        statistics.Enqueued = m_enqueued.load(std::memory_order_relaxed);
+        statistics.Delivered = m_delivered.load(std::memory_order_relaxed);
+        statistics.Dropped = m_dropped.load(std::memory_order_relaxed);
+        statistics.Coalesced = m_coalesced.load(std::memory_order_relaxed);
+        return statistics;
+    }
+
+private:
+
+    EventDispatchQueue(const EventDispatchOptions& options, DeliverFunction deliver) :
+        m_slots(options.Capacity),
+        m_policy(options.OverflowPolicy),
+        m_executor(options.Executor),
+        m_deliver(std::move(deliver))
+    {
+    }
+
+    static const void*& CurrentConsumer()
+    {
+        static thread_local const void* consumer = nullptr;
+        return consumer;
+    }
+
+    bool IsConsumerThread() const
+    {
+        return CurrentConsumer() == this;
+    }
+
+    // Takes the next event; returns nullptr once the queue is empty or abandoned. Must be called with m_mutex held.
+    Item Pop()
+    {
+        if (m_abandoned || m_count == 0)
+        {
+            return nullptr;
+        }
+
+        auto item = std::move(m_slots[m_head]);
+        m_head = (m_head + 1) % m_slots.size();
+        m_count--;
+        m_depth.store(m_count, std::memory_order_relaxed);
+        return item;
+    }
+
+    // Delivers one event outside the lock; returns false if the queue was abandoned meanwhile.
+    bool Deliver(Item item)
+    {
+        m_notFull.notify_one();
+        try
+        {
+            m_deliver(*item);
+        }
+        catch (const std::exception& ex)
+        {
+            SPX_TRACE_ERROR("Exception caught while dispatching an event: %s", ex.what());
+            (void)ex;
+        }
+        catch (...)
+        {
+            SPX_TRACE_ERROR("Unknown exception caught while dispatching an event.");
+        }
+        m_delivered.fetch_add(1, std::memory_order_relaxed);
+
+        // Releasing the payload may release the owner of this queue, which calls Stop() on this thread.
+        item.reset();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_flushed.notify_all();
+        return !m_abandoned;
+    }
+
+    void RunDispatcherThread()
+    {
+        CurrentConsumer() = this;
+        for (;;)
+        {
+            Item item;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_notEmpty.wait(lock, [this] { return m_count > 0 || m_stopped; });
+                item = Pop();
+            }
+
+            if (item == nullptr || !Deliver(std::move(item)))
+            {
+                break;
+            }
+        }
+        CurrentConsumer() = nullptr;
+    }
+
+    void Drain()
+    {
+        auto previousConsumer = CurrentConsumer();
+        CurrentConsumer() = this;
+        for (;;)
+        {
+            Item item;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                item = Pop();
+                if (item == nullptr)
+                {
+                    m_drainScheduled = false;
+                    m_idle.notify_all();
+                    break;
+                }
+            }
+
+            if (!Deliver(std::move(item)))
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_drainScheduled = false;
+                break;
+            }
+        }
+        CurrentConsumer() = previousConsumer;
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_notEmpty;
+    std::condition_variable m_notFull;
+    std::condition_variable m_idle;
+    std::condition_variable m_flushed;
+
+    std::vector<Item> m_slots;
+    size_t m_head = 0;
+    size_t m_count = 0;
+
+    const EventDispatchOverflowPolicy m_policy;
+    const EventDispatchOptions::Executor_Type m_executor;
+    const DeliverFunction m_deliver;
+
+    bool m_stopped = false;
+    bool m_abandoned = false;
+    bool m_drainScheduled = false;
+    std::thread m_thread;
+
+    std::atomic<uint64_t> m_depth{ 0 };
+    std::atomic<uint64_t> m_maxDepth{ 0 };
+    std::atomic<uint64_t> m_enqueued{ 0 };
+    std::atomic<uint64_t> m_delivered{ 0 };
+    std::atomic<uint64_t> m_dropped{ 0 };
+    std::atomic<uint64_t> m_coalesced{ 0 };
+
+    DISABLE_COPY_AND_MOVE(EventDispatchQueue);
+};
+
+/*! \endcond */
+
+} } } // Microsoft::CognitiveServices::Speech
@@ -7,10 +7,13 @@
 
 #pragma once
 #include <algorithm>
+#include <atomic>
 #include <functional>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "speechapi_cxx_common.h"
 
@@ -24,6 +27,9 @@ namespace Speech {
 /// <remarks>
 /// At construction time, connect and disconnect callbacks can be provided that are called when
 /// the number of connected clients changes from zero to one or one to zero, respectively.
+/// Registration and unregistration publish an immutable snapshot of the connected callbacks; signalling
+/// reads the current snapshot without taking a lock or copying the callbacks. A callback that is unregistered
+/// while a signal is in progress is not invoked by that signal if it has not been reached yet.
 /// </remarks>
 // <typeparam name="T">
 template <class T>
@@ -61,6 +67,28 @@ public:
     /// </summary>
     using CallbackToken = uint32_t;
 
+    /// <summary>
+    /// A registered callback, shared between the registration map and the published snapshots.
+    /// </summary>
+    struct CallbackEntry
+    {
+        CallbackEntry(CallbackToken token, CallbackFunction callback) :
+            Token(token),
+            Callback(std::move(callback)),
+            Connected(true)
+        {
+        }
+
+        const CallbackToken Token;
+        const CallbackFunction Callback;
+        std::atomic<bool> Connected;
+    };
+
+    /// <summary>
+    /// Immutable list of callbacks that is iterated when the event is signalled.
+    /// </summary>
+    using CallbackSnapshot = std::vector<std::shared_ptr<CallbackEntry>>;
+
     /// <summary>
     /// Registers a callback to this EventSignalBase and assigns it a unique token.
     /// </summary>
@@ -75,7 +103,8 @@ public:
         auto token = m_nextCallbackToken;
         m_nextCallbackToken++;
 
-        m_callbacks.emplace(token, callback);
+        m_callbacks.emplace(token, std::make_shared<CallbackEntry>(token, std::move(callback)));
+        PublishSnapshot();
 
         return token;
     }
@@ -92,7 +121,18 @@ public:
     bool UnregisterCallback(CallbackToken token)
     {
         std::unique_lock<std::recursive_mutex> lock(m_mutex);
-        return (bool)m_callbacks.erase(token);
+
+        auto it = m_callbacks.find(token);
+        if (it == m_callbacks.end())
+        {
+            return false;
+        }
+
+        it->second->Connected.store(false, std::memory_order_release);
+        m_callbacks.erase(it);
+        PublishSnapshot();
+
+        return true;
     }
 
     /// <summary>
@@ -111,7 +151,14 @@ public:
     void UnregisterAllCallbacks()
     {
         std::unique_lock<std::recursive_mutex> lock(m_mutex);
+
+        for (auto& item : m_callbacks)
+        {
+            item.second->Connected.store(false, std::memory_order_release);
+        }
+
         m_callbacks.clear();
+        PublishSnapshot();
     }
 
     /// <summary>
@@ -120,21 +167,19 @@ public:
     /// <param name="t">Event arguments to signal.</param>
     void Signal(T t)
     {
-        std::unique_lock<std::recursive_mutex> lock(m_mutex);
+        auto snapshot = std::atomic_load_explicit(&m_snapshot, std::memory_order_acquire);
+        if (snapshot == nullptr)
+        {
+            return;
+        }
 
-        auto callbacksSnapshot = m_callbacks;
-        for (auto callbackCopyPair : callbacksSnapshot)
+        for (const auto& entry : *snapshot)
         {
             // now, while a callback is in progress, it can disconnect itself and any other connected
-            // callback. Check to see if the next one stored in the copy container is still connected.
-            bool stillConnected = (std::find_if(m_callbacks.begin(), m_callbacks.end(),
-                [&](const std::pair<CallbackToken, CallbackFunction> item) {
-                return callbackCopyPair.first == item.first;
-            }) != m_callbacks.end());
-
-            if (stillConnected)
+            // callback. Disconnected entries stay in this snapshot but are flagged, so skip them.
+            if (entry->Connected.load(std::memory_order_acquire))
             {
-                callbackCopyPair.second(t);
+                entry->Callback(t);
             }
         }
     }
@@ -150,10 +195,31 @@ public:
     }
 
 protected:
-    std::map<CallbackToken, CallbackFunction> m_callbacks;
+    std::map<CallbackToken, std::shared_ptr<CallbackEntry>> m_callbacks;
+    std::shared_ptr<const CallbackSnapshot> m_snapshot;
     CallbackToken m_nextCallbackToken;
     mutable std::recursive_mutex m_mutex;
 
+    /// <summary>
+    /// Rebuilds the snapshot from the registration map and swaps it in. Must be called with m_mutex held.
+    /// </summary>
+    void PublishSnapshot()
+    {
+        std::shared_ptr<const CallbackSnapshot> snapshot;
+        if (!m_callbacks.empty())
+        {
+            auto callbacks = std::make_shared<CallbackSnapshot>();
+            callbacks->reserve(m_callbacks.size());
+            for (const auto& item : m_callbacks)
+            {
+                callbacks->push_back(item.second);
+            }
+            snapshot = std::move(callbacks);
+        }
+
+        std::atomic_store_explicit(&m_snapshot, snapshot, std::memory_order_release);
+    }
+
 private:
     EventSignalBase(const EventSignalBase&) = delete;
     EventSignalBase(const EventSignalBase&&) = delete;
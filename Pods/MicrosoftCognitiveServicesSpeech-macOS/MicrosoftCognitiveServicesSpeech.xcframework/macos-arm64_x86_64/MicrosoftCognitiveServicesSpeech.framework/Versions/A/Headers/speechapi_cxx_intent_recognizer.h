@@ -7,6 +7,7 @@
 
 #pragma once
 #include "speechapi_cxx_common.h"
+#include "speechapi_cxx_async_executor.h"
 #include "speechapi_cxx_string_helpers.h"
 #include "speechapi_c.h"
 #include "speechapi_c_json.h"
@@ -120,7 +121,7 @@ namespace Intent {
         std::future<std::shared_ptr<IntentRecognitionResult>> RecognizeOnceAsync(SPXSTRING text)
         {
             auto keepAlive = this->shared_from_this();
-            auto future = std::async(std::launch::async, [keepAlive, this, text]() -> std::shared_ptr<IntentRecognitionResult> {
+            auto future = Details::RunAsync([keepAlive, this, text]() -> std::shared_ptr<IntentRecognitionResult> {
                 SPX_INIT_HR(hr);
 
                 SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
@@ -149,6 +150,38 @@ namespace Intent {
             return BaseType::StopContinuousRecognitionAsyncInternal();
         }
 
+        /// <summary>
+        /// Performs intent recognition on a single utterance, asynchronously, until the given token expires.
+        /// A single-shot recognition cannot be stopped; on expiry it is given the stop timeout to end, see <see cref="CancellationToken"/>.
+        /// </summary>
+        /// <param name="token">The token bounding the wait.</param>
+        /// <returns>Future containing result value of the asynchronous recognition.</returns>
+        std::future<std::shared_ptr<IntentRecognitionResult>> RecognizeOnceAsync(const CancellationToken& token)
+        {
+            return BaseType::RecognizeOnceAsyncInternal(token);
+        }
+
+        /// <summary>
+        /// Asynchronously initiates continuous intent recognition, until the given token expires.
+        /// If the token expires before the recognition started, it is stopped again.
+        /// </summary>
+        /// <param name="token">The token bounding the wait.</param>
+        /// <returns>An empty future. It throws an exception with SPXERR_TIMEOUT if the token expires first.</returns>
+        std::future<void> StartContinuousRecognitionAsync(const CancellationToken& token)
+        {
+            return BaseType::StartContinuousRecognitionAsyncInternal(token);
+        }
+
+        /// <summary>
+        /// Asynchronously terminates ongoing continuous intent recognition, until the given token expires.
+        /// </summary>
+        /// <param name="token">The token bounding the wait.</param>
+        /// <returns>An empty future. It throws an exception with SPXERR_TIMEOUT if the token expires first.</returns>
+        std::future<void> StopContinuousRecognitionAsync(const CancellationToken& token)
+        {
+            return BaseType::StopContinuousRecognitionAsyncInternal(token);
+        }
+
         /// <summary>
         /// Asynchronously initiates keyword recognition operation.
         /// </summary>
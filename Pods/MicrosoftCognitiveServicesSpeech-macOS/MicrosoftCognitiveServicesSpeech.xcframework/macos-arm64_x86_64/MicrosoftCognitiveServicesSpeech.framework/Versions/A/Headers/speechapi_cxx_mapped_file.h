@@ -0,0 +1,88 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_mapped_file.h: Private helper mapping files into memory
+//
+
+#pragma once
+#include <cerrno>
+#include <cstddef>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "speechapi_cxx_common.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+
+/*! \cond PRIVATE */
+
+namespace Details {
+
+    // A read-only mapping of a whole file.
+    class MappedFile
+    {
+    public:
+
+        explicit MappedFile(const std::string& path)
+        {
+            int fd;
+            do
+            {
+                fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            } while (fd < 0 && errno == EINTR);
+            SPX_THROW_HR_IF(SPXERR_FILE_OPEN_FAILED, fd < 0);
+
+            struct stat st;
+            auto statFailed = ::fstat(fd, &st) != 0;
+            m_size = statFailed ? 0 : static_cast<size_t>(st.st_size);
+            void* base = nullptr;
+            if (!statFailed && m_size > 0)
+            {
+                base = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            }
+            ::close(fd);
+            SPX_THROW_HR_IF(SPXERR_RUNTIME_ERROR, statFailed);
+            SPX_THROW_HR_IF(SPXERR_FILE_OPEN_FAILED, base == MAP_FAILED);
+            m_data = static_cast<const char*>(base);
+        }
+
+        ~MappedFile()
+        {
+            if (m_data != nullptr)
+            {
+                ::munmap(const_cast<char*>(m_data), m_size);
+            }
+        }
+
+        const char* GetData() const { return m_data; }
+        size_t GetSize() const { return m_size; }
+
+        // Tells the kernel how the mapping will be accessed, e.g. POSIX_MADV_SEQUENTIAL. Only a hint; errors are ignored.
+        void Advise(int advice) const
+        {
+            if (m_data != nullptr)
+            {
+                ::posix_madvise(const_cast<char*>(m_data), m_size, advice);
+            }
+        }
+
+    private:
+
+        DISABLE_COPY_AND_MOVE(MappedFile);
+
+        const char* m_data = nullptr;
+        size_t m_size = 0;
+    };
+
+}
+
+/*! \endcond */
+
+} } } // Microsoft::CognitiveServices::Speech
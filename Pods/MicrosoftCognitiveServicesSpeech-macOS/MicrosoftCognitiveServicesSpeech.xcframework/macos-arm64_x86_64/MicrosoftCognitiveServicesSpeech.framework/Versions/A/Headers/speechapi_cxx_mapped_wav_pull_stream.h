@@ -0,0 +1,247 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_mapped_wav_pull_stream.h: Public API declarations for MappedWavPullStreamCallback C++ class
+//
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "speechapi_cxx_common.h"
+#include "speechapi_cxx_audio_stream_format.h"
+#include "speechapi_cxx_audio_stream.h"
+#include "speechapi_cxx_mapped_file.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+
+/*! \cond PRIVATE */
+
+namespace Details {
+
+    inline uint64_t GetLittleEndian(const uint8_t* data, size_t size)
+    {
+        uint64_t value = 0;
+        for (size_t i = 0; i < size; i++)
+        {
+            value |= static_cast<uint64_t>(data[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    // Format and location of the audio in a RIFF or RF64 WAVE file.
+    struct WavInfo
+    {
+        uint16_t FormatTag = 0;
+        uint16_t Channels = 0;
+        uint32_t SamplesPerSecond = 0;
+        uint16_t BlockAlign = 0;
+        uint16_t BitsPerSample = 0;
+        size_t DataOffset = 0;
+        size_t DataSize = 0;
+    };
+
+    // Walks the chunks up to the data chunk. For WAVE_FORMAT_EXTENSIBLE the format tag is taken from the sub-format
+    // GUID. A data size that is unknown or larger than the file, as left by an interrupted writer, means the rest of
+    // the file; the size is cut to whole blocks.
+    inline WavInfo ParseWav(const uint8_t* data, size_t size)
+    {
+        const uint16_t WaveFormatExtensible = 0xfffe;
+
+        SPX_THROW_HR_IF(SPXERR_INVALID_HEADER, size < 12 || std::memcmp(data + 8, "WAVE", 4) != 0);
+        auto rf64 = std::memcmp(data, "RF64", 4) == 0;
+        SPX_THROW_HR_IF(SPXERR_INVALID_HEADER, !rf64 && std::memcmp(data, "RIFF", 4) != 0);
+
+        WavInfo info;
+        uint64_t ds64DataSize = 0;
+        size_t pos = 12;
+        while (size - pos >= 8)
+        {
+            auto id = data + pos;
+            auto chunkSize = GetLittleEndian(data + pos + 4, 4);
+            auto body = data + pos + 8;
+            auto available = size - pos - 8;
+
+            if (std::memcmp(id, "data", 4) == 0)
+            {
+                SPX_THROW_HR_IF(SPXERR_INVALID_HEADER, info.BlockAlign == 0);
+                auto dataSize = rf64 && chunkSize == 0xffffffff ? ds64DataSize : chunkSize;
+                info.DataOffset = pos + 8;
+                info.DataSize = static_cast<size_t>(std::min<uint64_t>(dataSize, available));
+                info.DataSize -= info.DataSize % info.BlockAlign;
+                return info;
+            }
+
+            SPX_THROW_HR_IF(SPXERR_INVALID_HEADER, chunkSize > available);
+            if (rf64 && std::memcmp(id, "ds64", 4) == 0)
+            {
+                SPX_THROW_HR_IF(SPXERR_INVALID_HEADER, chunkSize < 24);
+                ds64DataSize = GetLittleEndian(body + 8, 8);
+            }
+            else if (std::memcmp(id, "fmt ", 4) == 0)
+            {
+                SPX_THROW_HR_IF(SPXERR_INVALID_HEADER, chunkSize < 16);
+                info.FormatTag = static_cast<uint16_t>(GetLittleEndian(body, 2));
+                info.Channels = static_cast<uint16_t>(GetLittleEndian(body + 2, 2));
+                info.SamplesPerSecond = static_cast<uint32_t>(GetLittleEndian(body + 4, 4));
+                info.BlockAlign = static_cast<uint16_t>(GetLittleEndian(body + 12, 2));
+                info.BitsPerSample = static_cast<uint16_t>(GetLittleEndian(body + 14, 2));
+                if (info.FormatTag == WaveFormatExtensible)
+                {
+                    SPX_THROW_HR_IF(SPXERR_INVALID_HEADER, chunkSize < 40);
+                    info.FormatTag = static_cast<uint16_t>(GetLittleEndian(body + 24, 2));
+                }
+                SPX_THROW_HR_IF(SPXERR_INVALID_HEADER, info.BlockAlign == 0);
+            }
+            pos += 8 + static_cast<size_t>(chunkSize) + static_cast<size_t>(chunkSize % 2);
+            if (pos > size)
+            {
+                break;
+            }
+        }
+        SPX_THROW_HR(SPXERR_INVALID_HEADER);
+    }
+
+}
+
+/*! \endcond */
+
+namespace Audio {
+
+/// <summary>
+/// A <see cref="PullAudioInputStreamCallback"/> reading a WAV file through a memory mapping, for feeding files to a
+/// recognizer without a read system call and an intermediate buffer per <see cref="Read"/>.
+/// </summary>
+/// <remarks>
+/// RIFF and RF64 files are supported, including WAVE_FORMAT_EXTENSIBLE headers, with PCM, A-law, mu-law or G.722 audio.
+/// The stream format is taken from the header. The mapping is advised for sequential access and released when the
+/// callback is destroyed. The file must not be truncated while it is mapped.
+/// </remarks>
+class MappedWavPullStreamCallback : public PullAudioInputStreamCallback
+{
+public:
+
+    /// <summary>
+    /// Maps the file and parses its header.
+    /// </summary>
+    /// <param name="fileName">The path of the WAV file.</param>
+    /// <returns>A shared pointer to the callback.</returns>
+    static std::shared_ptr<MappedWavPullStreamCallback> Create(const std::string& fileName)
+    {
+        return std::shared_ptr<MappedWavPullStreamCallback>(new MappedWavPullStreamCallback(fileName));
+    }
+
+    /// <summary>
+    /// Creates a pull stream reading the WAV file, in the format given by its header.
+    /// </summary>
+    /// <param name="fileName">The path of the WAV file.</param>
+    /// <returns>A shared pointer to the stream, to pass to <see cref="AudioConfig::FromStreamInput"/>.</returns>
+    static std::shared_ptr<PullAudioInputStream> CreatePullStream(const std::string& fileName)
+    {
+        auto callback = Create(fileName);
+        return AudioInputStream::CreatePullStream(callback->GetFormat(), callback);
+    }
+
+    /// <summary>
+    /// Copies the next audio from the mapping. Called by the recognizer.
+    /// </summary>
+    /// <param name="dataBuffer">The buffer receiving the audio.</param>
+    /// <param name="size">The size of the buffer in bytes.</param>
+    /// <returns>The number of bytes copied, 0 at the end of the audio.</returns>
+    int Read(uint8_t* dataBuffer, uint32_t size) override
+    {
+        auto count = std::min<size_t>(size, m_info.DataSize - m_position);
+        std::memcpy(dataBuffer, m_audio + m_position, count);
+        m_position += count;
+        return static_cast<int>(count);
+    }
+
+    /// <summary>
+    /// Called by the recognizer at the end of the stream. The mapping is kept until the callback is destroyed.
+    /// </summary>
+    void Close() override
+    {
+    }
+
+    /// <summary>
+    /// Gets the format of the audio, as given by the header.
+    /// </summary>
+    /// <returns>A shared pointer to the format.</returns>
+    std::shared_ptr<AudioStreamFormat> GetFormat() const
+    {
+        return AudioStreamFormat::GetWaveFormat(m_info.SamplesPerSecond, static_cast<uint8_t>(m_info.BitsPerSample), static_cast<uint8_t>(m_info.Channels), m_waveFormat);
+    }
+
+    /// <summary>
+    /// Gets the encoding of the audio.
+    /// </summary>
+    /// <returns>The wave format.</returns>
+    AudioStreamWaveFormat GetWaveFormat() const { return m_waveFormat; }
+
+    /// <summary>
+    /// Gets the sample rate of the audio.
+    /// </summary>
+    /// <returns>The number of samples per second.</returns>
+    uint32_t GetSamplesPerSecond() const { return m_info.SamplesPerSecond; }
+
+    /// <summary>
+    /// Gets the sample size of the audio.
+    /// </summary>
+    /// <returns>The number of bits per sample.</returns>
+    uint8_t GetBitsPerSample() const { return static_cast<uint8_t>(m_info.BitsPerSample); }
+
+    /// <summary>
+    /// Gets the number of channels of the audio.
+    /// </summary>
+    /// <returns>The number of channels.</returns>
+    uint8_t GetChannels() const { return static_cast<uint8_t>(m_info.Channels); }
+
+    /// <summary>
+    /// Gets the size of the audio, without the header.
+    /// </summary>
+    /// <returns>The size in bytes.</returns>
+    uint64_t GetDataSize() const { return m_info.DataSize; }
+
+private:
+
+    explicit MappedWavPullStreamCallback(const std::string& fileName) :
+        m_file(fileName)
+    {
+        auto data = reinterpret_cast<const uint8_t*>(m_file.GetData());
+        m_info = Details::ParseWav(data, m_file.GetSize());
+        m_waveFormat = ToWaveFormat(m_info.FormatTag);
+        SPX_THROW_HR_IF(SPXERR_UNSUPPORTED_FORMAT, m_info.Channels == 0 || m_info.Channels > UINT8_MAX || m_info.BitsPerSample > UINT8_MAX);
+        m_audio = data + m_info.DataOffset;
+        m_file.Advise(POSIX_MADV_SEQUENTIAL);
+    }
+
+    DISABLE_COPY_AND_MOVE(MappedWavPullStreamCallback);
+
+    static AudioStreamWaveFormat ToWaveFormat(uint16_t formatTag)
+    {
+        switch (static_cast<AudioStreamWaveFormat>(formatTag))
+        {
+        case AudioStreamWaveFormat::PCM:
+        case AudioStreamWaveFormat::ALAW:
+        case AudioStreamWaveFormat::MULAW:
+        case AudioStreamWaveFormat::G722:
+            return static_cast<AudioStreamWaveFormat>(formatTag);
+        default:
+            SPX_THROW_HR(SPXERR_UNSUPPORTED_FORMAT);
+        }
+    }
+
+    Speech::Details::MappedFile m_file;
+    Speech::Details::WavInfo m_info;
+    AudioStreamWaveFormat m_waveFormat = AudioStreamWaveFormat::PCM;
+    const uint8_t* m_audio = nullptr;
+    size_t m_position = 0;
+};
+
+} } } } // Microsoft::CognitiveServices::Speech::Audio
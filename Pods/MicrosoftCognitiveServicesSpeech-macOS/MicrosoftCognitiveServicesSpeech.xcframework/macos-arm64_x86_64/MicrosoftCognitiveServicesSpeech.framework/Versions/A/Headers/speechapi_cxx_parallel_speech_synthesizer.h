@@ -0,0 +1,885 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_parallel_speech_synthesizer.h: Public API declarations for ParallelSpeechSynthesizer C++ class
+//
+
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "speechapi_cxx_common.h"
+#include "speechapi_cxx_string_helpers.h"
+#include "speechapi_cxx_enums.h"
+#include "speechapi_cxx_eventargs.h"
+#include "speechapi_cxx_eventsignal.h"
+#include "speechapi_cxx_async_executor.h"
+#include "speechapi_cxx_audio_stream.h"
+#include "speechapi_cxx_speech_config.h"
+#include "speechapi_cxx_speech_synthesizer.h"
+#include "speechapi_cxx_ssml_segmenter.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+
+/*! \cond PRIVATE */
+
+namespace Details {
+
+    // The settings of a synthesizer that its audio depends on, besides the SSML.
+    inline std::string GetSynthesisSettings(const SpeechSynthesizer& synthesizer)
+    {
+        std::string settings;
+        for (auto id : { PropertyId::SpeechServiceConnection_SynthVoice, PropertyId::SpeechServiceConnection_SynthLanguage,
+                         PropertyId::SpeechServiceConnection_SynthOutputFormat, PropertyId::SpeechServiceConnection_EndpointId })
+        {
+            settings += Utils::ToUTF8(synthesizer.Properties.GetProperty(id));
+            settings += '\n';
+        }
+        return settings;
+    }
+
+}
+
+/*! \endcond */
+
+/// <summary>
+/// A word boundary of a synthesized segment. Offsets are relative to the segment.
+/// </summary>
+struct SpeechSynthesisSegmentWordBoundary
+{
+    /// <summary>
+    /// Audio offset, in ticks (100 nanoseconds).
+    /// </summary>
+    uint64_t AudioOffset;
+
+    /// <summary>
+    /// Time duration of the audio.
+    /// </summary>
+    std::chrono::milliseconds Duration;
+
+    /// <summary>
+    /// Text offset in the SSML of the segment.
+    /// </summary>
+    uint32_t TextOffset;
+
+    /// <summary>
+    /// Word length.
+    /// </summary>
+    uint32_t WordLength;
+
+    /// <summary>
+    /// Boundary type.
+    /// </summary>
+    SpeechSynthesisBoundaryType BoundaryType;
+
+    /// <summary>
+    /// The text.
+    /// </summary>
+    SPXSTRING Text;
+};
+
+/// <summary>
+/// A bookmark of a synthesized segment. Offsets are relative to the segment.
+/// </summary>
+struct SpeechSynthesisSegmentBookmark
+{
+    /// <summary>
+    /// Audio offset, in ticks (100 nanoseconds).
+    /// </summary>
+    uint64_t AudioOffset;
+
+    /// <summary>
+    /// The bookmark text.
+    /// </summary>
+    SPXSTRING Text;
+};
+
+/// <summary>
+/// The audio and the timing events of one synthesized <see cref="SsmlSegment"/>.
+/// </summary>
+class SpeechSynthesisSegmentAudio
+{
+public:
+
+    /// <summary>
+    /// The audio, without RIFF header.
+    /// </summary>
+    std::vector<uint8_t> Audio;
+
+    /// <summary>
+    /// Duration of the audio, in ticks (100 nanoseconds).
+    /// </summary>
+    uint64_t AudioDuration = 0;
+
+    /// <summary>
+    /// The word boundaries, in order.
+    /// </summary>
+    std::vector<SpeechSynthesisSegmentWordBoundary> WordBoundaries;
+
+    /// <summary>
+    /// The bookmarks, in order.
+    /// </summary>
+    std::vector<SpeechSynthesisSegmentBookmark> Bookmarks;
+};
+
+/// <summary>
+/// Class for word boundary event arguments of a <see cref="ParallelSpeechSynthesizer"/>.
+/// Offsets refer to the stitched audio and to the source SSML document.
+/// </summary>
+class ParallelSpeechSynthesisWordBoundaryEventArgs : public EventArgs
+{
+public:
+
+    /// <summary>
+    /// Constructor.
+    /// </summary>
+    /// <param name="segmentIndex">Index of the segment.</param>
+    /// <param name="audioOffset">Audio offset in the stitched audio, in ticks.</param>
+    /// <param name="textOffset">Text offset in the source document.</param>
+    /// <param name="boundary">The word boundary of the segment.</param>
+    ParallelSpeechSynthesisWordBoundaryEventArgs(size_t segmentIndex, uint64_t audioOffset, uint32_t textOffset, const SpeechSynthesisSegmentWordBoundary& boundary) :
+        SegmentIndex(segmentIndex),
+        AudioOffset(audioOffset),
+        Duration(boundary.Duration),
+        TextOffset(textOffset),
+        WordLength(boundary.WordLength),
+        Text(boundary.Text),
+        BoundaryType(boundary.BoundaryType)
+    {
+    }
+
+    /// <summary>
+    /// Index of the segment the word belongs to.
+    /// </summary>
+    const size_t SegmentIndex;
+
+    /// <summary>
+    /// Word boundary audio offset, in ticks (100 nanoseconds).
+    /// </summary>
+    const uint64_t AudioOffset;
+
+    /// <summary>
+    /// Time duration of the audio.
+    /// </summary>
+    const std::chrono::milliseconds Duration;
+
+    /// <summary>
+    /// Word boundary text offset, in UTF-16 code units from the start of the source document.
+    /// </summary>
+    const uint32_t TextOffset;
+
+    /// <summary>
+    /// Word boundary word length.
+    /// </summary>
+    const uint32_t WordLength;
+
+    /// <summary>
+    /// The text.
+    /// </summary>
+    const SPXSTRING& Text;
+
+    /// <summary>
+    /// Word boundary type.
+    /// </summary>
+    const SpeechSynthesisBoundaryType BoundaryType;
+
+private:
+
+    DISABLE_DEFAULT_CTORS(ParallelSpeechSynthesisWordBoundaryEventArgs);
+};
+
+/// <summary>
+/// Class for bookmark event arguments of a <see cref="ParallelSpeechSynthesizer"/>.
+/// </summary>
+class ParallelSpeechSynthesisBookmarkEventArgs : public EventArgs
+{
+public:
+
+    /// <summary>
+    /// Constructor.
+    /// </summary>
+    /// <param name="segmentIndex">Index of the segment.</param>
+    /// <param name="audioOffset">Audio offset in the stitched audio, in ticks.</param>
+    /// <param name="bookmark">The bookmark of the segment.</param>
+    ParallelSpeechSynthesisBookmarkEventArgs(size_t segmentIndex, uint64_t audioOffset, const SpeechSynthesisSegmentBookmark& bookmark) :
+        SegmentIndex(segmentIndex),
+        AudioOffset(audioOffset),
+        Text(bookmark.Text)
+    {
+    }
+
+    /// <summary>
+    /// Index of the segment the bookmark belongs to.
+    /// </summary>
+    const size_t SegmentIndex;
+
+    /// <summary>
+    /// Audio offset in the stitched audio, in ticks (100 nanoseconds).
+    /// </summary>
+    const uint64_t AudioOffset;
+
+    /// <summary>
+    /// The bookmark text.
+    /// </summary>
+    const SPXSTRING& Text;
+
+private:
+
+    DISABLE_DEFAULT_CTORS(ParallelSpeechSynthesisBookmarkEventArgs);
+};
+
+/// <summary>
+/// Options of a <see cref="ParallelSpeechSynthesizer"/>.
+/// </summary>
+struct ParallelSpeechSynthesisOptions
+{
+    /// <summary>
+    /// Number of synthesizers, that is, of segments synthesized at the same time.
+    /// </summary>
+    size_t Concurrency = 4;
+
+    /// <summary>
+    /// Maximum size of the SSML of a segment, in bytes, see <see cref="SsmlSegmenter::Split"/>.
+    /// </summary>
+    size_t MaxSegmentLength = SsmlSegmenter::DefaultMaxSegmentLength;
+
+    /// <summary>
+    /// Number of times a canceled segment is synthesized again before the whole synthesis is canceled.
+    /// </summary>
+    uint32_t MaxRetries = 2;
+
+    /// <summary>
+    /// Where segments end, see <see cref="SsmlSegmenter::Split"/>. Use SsmlSegmentationMode::PerElement for renders that
+    /// reuse a previous result.
+    /// </summary>
+    SsmlSegmentationMode Segmentation = SsmlSegmentationMode::Packed;
+
+    /// <summary>
+    /// Whether results keep the audio of each segment, so that they can be passed as the previous result of a later render.
+    /// The word boundaries and bookmarks of each segment are then kept too, whether or not handlers are connected, so
+    /// that a later render raises them for reused segments.
+    /// </summary>
+    bool KeepSegmentAudio = false;
+};
+
+/// <summary>
+/// The result of a <see cref="ParallelSpeechSynthesizer"/>.
+/// </summary>
+class ParallelSpeechSynthesisResult
+{
+public:
+
+    /// <summary>
+    /// SynthesizingAudioCompleted if all segments were synthesized, otherwise Canceled.
+    /// </summary>
+    const ResultReason& Reason;
+
+    /// <summary>
+    /// Duration of the stitched audio. If the synthesis was canceled, this covers the segments before the canceled one.
+    /// </summary>
+    const std::chrono::milliseconds& AudioDuration;
+
+    /// <summary>
+    /// Number of segments the document was split into.
+    /// </summary>
+    const size_t& SegmentCount;
+
+    /// <summary>
+    /// Number of segments whose audio was taken from the previous result instead of being synthesized.
+    /// </summary>
+    const size_t& ReusedSegmentCount;
+
+    /// <summary>
+    /// Gets the stitched audio. Empty if the audio was written to an output stream.
+    /// </summary>
+    /// <returns>The audio.</returns>
+    std::shared_ptr<std::vector<uint8_t>> GetAudioData() const { return m_audioData; }
+
+    /// <summary>
+    /// Gets the index of the segment that was canceled, if <see cref="Reason"/> is Canceled.
+    /// </summary>
+    /// <returns>The segment index.</returns>
+    size_t GetCanceledSegmentIndex() const { return m_canceledSegmentIndex; }
+
+    /// <summary>
+    /// Gets the result of the segment that was canceled, e.g. for <see cref="SpeechSynthesisCancellationDetails::FromResult"/>.
+    /// </summary>
+    /// <returns>The result, or nullptr if the synthesis completed.</returns>
+    std::shared_ptr<SpeechSynthesisResult> GetCanceledSegmentResult() const { return m_canceledSegmentResult; }
+
+private:
+
+    friend class ParallelSpeechSynthesizer;
+
+    ParallelSpeechSynthesisResult(size_t segmentCount, size_t reusedSegmentCount, uint64_t audioDuration, std::shared_ptr<std::vector<uint8_t>> audioData,
+        size_t canceledSegmentIndex, std::shared_ptr<SpeechSynthesisResult> canceledSegmentResult) :
+        Reason(m_reason),
+        AudioDuration(m_audioDuration),
+        SegmentCount(m_segmentCount),
+        ReusedSegmentCount(m_reusedSegmentCount),
+        m_reason(canceledSegmentResult == nullptr ? ResultReason::SynthesizingAudioCompleted : ResultReason::Canceled),
+        m_audioDuration(std::chrono::milliseconds(audioDuration / 10000)),
+        m_segmentCount(segmentCount),
+        m_reusedSegmentCount(reusedSegmentCount),
+        m_audioData(std::move(audioData)),
+        m_canceledSegmentIndex(canceledSegmentIndex),
+        m_canceledSegmentResult(std::move(canceledSegmentResult))
+    {
+    }
+
+    DISABLE_COPY_AND_MOVE(ParallelSpeechSynthesisResult);
+
+    ResultReason m_reason;
+    std::chrono::milliseconds m_audioDuration;
+    size_t m_segmentCount;
+    size_t m_reusedSegmentCount;
+    std::shared_ptr<std::vector<uint8_t>> m_audioData;
+    size_t m_canceledSegmentIndex;
+    std::shared_ptr<SpeechSynthesisResult> m_canceledSegmentResult;
+
+    // With KeepSegmentAudio, the audio of each segment that was synthesized, by fingerprint.
+    std::unordered_map<std::string, std::shared_ptr<const SpeechSynthesisSegmentAudio>> m_segmentAudio;
+};
+
+/// <summary>
+/// Synthesizes long SSML documents by splitting them into segments with <see cref="SsmlSegmenter"/>, synthesizing the
+/// segments concurrently on several synthesizers, and stitching the audio back together in document order.
+/// </summary>
+/// <remarks>
+/// Audio is written as soon as it and all audio before it are available. Word boundary and bookmark events are raised
+/// in document order too, with audio offsets on the timeline of the stitched audio and text offsets into the source document.
+/// RIFF headers are removed from the audio of the segments, so RIFF output formats produce raw PCM; compressed formats
+/// are concatenated as they are, which suits MP3 but not containers such as Ogg or WebM.
+/// Event handlers and the output stream are called while stitching and must not call back into this object.
+/// A render can reuse the audio of segments that are unchanged since a previous result, see
+/// <see cref="ParallelSpeechSynthesisOptions::KeepSegmentAudio"/>; segments are recognized by a hash of their SSML and of
+/// the synthesizer settings, and only the others are synthesized.
+/// </remarks>
+class ParallelSpeechSynthesizer : public std::enable_shared_from_this<ParallelSpeechSynthesizer>
+{
+public:
+
+    /// <summary>
+    /// Creates a parallel speech synthesizer. Its synthesizers are created with the same configuration and without audio output.
+    /// </summary>
+    /// <param name="speechConfig">Speech configuration.</param>
+    /// <param name="options">Options.</param>
+    /// <returns>A smart pointer wrapped parallel speech synthesizer.</returns>
+    static std::shared_ptr<ParallelSpeechSynthesizer> FromConfig(std::shared_ptr<SpeechConfig> speechConfig, const ParallelSpeechSynthesisOptions& options = ParallelSpeechSynthesisOptions())
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, speechConfig == nullptr || options.Concurrency == 0);
+
+        auto ptr = new ParallelSpeechSynthesizer(options);
+        std::shared_ptr<ParallelSpeechSynthesizer> synthesizer(ptr);
+        for (size_t i = 0; i < options.Concurrency; i++)
+        {
+            synthesizer->m_slots.emplace_back(new Slot(SpeechSynthesizer::FromConfig(speechConfig, nullptr)));
+            synthesizer->m_freeSlots.push_back(synthesizer->m_slots.back().get());
+        }
+        synthesizer->m_settings = Details::GetSynthesisSettings(*synthesizer->m_slots.front()->synthesizer);
+        synthesizer->UpdateEventConnections();
+        return synthesizer;
+    }
+
+    /// <summary>
+    /// Destructor.
+    /// </summary>
+    ~ParallelSpeechSynthesizer()
+    {
+        WordBoundary.DisconnectAll();
+        BookmarkReached.DisconnectAll();
+    }
+
+    /// <summary>
+    /// Synthesizes an SSML document.
+    /// </summary>
+    /// <param name="ssml">The SSML document, UTF-8 encoded.</param>
+    /// <param name="output">Stream the stitched audio is written to, and closed when the synthesis ends; or nullptr to get it from the result.</param>
+    /// <param name="previousResult">A result of an earlier version of the document, whose segment audio is reused where the segments are unchanged; or nullptr.</param>
+    /// <returns>The result.</returns>
+    std::shared_ptr<ParallelSpeechSynthesisResult> SpeakSsml(const std::string& ssml, std::shared_ptr<Audio::PushAudioOutputStreamCallback> output = nullptr,
+        std::shared_ptr<const ParallelSpeechSynthesisResult> previousResult = nullptr)
+    {
+        return SpeakSsmlAsync(ssml, std::move(output), std::move(previousResult)).get();
+    }
+
+    /// <summary>
+    /// Synthesizes an SSML document, asynchronously.
+    /// </summary>
+    /// <param name="ssml">The SSML document, UTF-8 encoded.</param>
+    /// <param name="output">Stream the stitched audio is written to, and closed when the synthesis ends; or nullptr to get it from the result.</param>
+    /// <param name="previousResult">A result of an earlier version of the document, whose segment audio is reused where the segments are unchanged; or nullptr.</param>
+    /// <returns>An asynchronous operation representing the synthesis. It returns a value of <see cref="ParallelSpeechSynthesisResult"/> as result.</returns>
+    std::future<std::shared_ptr<ParallelSpeechSynthesisResult>> SpeakSsmlAsync(const std::string& ssml, std::shared_ptr<Audio::PushAudioOutputStreamCallback> output = nullptr,
+        std::shared_ptr<const ParallelSpeechSynthesisResult> previousResult = nullptr)
+    {
+        auto render = std::make_shared<Render>();
+        render->output = std::move(output);
+        auto future = render->promise.get_future();
+
+        auto keepAlive = this->shared_from_this();
+        AsyncExecutor::GetBlocking()->Post([keepAlive, this, render, ssml, previousResult]() {
+            try
+            {
+                render->segments = SsmlSegmenter::Split(ssml, m_options.MaxSegmentLength, m_options.Segmentation);
+                render->audio.resize(render->segments.size());
+                Reuse(*render, previousResult.get());
+            }
+            catch (...)
+            {
+                render->promise.set_exception(std::current_exception());
+                return;
+            }
+            Start(render);
+        });
+
+        return future;
+    }
+
+    /// <summary>
+    /// Signal for events indicating word boundary, in document order.
+    /// </summary>
+    EventSignal<const ParallelSpeechSynthesisWordBoundaryEventArgs&> WordBoundary;
+
+    /// <summary>
+    /// Signal for events indicating a bookmark was reached, in document order.
+    /// </summary>
+    EventSignal<const ParallelSpeechSynthesisBookmarkEventArgs&> BookmarkReached;
+
+protected:
+
+    /*! \cond PROTECTED */
+
+    explicit ParallelSpeechSynthesizer(const ParallelSpeechSynthesisOptions& options) :
+        WordBoundary([this](const EventSignal<const ParallelSpeechSynthesisWordBoundaryEventArgs&>&) { UpdateEventConnections(); }),
+        BookmarkReached([this](const EventSignal<const ParallelSpeechSynthesisBookmarkEventArgs&>&) { UpdateEventConnections(); }),
+        m_options(options)
+    {
+    }
+
+    /*! \endcond */
+
+private:
+
+    DISABLE_DEFAULT_CTORS(ParallelSpeechSynthesizer);
+
+    // A synthesizer, and the audio of the segment it is synthesizing.
+    struct Slot
+    {
+        explicit Slot(std::shared_ptr<SpeechSynthesizer> synthesizer) :
+            synthesizer(std::move(synthesizer))
+        {
+        }
+
+        std::mutex mutex;
+        SpeechSynthesisSegmentAudio* current = nullptr;
+        bool wordBoundaryConnected = false;
+        bool bookmarkConnected = false;
+
+        // Destroyed first, so that no event arrives for a destroyed slot.
+        std::shared_ptr<SpeechSynthesizer> synthesizer;
+    };
+
+    // The state of one SpeakSsmlAsync call.
+    struct Render
+    {
+        std::vector<SsmlSegment> segments;
+        std::vector<std::shared_ptr<const SpeechSynthesisSegmentAudio>> audio;
+        std::shared_ptr<Audio::PushAudioOutputStreamCallback> output;
+        std::shared_ptr<std::vector<uint8_t>> audioData = std::make_shared<std::vector<uint8_t>>();
+        std::promise<std::shared_ptr<ParallelSpeechSynthesisResult>> promise;
+        std::vector<std::string> fingerprints;
+        size_t reused = 0;
+        std::unordered_map<std::string, std::shared_ptr<const SpeechSynthesisSegmentAudio>> segmentAudio;
+
+        std::mutex mutex;
+        size_t nextSegment = 0;
+        size_t nextToStitch = 0;
+        uint64_t stitchedDuration = 0;
+        bool stitching = false;
+        size_t workers = 0;
+
+        bool canceled = false;
+        size_t canceledSegmentIndex = SIZE_MAX;
+        std::shared_ptr<SpeechSynthesisResult> canceledSegmentResult;
+        std::exception_ptr error;
+    };
+
+    // The synthesizers only raise the events this object has handlers for, or all of them when the segment audio is
+    // kept, since a later render may reuse it with handlers connected.
+    void UpdateEventConnections()
+    {
+        auto wordBoundary = m_options.KeepSegmentAudio || WordBoundary.IsConnected();
+        auto bookmark = m_options.KeepSegmentAudio || BookmarkReached.IsConnected();
+        for (auto& owned : m_slots)
+        {
+            auto slot = owned.get();
+            std::unique_lock<std::mutex> lock(slot->mutex);
+            if (wordBoundary != slot->wordBoundaryConnected)
+            {
+                slot->wordBoundaryConnected = wordBoundary;
+                if (wordBoundary)
+                {
+                    slot->synthesizer->WordBoundary.Connect([slot](const SpeechSynthesisWordBoundaryEventArgs& e) {
+                        std::unique_lock<std::mutex> lock(slot->mutex);
+                        if (slot->current != nullptr)
+                        {
+                            slot->current->WordBoundaries.push_back(SpeechSynthesisSegmentWordBoundary{ e.AudioOffset, e.Duration, e.TextOffset, e.WordLength, e.BoundaryType, e.Text });
+                        }
+                    });
+                }
+                else
+                {
+                    slot->synthesizer->WordBoundary.DisconnectAll();
+                }
+            }
+            if (bookmark != slot->bookmarkConnected)
+            {
+                slot->bookmarkConnected = bookmark;
+                if (bookmark)
+                {
+                    slot->synthesizer->BookmarkReached.Connect([slot](const SpeechSynthesisBookmarkEventArgs& e) {
+                        std::unique_lock<std::mutex> lock(slot->mutex);
+                        if (slot->current != nullptr)
+                        {
+                            slot->current->Bookmarks.push_back(SpeechSynthesisSegmentBookmark{ e.AudioOffset, e.Text });
+                        }
+                    });
+                }
+                else
+                {
+                    slot->synthesizer->BookmarkReached.DisconnectAll();
+                }
+            }
+        }
+    }
+
+    // Takes the audio of the segments that are unchanged since the previous result.
+    void Reuse(Render& render, const ParallelSpeechSynthesisResult* previousResult)
+    {
+        if (!m_options.KeepSegmentAudio && (previousResult == nullptr || previousResult->m_segmentAudio.empty()))
+        {
+            return;
+        }
+
+        render.fingerprints.reserve(render.segments.size());
+        for (size_t i = 0; i < render.segments.size(); i++)
+        {
+            render.fingerprints.push_back(Details::HashContent(m_settings + render.segments[i].Ssml));
+            if (previousResult != nullptr)
+            {
+                auto it = previousResult->m_segmentAudio.find(render.fingerprints.back());
+                if (it != previousResult->m_segmentAudio.end())
+                {
+                    render.audio[i] = it->second;
+                    render.reused++;
+                }
+            }
+        }
+    }
+
+    void Start(const std::shared_ptr<Render>& render)
+    {
+        // Reused segments at the start are ready right away; the others are stitched as the segments before them finish.
+        {
+            std::unique_lock<std::mutex> lock(render->mutex);
+            Stitch(*render, lock);
+        }
+
+        auto workers = std::min(m_options.Concurrency, render->segments.size() - render->reused);
+        if (workers == 0)
+        {
+            Complete(*render);
+            return;
+        }
+
+        render->workers = workers;
+        auto keepAlive = this->shared_from_this();
+        for (size_t i = 1; i < workers; i++)
+        {
+            try
+            {
+                AsyncExecutor::GetBlocking()->Post([keepAlive, this, render]() { RunWorker(*render); });
+            }
+            catch (...)
+            {
+                // Fewer workers still synthesize every segment.
+                std::unique_lock<std::mutex> lock(render->mutex);
+                render->workers--;
+            }
+        }
+        RunWorker(*render);
+    }
+
+    void RunWorker(Render& render)
+    {
+        std::unique_lock<std::mutex> lock(render.mutex);
+        while (!render.canceled && render.nextSegment < render.segments.size())
+        {
+            auto index = render.nextSegment++;
+            if (index < render.nextToStitch || render.audio[index] != nullptr)
+            {
+                // Reused.
+                continue;
+            }
+            lock.unlock();
+
+            std::shared_ptr<SpeechSynthesisSegmentAudio> audio;
+            std::shared_ptr<SpeechSynthesisResult> canceledResult;
+            std::exception_ptr error;
+            try
+            {
+                audio = SynthesizeSegment(render.segments[index], canceledResult);
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+
+            lock.lock();
+            if (audio != nullptr)
+            {
+                render.audio[index] = std::move(audio);
+            }
+            else if (index < render.canceledSegmentIndex)
+            {
+                render.canceled = true;
+                render.canceledSegmentIndex = index;
+                render.canceledSegmentResult = std::move(canceledResult);
+                render.error = error;
+            }
+            Stitch(render, lock);
+        }
+
+        if (--render.workers == 0)
+        {
+            lock.unlock();
+            Complete(render);
+        }
+    }
+
+    std::shared_ptr<SpeechSynthesisSegmentAudio> SynthesizeSegment(const SsmlSegment& segment, std::shared_ptr<SpeechSynthesisResult>& canceledResult)
+    {
+        auto slot = AcquireSlot();
+        std::shared_ptr<SpeechSynthesisSegmentAudio> audio;
+        try
+        {
+            for (uint32_t attempt = 0; attempt <= m_options.MaxRetries && audio == nullptr; attempt++)
+            {
+                auto current = std::make_shared<SpeechSynthesisSegmentAudio>();
+                SetCurrent(*slot, current.get());
+                auto result = slot->synthesizer->SpeakSsml(segment.Ssml);
+                SetCurrent(*slot, nullptr);
+
+                if (result->Reason == ResultReason::SynthesizingAudioCompleted)
+                {
+                    SetAudio(*current, *result);
+                    audio = std::move(current);
+                }
+                else
+                {
+                    canceledResult = std::move(result);
+                }
+            }
+        }
+        catch (...)
+        {
+            SetCurrent(*slot, nullptr);
+            ReleaseSlot(slot);
+            throw;
+        }
+
+        ReleaseSlot(slot);
+        return audio;
+    }
+
+    static void SetCurrent(Slot& slot, SpeechSynthesisSegmentAudio* current)
+    {
+        std::unique_lock<std::mutex> lock(slot.mutex);
+        slot.current = current;
+    }
+
+    // Copies the audio without its RIFF header. The duration is exact for PCM, otherwise as reported by the service.
+    static void SetAudio(SpeechSynthesisSegmentAudio& segment, SpeechSynthesisResult& result)
+    {
+        auto audioData = result.GetAudioData();
+        auto data = audioData->data();
+        auto size = audioData->size();
+        uint32_t byteRate = 0;
+
+        auto readUInt32 = [data](size_t offset) {
+            return static_cast<uint32_t>(data[offset]) | static_cast<uint32_t>(data[offset + 1]) << 8 |
+                static_cast<uint32_t>(data[offset + 2]) << 16 | static_cast<uint32_t>(data[offset + 3]) << 24;
+        };
+        if (size >= 12 && std::memcmp(data, "RIFF", 4) == 0 && std::memcmp(data + 8, "WAVE", 4) == 0)
+        {
+            size_t offset = 12;
+            while (offset + 8 <= size)
+            {
+                auto chunkSize = readUInt32(offset + 4);
+                if (std::memcmp(data + offset, "fmt ", 4) == 0 && offset + 20 <= size)
+                {
+                    byteRate = readUInt32(offset + 16);
+                }
+                if (std::memcmp(data + offset, "data", 4) == 0)
+                {
+                    offset += 8;
+                    break;
+                }
+                offset += 8 + static_cast<size_t>(chunkSize) + (chunkSize & 1);
+            }
+            offset = std::min(offset, size);
+            data += offset;
+            size -= offset;
+        }
+
+        segment.Audio.assign(data, data + size);
+        segment.AudioDuration = byteRate != 0
+            ? static_cast<uint64_t>(size) * 10000000 / byteRate
+            : static_cast<uint64_t>(result.AudioDuration.count()) * 10000;
+    }
+
+    Slot* AcquireSlot()
+    {
+        std::unique_lock<std::mutex> lock(m_slotsMutex);
+        m_slotAvailable.wait(lock, [this] { return !m_freeSlots.empty(); });
+        auto slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        return slot;
+    }
+
+    void ReleaseSlot(Slot* slot)
+    {
+        std::unique_lock<std::mutex> lock(m_slotsMutex);
+        m_freeSlots.push_back(slot);
+        m_slotAvailable.notify_one();
+    }
+
+    // Writes the audio and raises the events of the segments that are ready, in order. One worker stitches at a time,
+    // the others return right away and leave their segments to it.
+    void Stitch(Render& render, std::unique_lock<std::mutex>& lock)
+    {
+        if (render.stitching)
+        {
+            return;
+        }
+
+        render.stitching = true;
+        while (render.nextToStitch < render.segments.size() && render.audio[render.nextToStitch] != nullptr && render.nextToStitch < render.canceledSegmentIndex)
+        {
+            auto index = render.nextToStitch++;
+            auto audio = std::move(render.audio[index]);
+            if (m_options.KeepSegmentAudio)
+            {
+                render.segmentAudio.emplace(render.fingerprints[index], audio);
+            }
+            auto audioOffset = render.stitchedDuration;
+            render.stitchedDuration += audio->AudioDuration;
+            lock.unlock();
+
+            try
+            {
+                WriteSegment(render, index, audioOffset, *audio);
+            }
+            catch (...)
+            {
+                lock.lock();
+                render.canceled = true;
+                render.canceledSegmentIndex = std::min(render.canceledSegmentIndex, index);
+                render.error = std::current_exception();
+                break;
+            }
+            lock.lock();
+        }
+        render.stitching = false;
+    }
+
+    void WriteSegment(Render& render, size_t index, uint64_t audioOffset, const SpeechSynthesisSegmentAudio& audio)
+    {
+        if (render.output != nullptr)
+        {
+            auto data = const_cast<uint8_t*>(audio.Audio.data());
+            size_t written = 0;
+            while (written < audio.Audio.size())
+            {
+                auto size = static_cast<uint32_t>(std::min<size_t>(audio.Audio.size() - written, UINT32_MAX));
+                auto consumed = render.output->Write(data + written, size);
+                SPX_THROW_HR_IF(SPXERR_RUNTIME_ERROR, consumed <= 0);
+                written += static_cast<size_t>(consumed);
+            }
+        }
+        else
+        {
+            render.audioData->insert(render.audioData->end(), audio.Audio.begin(), audio.Audio.end());
+        }
+
+        // Interleave the word boundaries and bookmarks by audio offset.
+        auto& segment = render.segments[index];
+        auto boundary = audio.WordBoundaries.begin();
+        auto bookmark = audio.Bookmarks.begin();
+        while (boundary != audio.WordBoundaries.end() || bookmark != audio.Bookmarks.end())
+        {
+            if (bookmark == audio.Bookmarks.end() || (boundary != audio.WordBoundaries.end() && boundary->AudioOffset < bookmark->AudioOffset))
+            {
+                WordBoundary.Signal(ParallelSpeechSynthesisWordBoundaryEventArgs(index, audioOffset + boundary->AudioOffset, segment.ToSourceTextOffset(boundary->TextOffset), *boundary));
+                ++boundary;
+            }
+            else
+            {
+                BookmarkReached.Signal(ParallelSpeechSynthesisBookmarkEventArgs(index, audioOffset + bookmark->AudioOffset, *bookmark));
+                ++bookmark;
+            }
+        }
+    }
+
+    void Complete(Render& render)
+    {
+        if (render.output != nullptr)
+        {
+            try
+            {
+                render.output->Close();
+            }
+            catch (...)
+            {
+                render.error = render.error != nullptr ? render.error : std::current_exception();
+            }
+        }
+
+        if (render.error != nullptr && render.canceledSegmentResult == nullptr)
+        {
+            render.promise.set_exception(render.error);
+            return;
+        }
+
+        auto audioData = render.output != nullptr ? std::make_shared<std::vector<uint8_t>>() : render.audioData;
+        auto ptr = new ParallelSpeechSynthesisResult(render.segments.size(), render.reused, render.stitchedDuration, std::move(audioData),
+            render.canceledSegmentIndex, render.canceledSegmentResult);
+        ptr->m_segmentAudio = std::move(render.segmentAudio);
+        render.promise.set_value(std::shared_ptr<ParallelSpeechSynthesisResult>(ptr));
+    }
+
+    const ParallelSpeechSynthesisOptions m_options;
+    std::string m_settings;
+
+    std::mutex m_slotsMutex;
+    std::condition_variable m_slotAvailable;
+    std::vector<Slot*> m_freeSlots;
+    std::vector<std::unique_ptr<Slot>> m_slots;
+};
+
+} } } // Microsoft::CognitiveServices::Speech
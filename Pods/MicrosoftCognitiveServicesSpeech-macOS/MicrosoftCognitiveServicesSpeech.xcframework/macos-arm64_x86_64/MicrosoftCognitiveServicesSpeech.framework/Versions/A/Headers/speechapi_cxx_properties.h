@@ -1,9 +1,21 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#if defined(__cpp_lib_string_view)
+#include <string_view>
+#endif
 #include "speechapi_cxx_common.h"
 #include "speechapi_cxx_string_helpers.h"
 #include "speechapi_cxx_enums.h"
+#include "speechapi_cxx_property_traits.h"
 #include "speechapi_c_session.h"
 #include "speechapi_c_property_bag.h"
 #include "speechapi_cxx_speech_config.h"
@@ -13,6 +25,167 @@ namespace CognitiveServices {
 namespace Speech {
 
 class KeywordRecognizer;
+class PropertyCollection;
+
+/*! \cond PRIVATE */
+
+namespace Details {
+
+    // Passed as the default value of native reads to tell an undefined property from one set to the default.
+    inline const char* UndefinedPropertyValue()
+    {
+        return "\x01undefined\x01";
+    }
+
+    // Reads a property through the C API; returns nullptr if the property is not defined. The value must be released
+    // with property_bag_free_string.
+    inline const char* GetDefinedProperty(SPXPROPERTYBAGHANDLE propbag, int id, const char* name)
+    {
+        auto value = property_bag_get_string(propbag, id, name, UndefinedPropertyValue());
+        if (value != nullptr && std::strcmp(value, UndefinedPropertyValue()) == 0)
+        {
+            property_bag_free_string(value);
+            return nullptr;
+        }
+        return value;
+    }
+
+    // Values read from a property collection, by id and by name, including whether they are defined.
+    class PropertyReadCache
+    {
+    public:
+
+        template <class Key, class Fetch>
+        SPXSTRING Get(const Key& key, const SPXSTRING& defaultValue, Fetch&& fetch)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            auto& values = GetValues(key);
+            auto item = values.find(key);
+            if (item != values.end())
+            {
+                return item->second.first ? item->second.second : defaultValue;
+            }
+
+            // The native call is made without the lock. A value read while the collection is being set is returned
+            // but not kept.
+            auto generation = m_generation;
+            lock.unlock();
+            auto value = fetch();
+            lock.lock();
+            auto result = value.first ? value.second : defaultValue;
+            if (generation == m_generation)
+            {
+                values.emplace(key, std::move(value));
+            }
+            return result;
+        }
+
+        void Clear()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_generation++;
+            m_byId.clear();
+            m_byName.clear();
+        }
+
+    private:
+
+        using Value = std::pair<bool, SPXSTRING>;
+
+        std::unordered_map<int, Value>& GetValues(int) { return m_byId; }
+        std::unordered_map<SPXSTRING, Value>& GetValues(const SPXSTRING&) { return m_byName; }
+
+        std::mutex m_mutex;
+        uint64_t m_generation = 0;
+        std::unordered_map<int, Value> m_byId;
+        std::unordered_map<SPXSTRING, Value> m_byName;
+    };
+
+}
+
+/*! \endcond */
+
+/// <summary>
+/// Values of a set of properties read at once from a <see cref="PropertyCollection"/>.
+/// </summary>
+/// <remarks>
+/// The values are stored, as UTF-8 and null terminated, in a single buffer; the pointers returned are valid as long as
+/// the snapshot. Later changes to the collection are not reflected.
+/// </remarks>
+class PropertyCollectionSnapshot
+{
+public:
+
+    /// <summary>
+    /// Gets whether a property was taken into the snapshot and is defined.
+    /// </summary>
+    /// <param name="propertyID">The id of the property.</param>
+    /// <returns>true if the property has a value.</returns>
+    bool HasProperty(PropertyId propertyID) const
+    {
+        auto entry = Find(propertyID);
+        return entry != nullptr && entry->Defined;
+    }
+
+    /// <summary>
+    /// Gets the value of a property.
+    /// </summary>
+    /// <param name="propertyID">The id of the property.</param>
+    /// <returns>The value, or an empty string if the property is not defined or not in the snapshot.</returns>
+    const char* GetProperty(PropertyId propertyID) const
+    {
+        auto entry = Find(propertyID);
+        return entry != nullptr ? m_values.c_str() + entry->Offset : "";
+    }
+
+    /// <summary>
+    /// Gets the length of the value of a property.
+    /// </summary>
+    /// <param name="propertyID">The id of the property.</param>
+    /// <returns>The length in bytes, without the terminating null.</returns>
+    size_t GetPropertySize(PropertyId propertyID) const
+    {
+        auto entry = Find(propertyID);
+        return entry != nullptr ? entry->Size : 0;
+    }
+
+#if defined(__cpp_lib_string_view)
+    /// <summary>
+    /// Gets the value of a property.
+    /// </summary>
+    /// <param name="propertyID">The id of the property.</param>
+    /// <returns>A view of the value, empty if the property is not defined or not in the snapshot.</returns>
+    std::string_view GetPropertyView(PropertyId propertyID) const
+    {
+        auto entry = Find(propertyID);
+        return entry != nullptr ? std::string_view(m_values.data() + entry->Offset, entry->Size) : std::string_view();
+    }
+#endif
+
+private:
+
+    friend class PropertyCollection;
+
+    struct Entry
+    {
+        int Id;
+        bool Defined;
+        size_t Offset;
+        size_t Size;
+    };
+
+    PropertyCollectionSnapshot() = default;
+
+    const Entry* Find(PropertyId propertyID) const
+    {
+        auto id = static_cast<int>(propertyID);
+        auto entry = std::lower_bound(m_entries.begin(), m_entries.end(), id, [](const Entry& e, int value) { return e.Id < value; });
+        return entry != m_entries.end() && entry->Id == id ? &*entry : nullptr;
+    }
+
+    std::vector<Entry> m_entries;
+    std::string m_values;
+};
 
 /// <summary>
 /// Class to retrieve or set a property value from a property collection.
@@ -41,6 +214,7 @@ public:
     void SetProperty(PropertyId propertyID, const SPXSTRING& value)
     {
         property_bag_set_string(m_propbag, (int)propertyID, NULL, Utils::ToUTF8(value).c_str());
+        ClearReadCache();
     }
 
     /// <summary>
@@ -51,6 +225,7 @@ public:
     void SetProperty(const SPXSTRING& propertyName, const SPXSTRING& value)
     {
         property_bag_set_string(m_propbag, -1, Utils::ToUTF8(propertyName).c_str(), Utils::ToUTF8(value).c_str());
+        ClearReadCache();
     }
 
     /// <summary>
@@ -62,6 +237,11 @@ public:
     /// <returns>value of the property.</returns>
     SPXSTRING GetProperty(PropertyId propertyID, const SPXSTRING& defaultValue = SPXSTRING()) const
     {
+        if (m_cache != nullptr)
+        {
+            auto id = static_cast<int>(propertyID);
+            return m_cache->Get(id, defaultValue, [this, id]() { return FetchProperty(id, nullptr); });
+        }
         const char* propCch = property_bag_get_string(m_propbag, static_cast<int>(propertyID), nullptr, Utils::ToUTF8(defaultValue).c_str());
         return Utils::ToSPXString(Utils::CopyAndFreePropertyString(propCch));
     }
@@ -75,10 +255,82 @@ public:
     /// <returns>value of the property.</returns>
     SPXSTRING GetProperty(const SPXSTRING& propertyName, const SPXSTRING& defaultValue = SPXSTRING()) const
     {
+        if (m_cache != nullptr)
+        {
+            return m_cache->Get(propertyName, defaultValue, [this, &propertyName]() { return FetchProperty(-1, Utils::ToUTF8(propertyName).c_str()); });
+        }
         const char* propCch = property_bag_get_string(m_propbag, -1, Utils::ToUTF8(propertyName).c_str(), Utils::ToUTF8(defaultValue).c_str());
         return Utils::ToSPXString(Utils::CopyAndFreePropertyString(propCch));
     }
 
+    /// <summary>
+    /// Returns the value of a property in its native type, see <see cref="PropertyTraits"/>.
+    /// </summary>
+    /// <param name="defaultValue">The value which is returned if the property is not defined or not valid.</param>
+    /// <returns>value of the property.</returns>
+    template <PropertyId propertyID>
+    typename PropertyTraits<propertyID>::Type Get(typename PropertyTraits<propertyID>::Type defaultValue = typename PropertyTraits<propertyID>::Type()) const
+    {
+        auto value = defaultValue;
+        if (m_cache != nullptr)
+        {
+            PropertyTraits<propertyID>::Parse(Utils::ToUTF8(GetProperty(propertyID)).c_str(), value);
+            return value;
+        }
+        Details::GetTypedProperty<propertyID>(m_propbag, value);
+        return value;
+    }
+
+    /// <summary>
+    /// Sets a property from a value of its native type, see <see cref="PropertyTraits"/>.
+    /// </summary>
+    /// <param name="value">value to set; an integer out of the range of the property throws.</param>
+    template <PropertyId propertyID, class T>
+    void Set(const T& value)
+    {
+        SPX_THROW_ON_FAIL(Details::SetTypedProperty<propertyID>(m_propbag, value));
+        ClearReadCache();
+    }
+
+    /// <summary>
+    /// Reads the values of a set of properties at once, into a single buffer.
+    /// </summary>
+    /// <param name="propertyIDs">The ids of the properties.</param>
+    /// <returns>The values of the properties.</returns>
+    PropertyCollectionSnapshot Snapshot(const std::vector<PropertyId>& propertyIDs) const
+    {
+        std::vector<const char*> values;
+        values.reserve(propertyIDs.size());
+        PropertyCollectionSnapshot snapshot;
+        auto& entries = snapshot.m_entries;
+        entries.reserve(propertyIDs.size());
+        size_t size = 0;
+        for (auto propertyID : propertyIDs)
+        {
+            auto value = Details::GetDefinedProperty(m_propbag, static_cast<int>(propertyID), nullptr);
+            auto length = value != nullptr ? std::strlen(value) : 0;
+            entries.push_back({ static_cast<int>(propertyID), value != nullptr, size, length });
+            values.push_back(value);
+            size += length + 1;
+        }
+
+        snapshot.m_values.reserve(size);
+        for (auto value : values)
+        {
+            if (value != nullptr)
+            {
+                snapshot.m_values.append(value);
+                property_bag_free_string(value);
+            }
+            snapshot.m_values.push_back('\0');
+        }
+
+        using Entry = PropertyCollectionSnapshot::Entry;
+        std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.Id < b.Id; });
+        entries.erase(std::unique(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.Id == b.Id; }), entries.end());
+        return snapshot;
+    }
+
 protected:
     friend class KeywordRecognizer;
 
@@ -86,13 +338,42 @@ protected:
 
     PropertyCollection(SPXPROPERTYBAGHANDLE propbag) : m_propbag(propbag) {}
 
+    /// <summary>
+    /// Keeps the values read, so that later reads of the same property do not cross the C API. For collections whose
+    /// native values do not change, such as those of results; local calls to SetProperty clear the values kept.
+    /// </summary>
+    void EnableReadCache()
+    {
+        if (m_cache == nullptr)
+        {
+            m_cache.reset(new Details::PropertyReadCache());
+        }
+    }
+
     /*! \endcond */
 
 private:
 
     DISABLE_COPY_AND_MOVE(PropertyCollection);
 
+    std::pair<bool, SPXSTRING> FetchProperty(int id, const char* name) const
+    {
+        auto value = Details::GetDefinedProperty(m_propbag, id, name);
+        auto defined = value != nullptr;
+        return std::make_pair(defined, Utils::ToSPXString(defined ? Utils::CopyAndFreePropertyString(value) : std::string()));
+    }
+
+    // Called after the native value is set, so that no read in between keeps the previous value.
+    void ClearReadCache()
+    {
+        if (m_cache != nullptr)
+        {
+            m_cache->Clear();
+        }
+    }
+
     SPXPROPERTYBAGHANDLE m_propbag;
+    std::unique_ptr<Details::PropertyReadCache> m_cache;
 };
 
 
@@ -0,0 +1,281 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_property_traits.h: Public API declarations for the native types of property ids
+//
+
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "speechapi_cxx_common.h"
+#include "speechapi_cxx_enums.h"
+#include "speechapi_cxx_string_helpers.h"
+#include "speechapi_c_property_bag.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+
+/*! \cond PRIVATE */
+
+namespace Details {
+
+    // Conversions between typed values and the text stored in property bags. They do not depend on the locale;
+    // Format returns either a constant string or the buffer, and Parse only sets the value on success.
+
+    inline bool EqualsIgnoreCase(const char* text, const char* expected)
+    {
+        for (; *text != '\0' && *expected != '\0'; text++, expected++)
+        {
+            auto c = *text >= 'A' && *text <= 'Z' ? static_cast<char>(*text - 'A' + 'a') : *text;
+            if (c != *expected)
+            {
+                return false;
+            }
+        }
+        return *text == *expected;
+    }
+
+    struct BoolPropertyConverter
+    {
+        using Type = bool;
+
+        static const char* Format(bool value, char*, size_t)
+        {
+            return value ? TrueString : FalseString;
+        }
+
+        static bool Parse(const char* text, bool& value)
+        {
+            if (EqualsIgnoreCase(text, TrueString) || EqualsIgnoreCase(text, FalseString))
+            {
+                value = EqualsIgnoreCase(text, TrueString);
+                return true;
+            }
+            return false;
+        }
+    };
+
+    template <class T>
+    struct IntegerPropertyConverter
+    {
+        using Type = T;
+
+        static const char* Format(T value, char* buffer, size_t size)
+        {
+            auto negative = IsNegative(value, std::is_signed<T>());
+            auto magnitude = negative ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+            if (negative)
+            {
+                *buffer++ = '-';
+                size--;
+            }
+            SPX_THROW_HR_IF(SPXERR_BUFFER_TOO_SMALL, Utils::FormatDecimal(magnitude, buffer, size) == 0);
+            return negative ? buffer - 1 : buffer;
+        }
+
+        static bool Parse(const char* text, T& value)
+        {
+            auto negative = *text == '-';
+            uint64_t magnitude = 0;
+            if ((negative && !std::is_signed<T>::value) || !Utils::ParseDecimal(negative ? text + 1 : text, magnitude))
+            {
+                return false;
+            }
+            auto limit = static_cast<uint64_t>(std::numeric_limits<T>::max()) + (negative ? 1 : 0);
+            if (magnitude > limit || (negative && magnitude == 0))
+            {
+                return false;
+            }
+            value = negative ? static_cast<T>(-static_cast<int64_t>(magnitude - 1) - 1) : static_cast<T>(magnitude);
+            return true;
+        }
+
+    private:
+
+        static bool IsNegative(T value, std::true_type) { return value < 0; }
+        static bool IsNegative(T, std::false_type) { return false; }
+    };
+
+    struct MillisecondsPropertyConverter
+    {
+        using Type = std::chrono::milliseconds;
+
+        static const char* Format(std::chrono::milliseconds value, char* buffer, size_t size)
+        {
+            return IntegerPropertyConverter<std::chrono::milliseconds::rep>::Format(value.count(), buffer, size);
+        }
+
+        static bool Parse(const char* text, std::chrono::milliseconds& value)
+        {
+            std::chrono::milliseconds::rep count = 0;
+            if (!IntegerPropertyConverter<std::chrono::milliseconds::rep>::Parse(text, count))
+            {
+                return false;
+            }
+            value = std::chrono::milliseconds(count);
+            return true;
+        }
+    };
+
+    struct ProfanityOptionPropertyConverter
+    {
+        using Type = ProfanityOption;
+
+        static const char* Format(ProfanityOption value, char*, size_t)
+        {
+            switch (value)
+            {
+            case ProfanityOption::Masked: return "masked";
+            case ProfanityOption::Removed: return "removed";
+            case ProfanityOption::Raw: return "raw";
+            default: SPX_THROW_HR(SPXERR_INVALID_ARG);
+            }
+        }
+
+        static bool Parse(const char* text, ProfanityOption& value)
+        {
+            for (auto option : { ProfanityOption::Masked, ProfanityOption::Removed, ProfanityOption::Raw })
+            {
+                if (EqualsIgnoreCase(text, Format(option, nullptr, 0)))
+                {
+                    value = option;
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+
+    template <PropertyId id>
+    struct HasNoPropertyTraits : std::false_type
+    {
+    };
+
+    // Values accepted by the typed setters: those converting implicitly to the type of the property, except that
+    // bool properties only take bool, and integer properties only integers other than bool. Integers are also
+    // checked against the range of the property when set, see IsInPropertyRange.
+    template <class T, class Type>
+    struct IsPropertyValue : std::integral_constant<bool,
+        std::is_convertible<T, Type>::value &&
+        std::is_same<T, bool>::value == std::is_same<Type, bool>::value &&
+        !std::is_floating_point<T>::value &&
+        (!std::is_integral<Type>::value || std::is_integral<T>::value)>
+    {
+    };
+
+    template <class T>
+    inline bool IsNegativeValue(const T& value, std::true_type) { return value < 0; }
+
+    template <class T>
+    inline bool IsNegativeValue(const T&, std::false_type) { return false; }
+
+    // Whether an integer is representable in the integer type of a property, so that setting it does not wrap,
+    // e.g. -1 for a port.
+    template <class Type, class T>
+    inline bool IsInPropertyRange(const T& value, std::true_type)
+    {
+        return IsNegativeValue(value, std::is_signed<T>())
+            ? static_cast<int64_t>(value) >= static_cast<int64_t>(std::numeric_limits<Type>::min())
+            : static_cast<uint64_t>(value) <= static_cast<uint64_t>(std::numeric_limits<Type>::max());
+    }
+
+    template <class Type, class T>
+    inline bool IsInPropertyRange(const T&, std::false_type)
+    {
+        return true;
+    }
+
+}
+
+/*! \endcond */
+
+/// <summary>
+/// The native type of a property and its conversions from and to the text stored in property bags, for the typed
+/// accessors <see cref="PropertyCollection::Get"/> and <see cref="SpeechConfig::Get"/>.
+/// Properties without an entry, such as those holding names, keys or free text, are only accessible as strings;
+/// using the typed accessors with them does not compile.
+/// </summary>
+template <PropertyId id>
+struct PropertyTraits
+{
+    static_assert(Details::HasNoPropertyTraits<id>::value, "The property has no native type; use GetProperty and SetProperty.");
+};
+
+/*! \cond PRIVATE */
+
+template <> struct PropertyTraits<PropertyId::SpeechServiceConnection_ProxyPort> : Details::IntegerPropertyConverter<uint32_t> {};
+template <> struct PropertyTraits<PropertyId::SpeechServiceConnection_SynthEnableCompressedAudioTransmission> : Details::BoolPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::SpeechServiceConnection_InitialSilenceTimeoutMs> : Details::MillisecondsPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::SpeechServiceConnection_EndSilenceTimeoutMs> : Details::MillisecondsPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::SpeechServiceConnection_EnableAudioLogging> : Details::BoolPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::SpeechServiceResponse_RequestDetailedResultTrueFalse> : Details::BoolPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::SpeechServiceResponse_RequestProfanityFilterTrueFalse> : Details::BoolPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::SpeechServiceResponse_ProfanityOption> : Details::ProfanityOptionPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::SpeechServiceResponse_RequestWordLevelTimestamps> : Details::BoolPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::SpeechServiceResponse_StablePartialResultThreshold> : Details::IntegerPropertyConverter<int32_t> {};
+template <> struct PropertyTraits<PropertyId::SpeechServiceResponse_RequestSnr> : Details::BoolPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::SpeechServiceResponse_TranslationRequestStablePartialResult> : Details::BoolPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::SpeechServiceResponse_RequestWordBoundary> : Details::BoolPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::SpeechServiceResponse_RequestPunctuationBoundary> : Details::BoolPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::SpeechServiceResponse_RequestSentenceBoundary> : Details::BoolPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::SpeechServiceResponse_SynthesisEventsSyncToAudio> : Details::BoolPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::SpeechServiceResponse_RecognitionLatencyMs> : Details::MillisecondsPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::SpeechServiceResponse_SynthesisFirstByteLatencyMs> : Details::MillisecondsPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::SpeechServiceResponse_SynthesisFinishLatencyMs> : Details::MillisecondsPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::SpeechServiceResponse_SynthesisUnderrunTimeMs> : Details::MillisecondsPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::SpeechServiceResponse_SynthesisConnectionLatencyMs> : Details::MillisecondsPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::SpeechServiceResponse_SynthesisNetworkLatencyMs> : Details::MillisecondsPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::SpeechServiceResponse_SynthesisServiceLatencyMs> : Details::MillisecondsPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::SpeechServiceResponse_DiarizeIntermediateResults> : Details::BoolPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::AudioConfig_PlaybackBufferLengthInMs> : Details::MillisecondsPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::Speech_SegmentationSilenceTimeoutMs> : Details::MillisecondsPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::Speech_SegmentationMaximumTimeMs> : Details::MillisecondsPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::Conversation_Request_Bot_Status_Messages> : Details::BoolPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::DataBuffer_TimeStamp> : Details::IntegerPropertyConverter<uint64_t> {};
+template <> struct PropertyTraits<PropertyId::PronunciationAssessment_EnableMiscue> : Details::BoolPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::PronunciationAssessment_NBestPhonemeCount> : Details::IntegerPropertyConverter<int32_t> {};
+template <> struct PropertyTraits<PropertyId::PronunciationAssessment_EnableProsodyAssessment> : Details::BoolPropertyConverter {};
+template <> struct PropertyTraits<PropertyId::EmbeddedSpeech_EnablePerformanceMetrics> : Details::BoolPropertyConverter {};
+
+namespace Details {
+
+    // Reads a typed property without copying its text; returns false if it is not defined or not valid.
+    template <PropertyId id>
+    inline bool GetTypedProperty(SPXPROPERTYBAGHANDLE propbag, typename PropertyTraits<id>::Type& value)
+    {
+        auto text = property_bag_get_string(propbag, static_cast<int>(id), nullptr, "");
+        if (text == nullptr)
+        {
+            return false;
+        }
+        auto parsed = PropertyTraits<id>::Parse(text, value);
+        property_bag_free_string(text);
+        return parsed;
+    }
+
+    // Sets a typed property, formatted on the stack; fails with SPXERR_INVALID_ARG if an integer is out of the range
+    // of the property.
+    template <PropertyId id, class T>
+    inline SPXHR SetTypedProperty(SPXPROPERTYBAGHANDLE propbag, const T& value)
+    {
+        using Type = typename PropertyTraits<id>::Type;
+        static_assert(IsPropertyValue<T, Type>::value, "The value does not have the type of the property.");
+        if (!IsInPropertyRange<Type>(value, std::integral_constant<bool, std::is_integral<Type>::value && !std::is_same<Type, bool>::value>()))
+        {
+            return SPXERR_INVALID_ARG;
+        }
+        char buffer[24];
+        auto text = PropertyTraits<id>::Format(static_cast<Type>(value), buffer, sizeof(buffer));
+        return property_bag_set_string(propbag, static_cast<int>(id), nullptr, text);
+    }
+
+}
+
+/*! \endcond */
+
+} } } // Microsoft::CognitiveServices::Speech
@@ -6,9 +6,17 @@
 //
 
 #pragma once
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
 #include <future>
 #include <memory>
+#include <mutex>
 #include "speechapi_cxx_common.h"
+#include "speechapi_cxx_async_executor.h"
+#include "speechapi_cxx_async_operation.h"
+#include "speechapi_cxx_cancellation_token.h"
 #include "speechapi_cxx_properties.h"
 #include "speechapi_cxx_eventsignal.h"
 #include "speechapi_cxx_recognizer.h"
@@ -62,6 +70,41 @@ public:
     /// <returns>An empty future.</returns>
     virtual std::future<void> StopKeywordRecognitionAsync() = 0;
 
+    /// <summary>
+    /// Performs recognition, as an operation that can be awaited with co_await.
+    /// Unlike <see cref="RecognizeOnceAsync"/>, no thread waits for the recognition: the operation is completed by the
+    /// recognized or canceled event of the recognition, and the awaiting coroutine is resumed on the default <see cref="AsyncExecutor"/>.
+    /// No other recognition may run on this recognizer until the operation completed.
+    /// </summary>
+    /// <returns>An awaitable operation representing the recognition. It returns a value of RecoResult as result.</returns>
+    AsyncOperation<std::shared_ptr<RecoResult>> RecognizeOnceAwaitable()
+    {
+        if (!m_awaitingCompletions.exchange(true))
+        {
+            recognizer_recognized_set_callback(m_hreco, AsyncRecognizer::FireEvent_Recognized, this);
+            recognizer_canceled_set_callback(m_hreco, AsyncRecognizer::FireEvent_Canceled, this);
+            recognizer_session_stopped_set_callback(m_hreco, AsyncRecognizer::FireEvent_SessionStopped, this);
+        }
+
+        auto awaitable = std::make_shared<PendingRecognition_Type>();
+        {
+            std::unique_lock<std::mutex> lock(m_awaitablesMutex);
+            m_pendingAwaitables.push_back(awaitable);
+        }
+
+        SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
+        auto hr = recognizer_recognize_once_async(m_hreco, &hasync);
+        if (SPX_FAILED(hr))
+        {
+            std::unique_lock<std::mutex> lock(m_awaitablesMutex);
+            m_pendingAwaitables.erase(std::remove(m_pendingAwaitables.begin(), m_pendingAwaitables.end(), awaitable), m_pendingAwaitables.end());
+        }
+        SPX_THROW_ON_FAIL(hr);
+        FinishAwaitable(awaitable, awaitable->SetHandle(hasync));
+
+        return AsyncOperation<std::shared_ptr<RecoResult>>(awaitable->GetState());
+    }
+
     /// <summary>
     /// Signal for events indicating the start of a recognition session (operation).
     /// </summary>
@@ -159,7 +202,7 @@ protected:
     std::future<std::shared_ptr<RecoResult>> RecognizeOnceAsyncInternal()
     {
         auto keepAlive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [keepAlive, this]() -> std::shared_ptr<RecoResult> {
+        auto future = Details::RunAsync([keepAlive, this]() -> std::shared_ptr<RecoResult> {
             SPX_INIT_HR(hr);
 
             SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
@@ -174,7 +217,7 @@ protected:
     std::future<void> StartContinuousRecognitionAsyncInternal()
     {
         auto keepAlive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [keepAlive, this]() -> void {
+        auto future = Details::RunAsync([keepAlive, this]() -> void {
             SPX_INIT_HR(hr);
             SPX_THROW_ON_FAIL(hr = recognizer_async_handle_release(m_hasyncStartContinuous)); // close any unfinished previous attempt
 
@@ -195,7 +238,7 @@ protected:
     std::future<void> StopContinuousRecognitionAsyncInternal()
     {
         auto keepAlive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [keepAlive, this]() -> void {
+        auto future = Details::RunAsync([keepAlive, this]() -> void {
             SPX_INIT_HR(hr);
             SPX_THROW_ON_FAIL(hr = recognizer_async_handle_release(m_hasyncStopContinuous)); // close any unfinished previous attempt
 
@@ -213,10 +256,113 @@ protected:
         return future;
     }
 
+    std::future<std::shared_ptr<RecoResult>> RecognizeOnceAsyncInternal(const CancellationToken& token)
+    {
+        auto keepAlive = this->shared_from_this();
+        auto future = Details::RunAsync([keepAlive, this, token]() -> std::shared_ptr<RecoResult> {
+            SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
+            SPX_THROW_ON_FAIL(recognizer_recognize_once_async(m_hreco, &hasync));
+
+            SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
+            auto hr = Details::WaitForAsync([hasync, &hresult](uint32_t milliseconds) {
+                return recognizer_recognize_once_async_wait_for(hasync, milliseconds, &hresult);
+            }, token);
+
+            auto expired = hr == SPXERR_TIMEOUT;
+            auto timedOut = expired && !token.IsCancellationRequested();
+            if (expired)
+            {
+                // The native library cannot stop a single-shot recognition; it ends at the latest after its segmentation
+                // or initial silence timeout. Give it the stop timeout, then leave it to end in the background.
+                hr = recognizer_recognize_once_async_wait_for(hasync, static_cast<uint32_t>(token.GetStopTimeout().count()), &hresult);
+                if (hr == SPXERR_TIMEOUT)
+                {
+                    Details::FinishInBackground([keepAlive, hasync]() {
+                        SPXRESULTHANDLE hlateResult = SPXHANDLE_INVALID;
+                        if (SPX_SUCCEEDED(recognizer_recognize_once_async_wait_for(hasync, UINT32_MAX, &hlateResult)))
+                        {
+                            SPX_REPORT_ON_FAIL(recognizer_result_handle_release(hlateResult));
+                        }
+                        SPX_REPORT_ON_FAIL(recognizer_async_handle_release(hasync));
+                    });
+                    SPX_THROW_HR(hr);
+                }
+            }
+
+            SPX_REPORT_ON_FAIL(recognizer_async_handle_release(hasync));
+            SPX_THROW_ON_FAIL(hr);
+
+            auto result = std::make_shared<RecoResult>(hresult);
+            auto& baseResult = static_cast<RecognitionResult&>(*result);
+            if (timedOut && (baseResult.m_reason == ResultReason::Canceled || baseResult.m_reason == ResultReason::NoMatch))
+            {
+                baseResult.m_reason = ResultReason::TimedOut;
+            }
+            return result;
+        });
+
+        return future;
+    }
+
+    std::future<void> StartContinuousRecognitionAsyncInternal(const CancellationToken& token)
+    {
+        auto keepAlive = this->shared_from_this();
+        auto future = Details::RunAsync([keepAlive, this, token]() -> void {
+            SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
+            SPX_THROW_ON_FAIL(recognizer_start_continuous_recognition_async(m_hreco, &hasync));
+
+            auto hr = Details::WaitForAsync([hasync](uint32_t milliseconds) {
+                return recognizer_start_continuous_recognition_async_wait_for(hasync, milliseconds);
+            }, token);
+            if (hr == SPXERR_TIMEOUT)
+            {
+                // Do not leave a recognition running that the caller was told did not start.
+                StopWithin(static_cast<uint32_t>(token.GetStopTimeout().count()));
+                Details::FinishInBackground([keepAlive, hasync]() {
+                    SPX_REPORT_ON_FAIL(recognizer_start_continuous_recognition_async_wait_for(hasync, UINT32_MAX));
+                    SPX_REPORT_ON_FAIL(recognizer_async_handle_release(hasync));
+                });
+                SPX_THROW_HR(hr);
+            }
+
+            SPX_REPORT_ON_FAIL(recognizer_async_handle_release(hasync));
+            SPX_THROW_ON_FAIL(hr);
+        });
+
+        return future;
+    }
+
+    std::future<void> StopContinuousRecognitionAsyncInternal(const CancellationToken& token)
+    {
+        auto keepAlive = this->shared_from_this();
+        auto future = Details::RunAsync([keepAlive, this, token]() -> void {
+            SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
+            SPX_THROW_ON_FAIL(recognizer_stop_continuous_recognition_async(m_hreco, &hasync));
+
+            auto hr = Details::WaitForAsync([hasync](uint32_t milliseconds) {
+                return recognizer_stop_continuous_recognition_async_wait_for(hasync, milliseconds);
+            }, token);
+            if (hr == SPXERR_TIMEOUT)
+            {
+                // The stop is still running; its handle may only be released once it ended.
+                Details::FinishInBackground([keepAlive, hasync]() {
+                    SPX_REPORT_ON_FAIL(recognizer_stop_continuous_recognition_async_wait_for(hasync, UINT32_MAX));
+                    SPX_REPORT_ON_FAIL(recognizer_async_handle_release(hasync));
+                });
+                SPX_THROW_HR(hr);
+            }
+
+            SPX_REPORT_ON_FAIL(recognizer_async_handle_release(hasync));
+            SPX_THROW_ON_FAIL(hr);
+        });
+
+        return future;
+    }
+
     std::future<void> StartKeywordRecognitionAsyncInternal(std::shared_ptr<KeywordRecognitionModel> model)
     {
         auto keepAlive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [keepAlive, model, this]() -> void {
+        auto future = Details::RunAsync([keepAlive, model, this]() -> void {
             SPX_INIT_HR(hr);
             SPX_THROW_ON_FAIL(hr = recognizer_async_handle_release(m_hasyncStartKeyword)); // close any unfinished previous attempt
 
@@ -238,7 +384,7 @@ protected:
     std::future<void> StopKeywordRecognitionAsyncInternal()
     {
         auto keepAlive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [keepAlive, this]() -> void {
+        auto future = Details::RunAsync([keepAlive, this]() -> void {
             SPX_INIT_HR(hr);
             SPX_THROW_ON_FAIL(hr = recognizer_async_handle_release(m_hasyncStopKeyword)); // close any unfinished previous attempt
 
@@ -269,7 +415,7 @@ protected:
             }
             else if (&recoEvent == &Recognized)
             {
-                recognizer_recognized_set_callback(m_hreco, Recognized.IsConnected() ? AsyncRecognizer::FireEvent_Recognized: nullptr, this);
+                recognizer_recognized_set_callback(m_hreco, Recognized.IsConnected() || m_awaitingCompletions ? AsyncRecognizer::FireEvent_Recognized: nullptr, this);
             }
         }
     }
@@ -283,7 +429,7 @@ protected:
 
             if (&recoEvent == &Canceled)
             {
-                recognizer_canceled_set_callback(m_hreco, Canceled.IsConnected() ? AsyncRecognizer::FireEvent_Canceled : nullptr, this);
+                recognizer_canceled_set_callback(m_hreco, Canceled.IsConnected() || m_awaitingCompletions ? AsyncRecognizer::FireEvent_Canceled : nullptr, this);
             }
         }
     }
@@ -319,7 +465,7 @@ protected:
             }
             else if (&sessionEvent == &SessionStopped)
             {
-                recognizer_session_stopped_set_callback(m_hreco, SessionStopped.IsConnected() ? AsyncRecognizer::FireEvent_SessionStopped : nullptr, this);
+                recognizer_session_stopped_set_callback(m_hreco, SessionStopped.IsConnected() || m_awaitingCompletions ? AsyncRecognizer::FireEvent_SessionStopped : nullptr, this);
             }
         }
     }
@@ -350,6 +496,8 @@ protected:
         // SessionEventArgs doesn't hold hevent, and thus can't release it properly ... release it here
         SPX_DBG_ASSERT(recognizer_event_handle_is_valid(hevent));
         recognizer_event_handle_release(hevent);
+
+        pThis->OnSessionStopped();
     }
 
     static void FireEvent_SpeechStartDetected(SPXRECOHANDLE hreco, SPXEVENTHANDLE hevent, void* pvContext)
@@ -397,6 +545,7 @@ protected:
 
         auto pThis = static_cast<AsyncRecognizer*>(pvContext);
         auto keepAlive = pThis->shared_from_this();
+        pThis->OnFinalResult(hevent);
         pThis->Recognized.Signal(*recoEvent.get());
     }
 
@@ -409,9 +558,79 @@ protected:
 
         auto pThis = static_cast<AsyncRecognizer*>(pvContext);
         auto keepAlive = pThis->shared_from_this();
+        pThis->OnFinalResult(hevent);
         pThis->Canceled.Signal(*ptr);
     }
 
+    using PendingRecognition_Type = Details::EventCompletedOperation<std::shared_ptr<RecoResult>>;
+
+    // The final result of a single-shot recognition, recognized or canceled, completes the oldest awaitable one.
+    void OnFinalResult(SPXEVENTHANDLE hevent)
+    {
+        std::shared_ptr<PendingRecognition_Type> awaitable;
+        {
+            std::unique_lock<std::mutex> lock(m_awaitablesMutex);
+            if (!m_pendingAwaitables.empty())
+            {
+                awaitable = m_pendingAwaitables.front();
+            }
+        }
+
+        if (awaitable != nullptr)
+        {
+            awaitable->Complete([hevent]() {
+                SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
+                SPX_THROW_ON_FAIL(recognizer_recognition_event_get_result(hevent, &hresult));
+                return std::shared_ptr<RecoResult>(new RecoResult(hresult));
+            });
+        }
+    }
+
+    // Each single-shot recognition ends its session after its final result.
+    void OnSessionStopped()
+    {
+        std::shared_ptr<PendingRecognition_Type> awaitable;
+        {
+            std::unique_lock<std::mutex> lock(m_awaitablesMutex);
+            if (!m_pendingAwaitables.empty())
+            {
+                awaitable = m_pendingAwaitables.front();
+                m_pendingAwaitables.pop_front();
+            }
+        }
+
+        if (awaitable != nullptr)
+        {
+            FinishAwaitable(awaitable, awaitable->End());
+        }
+    }
+
+    // Releases the handle of an awaitable recognition that ended. The native operation returns around the end of its
+    // session, so the wait is short; if no final result event was raised, the operation is completed from the wait instead.
+    void FinishAwaitable(std::shared_ptr<PendingRecognition_Type> awaitable, SPXASYNCHANDLE hasync)
+    {
+        if (hasync == SPXHANDLE_INVALID)
+        {
+            return;
+        }
+
+        auto keepAlive = this->shared_from_this();
+        Details::FinishInBackground([keepAlive, awaitable, hasync]() {
+            SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
+            auto hr = recognizer_recognize_once_async_wait_for(hasync, UINT32_MAX, &hresult);
+            SPX_REPORT_ON_FAIL(recognizer_async_handle_release(hasync));
+
+            auto completed = awaitable->Complete([hr, hresult]() {
+                SPX_THROW_ON_FAIL(hr);
+                return std::shared_ptr<RecoResult>(new RecoResult(hresult));
+            });
+            if (!completed && SPX_SUCCEEDED(hr))
+            {
+                SPX_REPORT_ON_FAIL(recognizer_result_handle_release(hresult));
+            }
+        });
+    }
+
     class PrivatePropertyCollection : public PropertyCollection
     {
     public:
@@ -434,6 +653,11 @@ protected:
     SPXASYNCHANDLE m_hasyncStartKeyword;
     SPXASYNCHANDLE m_hasyncStopKeyword;
 
+    // The operations returned by RecognizeOnceAwaitable(), oldest first; the callbacks completing them stay set once one was started.
+    std::mutex m_awaitablesMutex;
+    std::deque<std::shared_ptr<PendingRecognition_Type>> m_pendingAwaitables;
+    std::atomic<bool> m_awaitingCompletions{ false };
+
     template <typename Handle, typename Config>
     static Handle HandleOrInvalid(std::shared_ptr<Config> audioInput)
     {
@@ -467,6 +691,27 @@ private:
     {
         return [=](const EventSignal<const RecognitionEventArgs&>& recoEvent) { this->RecognitionEventConnectionsChanged(recoEvent); };
     }
+
+    // Stops the recognition after a token expired; bounded, since the caller is already late.
+    void StopWithin(uint32_t milliseconds)
+    {
+        SPXASYNCHANDLE hasyncStop = SPXHANDLE_INVALID;
+        if (SPX_SUCCEEDED(recognizer_stop_continuous_recognition_async(m_hreco, &hasyncStop)))
+        {
+            auto hr = recognizer_stop_continuous_recognition_async_wait_for(hasyncStop, milliseconds);
+            if (hr == SPXERR_TIMEOUT)
+            {
+                auto keepAlive = this->shared_from_this();
+                Details::FinishInBackground([keepAlive, hasyncStop]() {
+                    SPX_REPORT_ON_FAIL(recognizer_stop_continuous_recognition_async_wait_for(hasyncStop, UINT32_MAX));
+                    SPX_REPORT_ON_FAIL(recognizer_async_handle_release(hasyncStop));
+                });
+                return;
+            }
+            SPX_REPORT_ON_FAIL(hr);
+            SPX_REPORT_ON_FAIL(recognizer_async_handle_release(hasyncStop));
+        }
+    }
 };
 
 
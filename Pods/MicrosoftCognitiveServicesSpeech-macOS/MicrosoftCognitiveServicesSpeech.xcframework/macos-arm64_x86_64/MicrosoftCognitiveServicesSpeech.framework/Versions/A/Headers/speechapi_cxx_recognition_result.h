@@ -25,6 +25,8 @@ namespace Speech {
 /// </summary>
 class RecognitionResult
 {
+    template <class RecoResult, class RecoEventArgs, class RecoCanceledEventArgs>
+    friend class AsyncRecognizer;
 private:
 
     /*! \cond PRIVATE */
@@ -40,6 +42,8 @@ private:
                 return hpropbag;
             }())
         {
+            // Results do not change once received.
+            EnableReadCache();
         }
     };
 
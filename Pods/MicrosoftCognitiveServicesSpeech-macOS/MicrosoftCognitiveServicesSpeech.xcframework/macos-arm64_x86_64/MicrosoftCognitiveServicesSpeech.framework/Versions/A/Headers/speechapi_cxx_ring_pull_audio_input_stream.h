@@ -0,0 +1,269 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_ring_pull_audio_input_stream.h: Public API declarations for RingPullAudioInputStream C++ class
+//
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "speechapi_cxx_common.h"
+#include "speechapi_cxx_audio_stream_format.h"
+#include "speechapi_cxx_audio_stream.h"
+#include "speechapi_cxx_audio_ring_buffer.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+namespace Audio {
+
+/// <summary>
+/// Options of a <see cref="RingPullAudioInputStream"/>.
+/// </summary>
+struct RingPullAudioInputStreamOptions
+{
+    /// <summary>
+    /// Capacity of the ring in bytes, rounded up to a power of two.
+    /// </summary>
+    size_t Capacity = 1024 * 1024;
+
+    /// <summary>
+    /// How long a read waits for audio while the ring is empty. A read that times out returns 0, which ends the stream
+    /// for the recognizer; the default waits until audio arrives or the stream is closed.
+    /// </summary>
+    std::chrono::milliseconds ReadTimeout{ std::chrono::milliseconds::max() };
+};
+
+/// <summary>
+/// Counters of a <see cref="RingPullAudioInputStream"/>.
+/// </summary>
+struct RingPullAudioInputStreamMetrics
+{
+    /// <summary>
+    /// Number of bytes written by the producer and stored.
+    /// </summary>
+    uint64_t WrittenBytes = 0;
+
+    /// <summary>
+    /// Number of bytes read by the recognizer.
+    /// </summary>
+    uint64_t ReadBytes = 0;
+
+    /// <summary>
+    /// Number of writes that did not fit completely because the ring was full.
+    /// </summary>
+    uint64_t Overruns = 0;
+
+    /// <summary>
+    /// Number of bytes dropped because the ring was full.
+    /// </summary>
+    uint64_t DroppedBytes = 0;
+
+    /// <summary>
+    /// Number of reads that found the ring empty and had to wait.
+    /// </summary>
+    uint64_t Underruns = 0;
+
+    /// <summary>
+    /// Number of reads that returned 0 because no audio arrived within the read timeout.
+    /// </summary>
+    uint64_t Timeouts = 0;
+};
+
+/// <summary>
+/// A pull audio input stream fed by a producer, typically a capture thread, through a fixed-size lock-free ring.
+/// </summary>
+/// <remarks>
+/// <see cref="Write"/> never blocks nor allocates; audio that does not fit in the ring is dropped and counted as an
+/// overrun. The recognizer's reads return the audio available, possibly less than requested, and only wait, on a
+/// condition variable, while the ring is empty. Reads call into the ring directly, without a callback object.
+/// There must be a single producer thread.
+/// </remarks>
+class RingPullAudioInputStream : public PullAudioInputStream
+{
+public:
+
+    /// <summary>
+    /// Creates a stream of the given format.
+    /// </summary>
+    /// <param name="format">The format of the audio, the default input format if nullptr.</param>
+    /// <param name="options">The options of the stream.</param>
+    /// <returns>A shared pointer to the stream, to pass to <see cref="AudioConfig::FromStreamInput"/>.</returns>
+    static std::shared_ptr<RingPullAudioInputStream> Create(std::shared_ptr<AudioStreamFormat> format = nullptr, const RingPullAudioInputStreamOptions& options = RingPullAudioInputStreamOptions())
+    {
+        format = UseDefaultFormatIfNull(format);
+
+        SPXAUDIOSTREAMHANDLE haudioStream = SPXHANDLE_INVALID;
+        SPX_THROW_ON_FAIL(audio_stream_create_pull_audio_input_stream(&haudioStream, GetFormatHandle(format)));
+
+        auto stream = new RingPullAudioInputStream(haudioStream, options);
+        std::shared_ptr<RingPullAudioInputStream> ptr(stream);
+        SPX_THROW_ON_FAIL(pull_audio_input_stream_set_callbacks(haudioStream, stream, ReadCallbackWrapper, CloseCallbackWrapper));
+        return ptr;
+    }
+
+    /// <summary>
+    /// Stores audio in the ring. Must be called from one thread at a time.
+    /// </summary>
+    /// <param name="dataBuffer">The audio data.</param>
+    /// <param name="size">The size of the audio data in bytes.</param>
+    /// <returns>The number of bytes stored; the others were dropped.</returns>
+    size_t Write(const uint8_t* dataBuffer, size_t size)
+    {
+        if (m_closed.load(std::memory_order_acquire))
+        {
+            return 0;
+        }
+        auto written = m_ring.Write(dataBuffer, size);
+        m_writtenBytes.fetch_add(written, std::memory_order_relaxed);
+        if (written < size)
+        {
+            m_overruns.fetch_add(1, std::memory_order_relaxed);
+            m_droppedBytes.fetch_add(size - written, std::memory_order_relaxed);
+        }
+        WakeReader();
+        return written;
+    }
+
+    /// <summary>
+    /// Marks the end of the audio. The recognizer reads the audio left in the ring, then gets the end of the stream.
+    /// </summary>
+    void Close()
+    {
+        m_closed.store(true, std::memory_order_release);
+        WakeReader();
+    }
+
+    /// <summary>
+    /// Gets the number of bytes waiting to be read.
+    /// </summary>
+    /// <returns>The number of bytes.</returns>
+    size_t GetAvailable() const
+    {
+        return m_ring.GetAvailable();
+    }
+
+    /// <summary>
+    /// Gets the capacity of the ring.
+    /// </summary>
+    /// <returns>The capacity in bytes.</returns>
+    size_t GetCapacity() const
+    {
+        return m_ring.GetCapacity();
+    }
+
+    /// <summary>
+    /// Gets the counters of the stream.
+    /// </summary>
+    /// <returns>A copy of the counters.</returns>
+    RingPullAudioInputStreamMetrics GetMetrics() const
+    {
+        RingPullAudioInputStreamMetrics metrics;
+        metrics.WrittenBytes = m_writtenBytes.load(std::memory_order_relaxed);
+        metrics.ReadBytes = m_readBytes.load(std::memory_order_relaxed);
+        metrics.Overruns = m_overruns.load(std::memory_order_relaxed);
+        metrics.DroppedBytes = m_droppedBytes.load(std::memory_order_relaxed);
+        metrics.Underruns = m_underruns.load(std::memory_order_relaxed);
+        metrics.Timeouts = m_timeouts.load(std::memory_order_relaxed);
+        return metrics;
+    }
+
+protected:
+
+    /*! \cond PROTECTED */
+
+    /// <summary>
+    /// Internal constructor. Creates a new instance using the provided handle.
+    /// </summary>
+    RingPullAudioInputStream(SPXAUDIOSTREAMHANDLE haudioStream, const RingPullAudioInputStreamOptions& options) :
+        PullAudioInputStream(haudioStream),
+        m_ring(options.Capacity),
+        m_readTimeout(options.ReadTimeout)
+    {
+    }
+
+    /*! \endcond */
+
+private:
+
+    DISABLE_COPY_AND_MOVE(RingPullAudioInputStream);
+
+    static int ReadCallbackWrapper(void* pvContext, uint8_t* dataBuffer, uint32_t size)
+    {
+        return static_cast<int>(static_cast<RingPullAudioInputStream*>(pvContext)->Read(dataBuffer, size));
+    }
+
+    static void CloseCallbackWrapper(void* pvContext)
+    {
+        static_cast<RingPullAudioInputStream*>(pvContext)->Close();
+    }
+
+    size_t Read(uint8_t* dataBuffer, size_t size)
+    {
+        auto read = m_ring.Read(dataBuffer, size);
+        if (read == 0 && size > 0 && !m_closed.load(std::memory_order_acquire))
+        {
+            m_underruns.fetch_add(1, std::memory_order_relaxed);
+            if (!WaitForAudio())
+            {
+                m_timeouts.fetch_add(1, std::memory_order_relaxed);
+            }
+            read = m_ring.Read(dataBuffer, size);
+        }
+        m_readBytes.fetch_add(read, std::memory_order_relaxed);
+        return read;
+    }
+
+    // The reader announces that it waits before checking the ring, and the writer checks for a waiting reader after
+    // filling it; the fences on both sides ensure that one of them sees the other, so the writer only takes the
+    // mutex when a reader waits.
+    bool WaitForAudio()
+    {
+        auto ready = [this]() { return m_ring.GetAvailable() > 0 || m_closed.load(std::memory_order_acquire); };
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_readerWaiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto result = true;
+        if (m_readTimeout == std::chrono::milliseconds::max())
+        {
+            m_audioAvailable.wait(lock, ready);
+        }
+        else
+        {
+            result = m_audioAvailable.wait_for(lock, m_readTimeout, ready);
+        }
+        m_readerWaiting.store(false, std::memory_order_relaxed);
+        return result;
+    }
+
+    void WakeReader()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_readerWaiting.load(std::memory_order_relaxed))
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_audioAvailable.notify_one();
+        }
+    }
+
+    Speech::Details::AudioRingBuffer m_ring;
+    const std::chrono::milliseconds m_readTimeout;
+    std::atomic<bool> m_closed{ false };
+    std::atomic<bool> m_readerWaiting{ false };
+    std::mutex m_mutex;
+    std::condition_variable m_audioAvailable;
+    std::atomic<uint64_t> m_writtenBytes{ 0 };
+    std::atomic<uint64_t> m_readBytes{ 0 };
+    std::atomic<uint64_t> m_overruns{ 0 };
+    std::atomic<uint64_t> m_droppedBytes{ 0 };
+    std::atomic<uint64_t> m_underruns{ 0 };
+    std::atomic<uint64_t> m_timeouts{ 0 };
+};
+
+} } } } // Microsoft::CognitiveServices::Speech::Audio
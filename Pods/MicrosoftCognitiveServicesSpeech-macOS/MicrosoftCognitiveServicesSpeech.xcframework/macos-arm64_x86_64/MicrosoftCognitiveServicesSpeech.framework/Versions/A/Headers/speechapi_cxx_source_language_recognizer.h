@@ -112,6 +112,38 @@ public:
         return BaseType::StopContinuousRecognitionAsyncInternal();
     }
 
+    /// <summary>
+    /// Performs speech recognition on a single utterance, asynchronously, until the given token expires.
+    /// A single-shot recognition cannot be stopped; on expiry it is given the stop timeout to end, see <see cref="CancellationToken"/>.
+    /// </summary>
+    /// <param name="token">The token bounding the wait.</param>
+    /// <returns>Future containing result value of the asynchronous recognition.</returns>
+    std::future<std::shared_ptr<SpeechRecognitionResult>> RecognizeOnceAsync(const CancellationToken& token)
+    {
+        return BaseType::RecognizeOnceAsyncInternal(token);
+    }
+
+    /// <summary>
+    /// Asynchronously initiates continuous speech recognition, until the given token expires.
+    /// If the token expires before the recognition started, it is stopped again.
+    /// </summary>
+    /// <param name="token">The token bounding the wait.</param>
+    /// <returns>An empty future. It throws an exception with SPXERR_TIMEOUT if the token expires first.</returns>
+    std::future<void> StartContinuousRecognitionAsync(const CancellationToken& token)
+    {
+        return BaseType::StartContinuousRecognitionAsyncInternal(token);
+    }
+
+    /// <summary>
+    /// Asynchronously terminates ongoing continuous speech recognition, until the given token expires.
+    /// </summary>
+    /// <param name="token">The token bounding the wait.</param>
+    /// <returns>An empty future. It throws an exception with SPXERR_TIMEOUT if the token expires first.</returns>
+    std::future<void> StopContinuousRecognitionAsync(const CancellationToken& token)
+    {
+        return BaseType::StopContinuousRecognitionAsyncInternal(token);
+    }
+
     /// <summary>
     /// Asynchronously initiates keyword recognition operation.
     /// </summary>
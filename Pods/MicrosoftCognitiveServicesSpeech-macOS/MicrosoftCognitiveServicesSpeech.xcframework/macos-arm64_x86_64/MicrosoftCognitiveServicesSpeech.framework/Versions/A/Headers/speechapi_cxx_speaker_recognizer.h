@@ -9,6 +9,7 @@
 #include <string>
 #include <future>
 #include "speechapi_cxx_common.h"
+#include "speechapi_cxx_async_executor.h"
 
 #include "speechapi_c.h"
 #include "speechapi_cxx_properties.h"
@@ -121,7 +122,7 @@ private:
     inline std::future<std::shared_ptr<SpeakerRecognitionResult>> RunAsync(std::function<SPXHR(SPXSPEAKERIDHANDLE, SpeakerModelHandleType, SPXRESULTHANDLE*)> func, std::shared_ptr<SpeakerModelPtrType> model)
     {
         auto keepalive = this->shared_from_this();
-        return std::async(std::launch::async, [keepalive, this, func, model]()
+        return Details::RunAsync([keepalive, this, func, model]()
             {
                 SPXRESULTHANDLE hResultHandle = SPXHANDLE_INVALID;
                 SPX_THROW_ON_FAIL(func(m_hSpeakerRecognizer, (SpeakerModelHandleType)(*model), &hResultHandle));
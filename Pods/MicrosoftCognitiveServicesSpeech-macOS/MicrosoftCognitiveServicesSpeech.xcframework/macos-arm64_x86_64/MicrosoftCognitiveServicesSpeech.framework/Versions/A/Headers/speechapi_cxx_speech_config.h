@@ -9,6 +9,7 @@
 #include <string>
 
 #include "speechapi_cxx_properties.h"
+#include "speechapi_cxx_property_traits.h"
 #include "speechapi_cxx_string_helpers.h"
 #include "speechapi_c_common.h"
 #include "speechapi_c_speech_config.h"
@@ -308,8 +309,7 @@ public:
     /// <returns>Speech recognition output format.</returns>
     OutputFormat GetOutputFormat() const
     {
-        auto result = GetProperty(PropertyId::SpeechServiceResponse_RequestDetailedResultTrueFalse);
-        return result == Utils::ToSPXString(TrueString) ? OutputFormat::Detailed : OutputFormat::Simple;
+        return Get<PropertyId::SpeechServiceResponse_RequestDetailedResultTrueFalse>() ? OutputFormat::Detailed : OutputFormat::Simple;
     }
 
     /// <summary>
@@ -319,8 +319,8 @@ public:
     /// <param name="format">Speech recognition output format</param>
     void SetOutputFormat(OutputFormat format)
     {
-        property_bag_set_string(m_propertybag, static_cast<int>(PropertyId::SpeechServiceResponse_RequestDetailedResultTrueFalse), nullptr,
-            format == OutputFormat::Detailed ? Utils::ToUTF8(TrueString) : Utils::ToUTF8(FalseString));
+        auto hr = Details::SetTypedProperty<PropertyId::SpeechServiceResponse_RequestDetailedResultTrueFalse>(m_propertybag, format == OutputFormat::Detailed);
+        SPX_REPORT_ON_FAIL(hr);
     }
 
     /// <summary>
@@ -343,7 +343,8 @@ public:
     /// </remarks>
     void EnableAudioLogging()
     {
-        property_bag_set_string(m_propertybag, static_cast<int>(PropertyId::SpeechServiceConnection_EnableAudioLogging), nullptr, TrueString);
+        auto hr = Details::SetTypedProperty<PropertyId::SpeechServiceConnection_EnableAudioLogging>(m_propertybag, true);
+        SPX_REPORT_ON_FAIL(hr);
     }
 
     /// <summary>
@@ -352,7 +353,8 @@ public:
     /// </summary>
     void RequestWordLevelTimestamps()
     {
-        property_bag_set_string(m_propertybag, static_cast<int>(PropertyId::SpeechServiceResponse_RequestWordLevelTimestamps), nullptr, TrueString);
+        auto hr = Details::SetTypedProperty<PropertyId::SpeechServiceResponse_RequestWordLevelTimestamps>(m_propertybag, true);
+        SPX_REPORT_ON_FAIL(hr);
     }
 
     /// <summary>
@@ -381,8 +383,8 @@ public:
 
         property_bag_set_string(m_propertybag, static_cast<int>(PropertyId::SpeechServiceConnection_ProxyHostName), nullptr,
             Utils::ToUTF8(proxyHostName).c_str());
-        property_bag_set_string(m_propertybag, static_cast<int>(PropertyId::SpeechServiceConnection_ProxyPort), nullptr,
-            std::to_string(proxyPort).c_str());
+        auto hr = Details::SetTypedProperty<PropertyId::SpeechServiceConnection_ProxyPort>(m_propertybag, proxyPort);
+        SPX_REPORT_ON_FAIL(hr);
         if (!proxyUserName.empty())
         {
             property_bag_set_string(m_propertybag, static_cast<int>(PropertyId::SpeechServiceConnection_ProxyUserName), nullptr,
@@ -437,6 +439,29 @@ public:
         property_bag_set_string(m_propertybag, static_cast<int>(id), nullptr, Utils::ToUTF8(value).c_str());
     }
 
+    /// <summary>
+    /// Gets a property value by ID, in its native type, see <see cref="PropertyTraits"/>.
+    /// </summary>
+    /// <param name="defaultValue">The value returned if the property is not defined or not valid.</param>
+    /// <returns>The property value.</returns>
+    template <PropertyId id>
+    typename PropertyTraits<id>::Type Get(typename PropertyTraits<id>::Type defaultValue = typename PropertyTraits<id>::Type()) const
+    {
+        auto value = defaultValue;
+        Details::GetTypedProperty<id>(m_propertybag, value);
+        return value;
+    }
+
+    /// <summary>
+    /// Sets a property value by ID, from a value of its native type, see <see cref="PropertyTraits"/>.
+    /// </summary>
+    /// <param name="value">The property value; an integer out of the range of the property throws.</param>
+    template <PropertyId id, class T>
+    void Set(const T& value)
+    {
+        SPX_THROW_ON_FAIL(Details::SetTypedProperty<id>(m_propertybag, value));
+    }
+
     /// <summary>
     /// Sets a property value that will be passed to service using the specified channel.
     /// Added in version 1.5.0.
@@ -0,0 +1,266 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_speech_synthesis_batch_eventargs.h: Public API declarations for batched word boundary and viseme event arguments
+//
+
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+#include "speechapi_cxx_common.h"
+#include "speechapi_cxx_enums.h"
+#include "speechapi_cxx_eventargs.h"
+#include "speechapi_cxx_eventsignal.h"
+#include "speechapi_c_synthesizer.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+
+/// <summary>
+/// A single word boundary, as delivered in a <see cref="SpeechSynthesisWordBoundaryBatchEventArgs"/>.
+/// </summary>
+struct SpeechSynthesisWordBoundaryEntry
+{
+    /// <summary>
+    /// Audio offset, in ticks (100 nanoseconds).
+    /// </summary>
+    uint64_t AudioOffset;
+
+    /// <summary>
+    /// Duration of the audio, in ticks (100 nanoseconds).
+    /// </summary>
+    uint64_t Duration;
+
+    /// <summary>
+    /// Text offset.
+    /// </summary>
+    uint32_t TextOffset;
+
+    /// <summary>
+    /// Word length.
+    /// </summary>
+    uint32_t WordLength;
+
+    /// <summary>
+    /// Boundary type.
+    /// </summary>
+    SpeechSynthesisBoundaryType BoundaryType;
+};
+
+/// <summary>
+/// A single viseme, as delivered in a <see cref="SpeechSynthesisVisemeBatchEventArgs"/>.
+/// </summary>
+struct SpeechSynthesisVisemeEntry
+{
+    /// <summary>
+    /// Audio offset, in ticks (100 nanoseconds).
+    /// </summary>
+    uint64_t AudioOffset;
+
+    /// <summary>
+    /// Viseme ID.
+    /// </summary>
+    uint32_t VisemeId;
+};
+
+static_assert(std::is_trivially_copyable<SpeechSynthesisWordBoundaryEntry>::value, "word boundary entries must be trivially copyable");
+static_assert(std::is_trivially_copyable<SpeechSynthesisVisemeEntry>::value, "viseme entries must be trivially copyable");
+
+/// <summary>
+/// Controls when batched events are delivered, see <see cref="SpeechSynthesizer::SetEventBatchOptions"/>.
+/// </summary>
+struct SpeechSynthesisEventBatchOptions
+{
+    /// <summary>
+    /// A batch is delivered once it holds this many entries.
+    /// </summary>
+    uint32_t MaxEvents = 64;
+
+    /// <summary>
+    /// A batch is delivered once its first entry is this old. The age is checked when any word boundary, viseme or
+    /// audio event of the synthesizer arrives, so it is not delivered by a timer; pending entries are always delivered
+    /// when the synthesis completes or is canceled.
+    /// </summary>
+    std::chrono::milliseconds MaxDelay{ 100 };
+};
+
+/// <summary>
+/// Class for batched speech synthesis event arguments. The entries are contiguous and only valid for the duration of the callback.
+/// </summary>
+template <class TEntry>
+class SpeechSynthesisBatchEventArgs : public EventArgs
+{
+public:
+
+    /// <summary>
+    /// Constructor.
+    /// </summary>
+    /// <param name="entries">Pointer to the first entry.</param>
+    /// <param name="count">Number of entries.</param>
+    SpeechSynthesisBatchEventArgs(const TEntry* entries, size_t count) :
+        m_entries(entries),
+        m_count(count)
+    {
+    }
+
+    /// <summary>
+    /// Pointer to the first entry of the batch.
+    /// </summary>
+    /// <returns>The entries.</returns>
+    const TEntry* Data() const { return m_entries; }
+
+    /// <summary>
+    /// Number of entries in the batch.
+    /// </summary>
+    /// <returns>The entry count.</returns>
+    size_t Size() const { return m_count; }
+
+    /// <summary>
+    /// Iterator to the first entry.
+    /// </summary>
+    const TEntry* begin() const { return m_entries; }
+
+    /// <summary>
+    /// Iterator past the last entry.
+    /// </summary>
+    const TEntry* end() const { return m_entries + m_count; }
+
+    /// <summary>
+    /// Accesses an entry by index.
+    /// </summary>
+    const TEntry& operator[](size_t index) const { return m_entries[index]; }
+
+private:
+
+    DISABLE_DEFAULT_CTORS(SpeechSynthesisBatchEventArgs);
+
+    const TEntry* m_entries;
+    size_t m_count;
+};
+
+/// <summary>
+/// Batched speech synthesis word boundary event arguments.
+/// </summary>
+using SpeechSynthesisWordBoundaryBatchEventArgs = SpeechSynthesisBatchEventArgs<SpeechSynthesisWordBoundaryEntry>;
+
+/// <summary>
+/// Batched speech synthesis viseme event arguments.
+/// </summary>
+using SpeechSynthesisVisemeBatchEventArgs = SpeechSynthesisBatchEventArgs<SpeechSynthesisVisemeEntry>;
+
+/*! \cond PRIVATE */
+
+/// <summary>
+/// Accumulates entries into a reusable buffer and signals them as one batch.
+/// </summary>
+template <class TEntry>
+class SpeechSynthesisEventBatcher
+{
+public:
+
+    using Signal_Type = EventSignal<const SpeechSynthesisBatchEventArgs<TEntry>&>;
+
+    explicit SpeechSynthesisEventBatcher(Signal_Type& signal) :
+        m_signal(signal)
+    {
+        m_entries.reserve(m_options.MaxEvents);
+    }
+
+    void SetOptions(const SpeechSynthesisEventBatchOptions& options)
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, options.MaxEvents == 0);
+
+        std::unique_lock<std::recursive_mutex> lock(m_mutex);
+        FlushLocked();
+        m_options = options;
+        if (!m_flushing)
+        {
+            m_entries.reserve(m_options.MaxEvents);
+        }
+    }
+
+    void Append(const TEntry& entry)
+    {
+        auto now = std::chrono::steady_clock::now();
+
+        std::unique_lock<std::recursive_mutex> lock(m_mutex);
+        if (m_entries.empty())
+        {
+            m_firstEntryTime = now;
+        }
+        m_entries.push_back(entry);
+
+        if (m_entries.size() >= m_options.MaxEvents || now - m_firstEntryTime >= m_options.MaxDelay)
+        {
+            FlushLocked();
+        }
+    }
+
+    void Flush()
+    {
+        std::unique_lock<std::recursive_mutex> lock(m_mutex);
+        FlushLocked();
+    }
+
+    // Delivers the pending entries if the first of them is older than MaxDelay.
+    void FlushIfDue()
+    {
+        std::unique_lock<std::recursive_mutex> lock(m_mutex);
+        if (!m_entries.empty() && std::chrono::steady_clock::now() - m_firstEntryTime >= m_options.MaxDelay)
+        {
+            FlushLocked();
+        }
+    }
+
+    void Reset()
+    {
+        std::unique_lock<std::recursive_mutex> lock(m_mutex);
+        m_entries.clear();
+    }
+
+private:
+
+    DISABLE_COPY_AND_MOVE(SpeechSynthesisEventBatcher);
+
+    // The callbacks run with m_mutex held, so the buffer can be reused without copying it. The mutex is recursive
+    // so callbacks can disconnect or change options; clearing the buffer keeps its storage, so the batch stays valid.
+    void FlushLocked()
+    {
+        if (m_entries.empty() || m_flushing)
+        {
+            return;
+        }
+
+        SpeechSynthesisBatchEventArgs<TEntry> batch(m_entries.data(), m_entries.size());
+        m_flushing = true;
+        try
+        {
+            m_signal.Signal(batch);
+        }
+        catch (...)
+        {
+            m_flushing = false;
+            m_entries.clear();
+            throw;
+        }
+        m_flushing = false;
+        m_entries.clear();
+    }
+
+    Signal_Type& m_signal;
+    std::recursive_mutex m_mutex;
+    bool m_flushing = false;
+    SpeechSynthesisEventBatchOptions m_options;
+    std::vector<TEntry> m_entries;
+    std::chrono::steady_clock::time_point m_firstEntryTime;
+};
+
+/*! \endcond */
+
+} } } // Microsoft::CognitiveServices::Speech
@@ -0,0 +1,1313 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_speech_synthesis_cache.h: Public API declarations for SpeechSynthesisCache and related C++ classes
+//
+
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "speechapi_cxx_common.h"
+#include "speechapi_cxx_enums.h"
+#include "speechapi_cxx_string_helpers.h"
+#include "speechapi_cxx_speech_synthesizer.h"
+#include "speechapi_cxx_parallel_speech_synthesizer.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+
+/// <summary>
+/// Options of a <see cref="SpeechSynthesisCache"/>.
+/// </summary>
+struct SpeechSynthesisCacheOptions
+{
+    /// <summary>
+    /// Maximum size of the segment files holding the entries. The least recently used entries are evicted beyond it.
+    /// While a segment file is compacted, the files exceed it by the size of the entries being moved.
+    /// </summary>
+    uint64_t MaxSizeInBytes = 1ull << 30;
+
+    /// <summary>
+    /// Size at which a new segment file is started. Space of evicted entries is reclaimed a segment file at a time.
+    /// </summary>
+    uint64_t SegmentFileSize = 64ull << 20;
+};
+
+/// <summary>
+/// Counters of a <see cref="SpeechSynthesisCache"/>.
+/// </summary>
+struct SpeechSynthesisCacheMetrics
+{
+    /// <summary>
+    /// Number of lookups that found an entry.
+    /// </summary>
+    uint64_t Hits = 0;
+
+    /// <summary>
+    /// Number of lookups that found no entry.
+    /// </summary>
+    uint64_t Misses = 0;
+
+    /// <summary>
+    /// Number of entries added.
+    /// </summary>
+    uint64_t Additions = 0;
+
+    /// <summary>
+    /// Number of entries evicted to stay within <see cref="SpeechSynthesisCacheOptions::MaxSizeInBytes"/>.
+    /// </summary>
+    uint64_t Evictions = 0;
+
+    /// <summary>
+    /// Number of entries.
+    /// </summary>
+    size_t Entries = 0;
+
+    /// <summary>
+    /// Size of the entries.
+    /// </summary>
+    uint64_t EntriesSizeInBytes = 0;
+
+    /// <summary>
+    /// Size of the segment files, including the space of removed entries not reclaimed yet.
+    /// </summary>
+    uint64_t SizeInBytes = 0;
+
+    /// <summary>
+    /// Gets the share of lookups that found an entry.
+    /// </summary>
+    /// <returns>The ratio, between 0 and 1.</returns>
+    double GetHitRatio() const
+    {
+        auto lookups = Hits + Misses;
+        return lookups == 0 ? 0.0 : static_cast<double>(Hits) / static_cast<double>(lookups);
+    }
+};
+
+/*! \cond PRIVATE */
+
+namespace Details {
+
+    inline uint32_t Crc32(const uint8_t* data, size_t size)
+    {
+        uint32_t crc = 0xffffffff;
+        for (size_t i = 0; i < size; i++)
+        {
+            crc ^= data[i];
+            for (int bit = 0; bit < 8; bit++)
+            {
+                crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+            }
+        }
+        return ~crc;
+    }
+
+    // An open cache file. It stays open while entries are read from it, so that it can be mapped after being deleted.
+    class CacheFile
+    {
+    public:
+
+        CacheFile(std::string path, int flags) :
+            path(std::move(path))
+        {
+            do
+            {
+                fd = ::open(this->path.c_str(), flags | O_CLOEXEC, 0644);
+            } while (fd < 0 && errno == EINTR);
+            SPX_THROW_HR_IF(SPXERR_FILE_OPEN_FAILED, fd < 0);
+        }
+
+        ~CacheFile()
+        {
+            ::close(fd);
+        }
+
+        uint64_t GetSize() const
+        {
+            struct stat st;
+            SPX_THROW_HR_IF(SPXERR_RUNTIME_ERROR, ::fstat(fd, &st) != 0);
+            return static_cast<uint64_t>(st.st_size);
+        }
+
+        void Write(const uint8_t* data, size_t size)
+        {
+            while (size > 0)
+            {
+                auto written = ::write(fd, data, size);
+                if (written < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                SPX_THROW_HR_IF(SPXERR_RUNTIME_ERROR, written <= 0);
+                data += written;
+                size -= static_cast<size_t>(written);
+            }
+        }
+
+        // Writes at the given offset, without moving the file position; used by writers that reserved the range.
+        void WriteAt(uint64_t offset, const uint8_t* data, size_t size)
+        {
+            while (size > 0)
+            {
+                auto written = ::pwrite(fd, data, size, static_cast<off_t>(offset));
+                if (written < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                SPX_THROW_HR_IF(SPXERR_RUNTIME_ERROR, written <= 0);
+                data += written;
+                offset += static_cast<uint64_t>(written);
+                size -= static_cast<size_t>(written);
+            }
+        }
+
+        bool Read(uint64_t offset, uint8_t* data, size_t size) const
+        {
+            while (size > 0)
+            {
+                auto read = ::pread(fd, data, size, static_cast<off_t>(offset));
+                if (read < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (read <= 0)
+                {
+                    return false;
+                }
+                data += read;
+                offset += static_cast<uint64_t>(read);
+                size -= static_cast<size_t>(read);
+            }
+            return true;
+        }
+
+        void Flush()
+        {
+            SPX_THROW_HR_IF(SPXERR_RUNTIME_ERROR, ::fsync(fd) != 0);
+        }
+
+        void Truncate(uint64_t size)
+        {
+            SPX_THROW_HR_IF(SPXERR_RUNTIME_ERROR, ::ftruncate(fd, static_cast<off_t>(size)) != 0);
+            SPX_THROW_HR_IF(SPXERR_RUNTIME_ERROR, ::lseek(fd, 0, SEEK_END) < 0);
+        }
+
+        // Maps a range of the file read-only. The mapping is released with the returned pointer.
+        std::shared_ptr<const uint8_t> Map(uint64_t offset, size_t size) const
+        {
+            auto pageSize = static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+            auto start = offset - offset % pageSize;
+            auto length = static_cast<size_t>(offset - start) + size;
+            auto base = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, static_cast<off_t>(start));
+            SPX_THROW_HR_IF(SPXERR_FILE_OPEN_FAILED, base == MAP_FAILED);
+            std::shared_ptr<const uint8_t> mapping(static_cast<const uint8_t*>(base), [length](const uint8_t* p) { ::munmap(const_cast<uint8_t*>(p), length); });
+            return std::shared_ptr<const uint8_t>(mapping, mapping.get() + (offset - start));
+        }
+
+        const std::string path;
+        int fd = -1;
+
+    private:
+
+        DISABLE_COPY_AND_MOVE(CacheFile);
+    };
+
+}
+
+/*! \endcond */
+
+/// <summary>
+/// Audio and timing events found in, or added to, a <see cref="SpeechSynthesisCache"/>. The audio is read directly from
+/// the mapped cache file; it stays valid while this object exists, even if the entry is evicted meanwhile.
+/// Reading follows <see cref="AudioDataStream"/>.
+/// </summary>
+class SpeechSynthesisCacheEntry
+{
+public:
+
+    /// <summary>
+    /// Gets the audio, as it was added to the cache.
+    /// </summary>
+    /// <returns>Pointer to the audio, valid for the lifetime of this object.</returns>
+    const uint8_t* GetAudioData() const { return m_audio.get(); }
+
+    /// <summary>
+    /// Gets the size of the audio.
+    /// </summary>
+    /// <returns>The size in bytes.</returns>
+    uint32_t GetAudioSize() const { return m_audioSize; }
+
+    /// <summary>
+    /// Gets the duration of the audio.
+    /// </summary>
+    /// <returns>The duration, in ticks (100 nanoseconds).</returns>
+    uint64_t GetAudioDuration() const { return m_audioDuration; }
+
+    /// <summary>
+    /// Gets the word boundaries, in order.
+    /// </summary>
+    /// <returns>The word boundaries.</returns>
+    const std::vector<SpeechSynthesisSegmentWordBoundary>& GetWordBoundaries() const { return m_wordBoundaries; }
+
+    /// <summary>
+    /// Gets the bookmarks, in order.
+    /// </summary>
+    /// <returns>The bookmarks.</returns>
+    const std::vector<SpeechSynthesisSegmentBookmark>& GetBookmarks() const { return m_bookmarks; }
+
+    /// <summary>
+    /// Gets the status of the audio, which is always complete.
+    /// </summary>
+    /// <returns>StreamStatus::AllData.</returns>
+    StreamStatus GetStatus() const { return StreamStatus::AllData; }
+
+    /// <summary>
+    /// Checks whether the audio has enough data to be read, starting from the current position.
+    /// </summary>
+    /// <param name="bytesRequested">The requested data size in bytes.</param>
+    /// <returns>A bool indicating the result.</returns>
+    bool CanReadData(uint32_t bytesRequested) const
+    {
+        return CanReadData(m_position, bytesRequested);
+    }
+
+    /// <summary>
+    /// Checks whether the audio has enough data to be read, starting from a specified position.
+    /// </summary>
+    /// <param name="pos">The position counting from start of the audio.</param>
+    /// <param name="bytesRequested">The requested data size in bytes.</param>
+    /// <returns>A bool indicating the result.</returns>
+    bool CanReadData(uint32_t pos, uint32_t bytesRequested) const
+    {
+        return pos <= m_audioSize && bytesRequested <= m_audioSize - pos;
+    }
+
+    /// <summary>
+    /// Reads the audio from the current position, and advances the position.
+    /// </summary>
+    /// <param name="buffer">A buffer to receive read data.</param>
+    /// <param name="bufferSize">Size of the buffer.</param>
+    /// <returns>Size of data filled to the buffer, 0 means end of the audio.</returns>
+    uint32_t ReadData(uint8_t* buffer, uint32_t bufferSize)
+    {
+        return ReadData(m_position, buffer, bufferSize);
+    }
+
+    /// <summary>
+    /// Reads the audio from a specified position, and sets the position after the data read.
+    /// </summary>
+    /// <param name="pos">The position counting from start of the audio.</param>
+    /// <param name="buffer">A buffer to receive read data.</param>
+    /// <param name="bufferSize">Size of the buffer.</param>
+    /// <returns>Size of data filled to the buffer, 0 means end of the audio.</returns>
+    uint32_t ReadData(uint32_t pos, uint8_t* buffer, uint32_t bufferSize)
+    {
+        SPX_THROW_HR_IF(SPXERR_OUT_OF_RANGE, pos > m_audioSize);
+        auto size = std::min(bufferSize, m_audioSize - pos);
+        std::memcpy(buffer, m_audio.get() + pos, size);
+        m_position = pos + size;
+        return size;
+    }
+
+    /// <summary>
+    /// Gets the current position.
+    /// </summary>
+    /// <returns>Position counting from start of the audio.</returns>
+    uint32_t GetPosition() const { return m_position; }
+
+    /// <summary>
+    /// Sets the current position.
+    /// </summary>
+    /// <param name="pos">Position counting from start of the audio.</param>
+    void SetPosition(uint32_t pos)
+    {
+        SPX_THROW_HR_IF(SPXERR_OUT_OF_RANGE, pos > m_audioSize);
+        m_position = pos;
+    }
+
+private:
+
+    friend class SpeechSynthesisCache;
+
+    SpeechSynthesisCacheEntry() = default;
+
+    DISABLE_COPY_AND_MOVE(SpeechSynthesisCacheEntry);
+
+    std::shared_ptr<const uint8_t> m_audio;
+    uint32_t m_audioSize = 0;
+    uint64_t m_audioDuration = 0;
+    std::vector<SpeechSynthesisSegmentWordBoundary> m_wordBoundaries;
+    std::vector<SpeechSynthesisSegmentBookmark> m_bookmarks;
+    uint32_t m_position = 0;
+};
+
+/// <summary>
+/// The outcome of a synthesis through a <see cref="SpeechSynthesisCache"/>.
+/// </summary>
+class SpeechSynthesisCacheResult
+{
+public:
+
+    /// <summary>
+    /// SynthesizingAudioCompleted, or the reason of the synthesis result if the synthesis failed.
+    /// </summary>
+    const ResultReason& Reason;
+
+    /// <summary>
+    /// Whether the audio was found in the cache.
+    /// </summary>
+    const bool& IsCacheHit;
+
+    /// <summary>
+    /// Gets the audio and timing events, or nullptr if the synthesis failed.
+    /// </summary>
+    /// <returns>The cache entry.</returns>
+    std::shared_ptr<SpeechSynthesisCacheEntry> GetEntry() const { return m_entry; }
+
+    /// <summary>
+    /// Gets the synthesis result, or nullptr on a cache hit. For a failed synthesis, use it with
+    /// <see cref="SpeechSynthesisCancellationDetails::FromResult"/>.
+    /// </summary>
+    /// <returns>The synthesis result.</returns>
+    std::shared_ptr<SpeechSynthesisResult> GetSynthesisResult() const { return m_synthesisResult; }
+
+private:
+
+    friend class SpeechSynthesisCache;
+
+    SpeechSynthesisCacheResult(std::shared_ptr<SpeechSynthesisCacheEntry> entry, std::shared_ptr<SpeechSynthesisResult> synthesisResult) :
+        Reason(m_reason),
+        IsCacheHit(m_isCacheHit),
+        m_reason(synthesisResult == nullptr ? ResultReason::SynthesizingAudioCompleted : synthesisResult->Reason),
+        m_isCacheHit(synthesisResult == nullptr),
+        m_entry(std::move(entry)),
+        m_synthesisResult(std::move(synthesisResult))
+    {
+    }
+
+    DISABLE_COPY_AND_MOVE(SpeechSynthesisCacheResult);
+
+    ResultReason m_reason;
+    bool m_isCacheHit;
+    std::shared_ptr<SpeechSynthesisCacheEntry> m_entry;
+    std::shared_ptr<SpeechSynthesisResult> m_synthesisResult;
+};
+
+/// <summary>
+/// Persistent cache of synthesized audio and its timing events, keyed by a hash of the normalized SSML and of the
+/// synthesizer's voice, language and output format. Entries are appended to segment files and read back through
+/// memory mappings. The index is a checksummed journal, so that a crash loses at most the entries being added.
+/// </summary>
+/// <remarks>
+/// One process at a time may use a cache directory. Recency is kept in memory; after reopening, entries are
+/// evicted in the order they were last written to the index.
+/// </remarks>
+class SpeechSynthesisCache
+{
+public:
+
+    /// <summary>
+    /// Opens a cache directory, creating it if needed. Entries whose data did not reach the disk are dropped.
+    /// </summary>
+    /// <param name="directory">The directory.</param>
+    /// <param name="options">Options.</param>
+    /// <returns>A smart pointer wrapped cache.</returns>
+    static std::shared_ptr<SpeechSynthesisCache> Open(const std::string& directory, const SpeechSynthesisCacheOptions& options = SpeechSynthesisCacheOptions())
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, directory.empty() || options.MaxSizeInBytes == 0 || options.SegmentFileSize == 0);
+        SPX_THROW_HR_IF(SPXERR_FILE_OPEN_FAILED, ::mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST);
+
+        auto cache = std::shared_ptr<SpeechSynthesisCache>(new SpeechSynthesisCache(directory, options));
+        std::unique_lock<std::mutex> lock(cache->m_mutex);
+        cache->Load();
+        cache->ReclaimSegmentFiles(cache->Trim(), lock);
+        return cache;
+    }
+
+    /// <summary>
+    /// Gets the key of an SSML document synthesized with the given synthesizer.
+    /// </summary>
+    /// <param name="synthesizer">The synthesizer.</param>
+    /// <param name="ssml">The SSML document.</param>
+    /// <returns>The key.</returns>
+    static std::string GetSsmlKey(const SpeechSynthesizer& synthesizer, const std::string& ssml)
+    {
+        return GetKey("ssml\n" + Details::GetSynthesisSettings(synthesizer) + Details::NormalizeContent(ssml));
+    }
+
+    /// <summary>
+    /// Gets the key of a plain text synthesized with the given synthesizer.
+    /// </summary>
+    /// <param name="synthesizer">The synthesizer.</param>
+    /// <param name="text">The text.</param>
+    /// <returns>The key.</returns>
+    static std::string GetTextKey(const SpeechSynthesizer& synthesizer, const std::string& text)
+    {
+        return GetKey("text\n" + Details::GetSynthesisSettings(synthesizer) + Details::NormalizeContent(text));
+    }
+
+    /// <summary>
+    /// Gets a key from a description of the content, for entries added with <see cref="Add"/>.
+    /// </summary>
+    /// <param name="content">Everything the audio depends on.</param>
+    /// <returns>The key.</returns>
+    static std::string GetKey(const std::string& content)
+    {
+        return Details::HashContent(content);
+    }
+
+    /// <summary>
+    /// Synthesizes an SSML document, or gets its audio from the cache. Completed syntheses are added to the cache.
+    /// </summary>
+    /// <param name="synthesizer">The synthesizer.</param>
+    /// <param name="ssml">The SSML document.</param>
+    /// <returns>The result.</returns>
+    std::shared_ptr<SpeechSynthesisCacheResult> SpeakSsml(const std::shared_ptr<SpeechSynthesizer>& synthesizer, const std::string& ssml)
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, synthesizer == nullptr);
+        return Speak(synthesizer, GetSsmlKey(*synthesizer, ssml), [&] { return synthesizer->SpeakSsml(ssml); });
+    }
+
+    /// <summary>
+    /// Synthesizes a plain text, or gets its audio from the cache. Completed syntheses are added to the cache.
+    /// </summary>
+    /// <param name="synthesizer">The synthesizer.</param>
+    /// <param name="text">The text.</param>
+    /// <returns>The result.</returns>
+    std::shared_ptr<SpeechSynthesisCacheResult> SpeakText(const std::shared_ptr<SpeechSynthesizer>& synthesizer, const std::string& text)
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, synthesizer == nullptr);
+        return Speak(synthesizer, GetTextKey(*synthesizer, text), [&] { return synthesizer->SpeakText(text); });
+    }
+
+    /// <summary>
+    /// Looks up an entry.
+    /// </summary>
+    /// <param name="key">The key.</param>
+    /// <returns>The entry, or nullptr if there is none.</returns>
+    std::shared_ptr<SpeechSynthesisCacheEntry> Find(const std::string& key)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(key);
+        if (it == m_entries.end())
+        {
+            m_metrics.Misses++;
+            return nullptr;
+        }
+
+        m_lru.splice(m_lru.end(), m_lru, it->second.recency);
+        auto location = it->second;
+        auto file = m_files.at(location.fileId).file;
+        lock.unlock();
+
+        std::shared_ptr<SpeechSynthesisCacheEntry> entry;
+        try
+        {
+            entry = Parse(key, file->Map(location.offset, static_cast<size_t>(location.length)), location.length);
+        }
+        catch (const std::exception& ex)
+        {
+            SPX_TRACE_ERROR("Unable to read speech synthesis cache entry %s: %s", key.c_str(), ex.what());
+            (void)ex;
+        }
+
+        lock.lock();
+        if (entry == nullptr)
+        {
+            m_metrics.Misses++;
+            it = m_entries.find(key);
+            if (it != m_entries.end() && it->second.fileId == location.fileId && it->second.offset == location.offset)
+            {
+                Remove(key, lock);
+            }
+            return nullptr;
+        }
+        m_metrics.Hits++;
+        return entry;
+    }
+
+    /// <summary>
+    /// Adds an entry, replacing any entry with the same key.
+    /// </summary>
+    /// <param name="key">The key, from one of the GetKey functions.</param>
+    /// <param name="audio">The audio and timing events.</param>
+    /// <returns>The entry. If it does not fit into the cache, it is returned without being added.</returns>
+    std::shared_ptr<SpeechSynthesisCacheEntry> Add(const std::string& key, const SpeechSynthesisSegmentAudio& audio)
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, !IsKey(key));
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, audio.Audio.size() > UINT32_MAX);
+
+        auto metadata = Serialize(key, audio);
+        auto length = static_cast<uint64_t>(metadata.size()) + audio.Audio.size();
+        if (length > m_options.MaxSizeInBytes / 2)
+        {
+            auto owned = std::make_shared<std::vector<uint8_t>>(metadata);
+            owned->insert(owned->begin() + EntryHeaderSize, audio.Audio.begin(), audio.Audio.end());
+            return Parse(key, std::shared_ptr<const uint8_t>(owned, owned->data()), owned->size());
+        }
+
+        // The range is reserved under the lock, and written and synced outside of it. The file is not reclaimed
+        // while writes to it are pending.
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_current == nullptr || m_files[m_currentId].size >= m_options.SegmentFileSize)
+        {
+            StartSegmentFile();
+        }
+
+        auto file = m_current;
+        Location location;
+        location.fileId = m_currentId;
+        location.offset = m_files[m_currentId].size;
+        location.length = length;
+        m_files[m_currentId].size += length;
+        m_files[m_currentId].pendingWrites++;
+        m_metrics.SizeInBytes += length;
+        lock.unlock();
+
+        std::shared_ptr<const uint8_t> mapped;
+        try
+        {
+            file->WriteAt(location.offset, metadata.data(), EntryHeaderSize);
+            file->WriteAt(location.offset + EntryHeaderSize, audio.Audio.data(), audio.Audio.size());
+            file->WriteAt(location.offset + EntryHeaderSize + audio.Audio.size(), metadata.data() + EntryHeaderSize, metadata.size() - EntryHeaderSize);
+            // The data must be on disk before the index refers to it.
+            file->Flush();
+            // Mapped first, as trimming may already evict the entry.
+            mapped = file->Map(location.offset, static_cast<size_t>(length));
+        }
+        catch (...)
+        {
+            // The range stays unused, and its space is reclaimed with the file; later entries go to a new file.
+            lock.lock();
+            m_files[location.fileId].pendingWrites--;
+            if (m_current == file)
+            {
+                m_current.reset();
+            }
+            throw;
+        }
+
+        lock.lock();
+        m_files[location.fileId].pendingWrites--;
+        Remove(key, lock);
+        AppendRecord(RecordType::Add, key, location);
+        Insert(key, location);
+        m_metrics.Additions++;
+        auto reclaim = Trim();
+        auto index = m_index;
+        lock.unlock();
+
+        // The record must be on disk before the entry is used; syncs of concurrent additions may overlap.
+        index->Flush();
+        if (reclaim != 0)
+        {
+            lock.lock();
+            ReclaimSegmentFiles(reclaim, lock);
+        }
+        return Parse(key, std::move(mapped), length);
+    }
+
+    /// <summary>
+    /// Removes an entry.
+    /// </summary>
+    /// <param name="key">The key.</param>
+    /// <returns>Whether there was an entry.</returns>
+    bool Remove(const std::string& key)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return Remove(key, lock);
+    }
+
+    /// <summary>
+    /// Gets the counters of the cache.
+    /// </summary>
+    /// <returns>A copy of the counters.</returns>
+    SpeechSynthesisCacheMetrics GetMetrics() const
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_metrics;
+    }
+
+private:
+
+    SpeechSynthesisCache(const std::string& directory, const SpeechSynthesisCacheOptions& options) :
+        m_directory(directory),
+        m_options(options)
+    {
+    }
+
+    DISABLE_COPY_AND_MOVE(SpeechSynthesisCache);
+
+    enum class RecordType : uint32_t { Add = 1, Remove = 2 };
+
+    // type, file id, offset, length, key, crc
+    static constexpr size_t RecordSize = 4 + 4 + 8 + 8 + 16 + 4;
+    static constexpr size_t KeySize = 16;
+    // magic, key, audio size, audio duration, word boundary count, bookmark count
+    static constexpr size_t EntryHeaderSize = 8 + KeySize + 4 + 8 + 4 + 4;
+
+    struct Location
+    {
+        uint32_t fileId = 0;
+        uint64_t offset = 0;
+        uint64_t length = 0;
+        std::list<std::string>::iterator recency;
+    };
+
+    struct SegmentFile
+    {
+        std::shared_ptr<Details::CacheFile> file;
+        uint64_t size = 0;
+        uint64_t liveSize = 0;
+        size_t liveCount = 0;
+        size_t pendingWrites = 0;
+        // Space counted as free while the file is being reclaimed; nonzero while it is.
+        uint64_t reclaimingSize = 0;
+    };
+
+    static const char* IndexMagic() { return "SPXCIX01"; }
+    static const char* EntryMagic() { return "SPXCEN01"; }
+
+    static bool IsKey(const std::string& key)
+    {
+        return key.size() == 2 * KeySize && std::all_of(key.begin(), key.end(), [](char ch) { return (ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'f'); });
+    }
+
+    static void KeyToBytes(const std::string& key, uint8_t* bytes)
+    {
+        auto nibble = [](char ch) { return static_cast<uint8_t>(ch <= '9' ? ch - '0' : ch - 'a' + 10); };
+        for (size_t i = 0; i < KeySize; i++)
+        {
+            bytes[i] = static_cast<uint8_t>(nibble(key[2 * i]) << 4 | nibble(key[2 * i + 1]));
+        }
+    }
+
+    static std::string KeyFromBytes(const uint8_t* bytes)
+    {
+        static const char digits[] = "0123456789abcdef";
+        std::string key(2 * KeySize, '0');
+        for (size_t i = 0; i < KeySize; i++)
+        {
+            key[2 * i] = digits[bytes[i] >> 4];
+            key[2 * i + 1] = digits[bytes[i] & 0xf];
+        }
+        return key;
+    }
+
+    template <class T>
+    static void Put(std::vector<uint8_t>& buffer, T value)
+    {
+        auto size = buffer.size();
+        buffer.resize(size + sizeof(T));
+        std::memcpy(buffer.data() + size, &value, sizeof(T));
+    }
+
+    static void PutString(std::vector<uint8_t>& buffer, const SPXSTRING& text)
+    {
+        auto utf8 = Utils::ToUTF8(text);
+        Put(buffer, static_cast<uint32_t>(utf8.size()));
+        buffer.insert(buffer.end(), utf8.begin(), utf8.end());
+    }
+
+    // Gets the header and the metadata of an entry; the audio goes in between.
+    static std::vector<uint8_t> Serialize(const std::string& key, const SpeechSynthesisSegmentAudio& audio)
+    {
+        std::vector<uint8_t> buffer(EntryMagic(), EntryMagic() + 8);
+        buffer.resize(8 + KeySize);
+        KeyToBytes(key, buffer.data() + 8);
+        Put(buffer, static_cast<uint32_t>(audio.Audio.size()));
+        Put(buffer, audio.AudioDuration);
+        Put(buffer, static_cast<uint32_t>(audio.WordBoundaries.size()));
+        Put(buffer, static_cast<uint32_t>(audio.Bookmarks.size()));
+
+        for (auto& boundary : audio.WordBoundaries)
+        {
+            Put(buffer, boundary.AudioOffset);
+            Put(buffer, static_cast<uint64_t>(boundary.Duration.count()));
+            Put(buffer, boundary.TextOffset);
+            Put(buffer, boundary.WordLength);
+            Put(buffer, static_cast<uint32_t>(boundary.BoundaryType));
+            PutString(buffer, boundary.Text);
+        }
+        for (auto& bookmark : audio.Bookmarks)
+        {
+            Put(buffer, bookmark.AudioOffset);
+            PutString(buffer, bookmark.Text);
+        }
+        return buffer;
+    }
+
+    // Reads an entry, checking it against its key. Returns nullptr if it is damaged.
+    static std::shared_ptr<SpeechSynthesisCacheEntry> Parse(const std::string& key, std::shared_ptr<const uint8_t> data, uint64_t length)
+    {
+        auto p = data.get();
+        auto end = p + length;
+        bool valid = true;
+        auto get = [&](void* value, size_t size) {
+            valid = valid && static_cast<size_t>(end - p) >= size;
+            if (valid)
+            {
+                std::memcpy(value, p, size);
+                p += size;
+            }
+        };
+        auto getString = [&]() {
+            uint32_t size = 0;
+            get(&size, sizeof(size));
+            valid = valid && static_cast<size_t>(end - p) >= size;
+            std::string text = valid ? std::string(reinterpret_cast<const char*>(p), size) : std::string();
+            p += valid ? size : 0;
+            return Utils::ToSPXString(text);
+        };
+
+        char magic[8] = {};
+        uint8_t keyBytes[KeySize] = {};
+        uint32_t wordBoundaryCount = 0;
+        uint32_t bookmarkCount = 0;
+        std::shared_ptr<SpeechSynthesisCacheEntry> entry(new SpeechSynthesisCacheEntry());
+        get(magic, sizeof(magic));
+        get(keyBytes, sizeof(keyBytes));
+        get(&entry->m_audioSize, sizeof(entry->m_audioSize));
+        get(&entry->m_audioDuration, sizeof(entry->m_audioDuration));
+        get(&wordBoundaryCount, sizeof(wordBoundaryCount));
+        get(&bookmarkCount, sizeof(bookmarkCount));
+        if (!valid || std::memcmp(magic, EntryMagic(), sizeof(magic)) != 0 || KeyFromBytes(keyBytes) != key ||
+            static_cast<uint64_t>(end - p) < entry->m_audioSize)
+        {
+            return nullptr;
+        }
+        entry->m_audio = std::shared_ptr<const uint8_t>(data, p);
+        p += entry->m_audioSize;
+
+        // Each word boundary takes at least 32 bytes and each bookmark 12, which bounds the counts of a damaged entry.
+        if (static_cast<uint64_t>(wordBoundaryCount) * 32 + static_cast<uint64_t>(bookmarkCount) * 12 > static_cast<uint64_t>(end - p))
+        {
+            return nullptr;
+        }
+        entry->m_wordBoundaries.reserve(wordBoundaryCount);
+        for (uint32_t i = 0; i < wordBoundaryCount && valid; i++)
+        {
+            SpeechSynthesisSegmentWordBoundary boundary{};
+            uint64_t duration = 0;
+            uint32_t boundaryType = 0;
+            get(&boundary.AudioOffset, sizeof(boundary.AudioOffset));
+            get(&duration, sizeof(duration));
+            get(&boundary.TextOffset, sizeof(boundary.TextOffset));
+            get(&boundary.WordLength, sizeof(boundary.WordLength));
+            get(&boundaryType, sizeof(boundaryType));
+            boundary.Duration = std::chrono::milliseconds(duration);
+            boundary.BoundaryType = static_cast<SpeechSynthesisBoundaryType>(boundaryType);
+            boundary.Text = getString();
+            entry->m_wordBoundaries.push_back(std::move(boundary));
+        }
+        entry->m_bookmarks.reserve(bookmarkCount);
+        for (uint32_t i = 0; i < bookmarkCount && valid; i++)
+        {
+            SpeechSynthesisSegmentBookmark bookmark{};
+            get(&bookmark.AudioOffset, sizeof(bookmark.AudioOffset));
+            bookmark.Text = getString();
+            entry->m_bookmarks.push_back(std::move(bookmark));
+        }
+        return valid ? entry : nullptr;
+    }
+
+    template <class TSpeak>
+    std::shared_ptr<SpeechSynthesisCacheResult> Speak(const std::shared_ptr<SpeechSynthesizer>& synthesizer, const std::string& key, TSpeak speak)
+    {
+        auto entry = Find(key);
+        if (entry != nullptr)
+        {
+            return std::shared_ptr<SpeechSynthesisCacheResult>(new SpeechSynthesisCacheResult(std::move(entry), nullptr));
+        }
+
+        // Events are collected by result id, as the synthesizer may be used by others meanwhile.
+        struct Collected
+        {
+            std::mutex mutex;
+            std::map<SPXSTRING, SpeechSynthesisSegmentAudio> byResultId;
+        };
+        auto collected = std::make_shared<Collected>();
+        auto onWordBoundary = [collected](const SpeechSynthesisWordBoundaryEventArgs& e) {
+            std::unique_lock<std::mutex> lock(collected->mutex);
+            collected->byResultId[e.ResultId].WordBoundaries.push_back(SpeechSynthesisSegmentWordBoundary{ e.AudioOffset, e.Duration, e.TextOffset, e.WordLength, e.BoundaryType, e.Text });
+        };
+        auto onBookmark = [collected](const SpeechSynthesisBookmarkEventArgs& e) {
+            std::unique_lock<std::mutex> lock(collected->mutex);
+            collected->byResultId[e.ResultId].Bookmarks.push_back(SpeechSynthesisSegmentBookmark{ e.AudioOffset, e.Text });
+        };
+
+        // The handlers are disconnected by token, so that concurrent calls on the same synthesizer keep their own.
+        // Events queued for asynchronous delivery are delivered before, so that the metadata is complete.
+        auto wordBoundaryToken = synthesizer->WordBoundary.ConnectWithToken(onWordBoundary);
+        auto bookmarkToken = synthesizer->BookmarkReached.ConnectWithToken(onBookmark);
+        auto disconnect = [&synthesizer, wordBoundaryToken, bookmarkToken]() {
+            synthesizer->WordBoundary.FlushAsyncDispatch();
+            synthesizer->BookmarkReached.FlushAsyncDispatch();
+            synthesizer->WordBoundary.DisconnectToken(wordBoundaryToken);
+            synthesizer->BookmarkReached.DisconnectToken(bookmarkToken);
+        };
+
+        std::shared_ptr<SpeechSynthesisResult> result;
+        try
+        {
+            result = speak();
+        }
+        catch (...)
+        {
+            disconnect();
+            throw;
+        }
+        disconnect();
+
+        if (result->Reason == ResultReason::SynthesizingAudioCompleted)
+        {
+            SpeechSynthesisSegmentAudio audio;
+            {
+                std::unique_lock<std::mutex> lock(collected->mutex);
+                audio = std::move(collected->byResultId[result->ResultId]);
+            }
+            audio.Audio.resize(result->GetAudioLength());
+            audio.Audio.resize(result->ReadAudio(0, audio.Audio.data(), static_cast<uint32_t>(audio.Audio.size())));
+            audio.AudioDuration = static_cast<uint64_t>(result->AudioDuration.count()) * 10000;
+            entry = Add(key, audio);
+        }
+        return std::shared_ptr<SpeechSynthesisCacheResult>(new SpeechSynthesisCacheResult(std::move(entry), std::move(result)));
+    }
+
+    std::string GetSegmentPath(uint32_t id) const
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "/segment-%08x.bin", id);
+        return m_directory + name;
+    }
+
+    std::string GetIndexPath() const
+    {
+        return m_directory + "/index.bin";
+    }
+
+    // Replays the index journal up to its first damaged record, and deletes segment files it does not refer to.
+    void Load()
+    {
+        m_index = std::make_shared<Details::CacheFile>(GetIndexPath(), O_RDWR | O_CREAT | O_APPEND);
+        auto indexSize = m_index->GetSize();
+        uint8_t magic[8] = {};
+        if (indexSize < sizeof(magic) || !m_index->Read(0, magic, sizeof(magic)) || std::memcmp(magic, IndexMagic(), sizeof(magic)) != 0)
+        {
+            m_index->Truncate(0);
+            m_index->Write(reinterpret_cast<const uint8_t*>(IndexMagic()), sizeof(magic));
+            indexSize = sizeof(magic);
+        }
+
+        std::vector<uint8_t> records(static_cast<size_t>(indexSize - sizeof(magic)));
+        if (!m_index->Read(sizeof(magic), records.data(), records.size()))
+        {
+            records.clear();
+        }
+
+        uint64_t valid = 0;
+        for (size_t offset = 0; offset + RecordSize <= records.size(); offset += RecordSize)
+        {
+            auto record = records.data() + offset;
+            uint32_t crc;
+            std::memcpy(&crc, record + RecordSize - 4, 4);
+            if (crc != Details::Crc32(record, RecordSize - 4))
+            {
+                break;
+            }
+
+            uint32_t type;
+            Location location;
+            std::memcpy(&type, record, 4);
+            std::memcpy(&location.fileId, record + 4, 4);
+            std::memcpy(&location.offset, record + 8, 8);
+            std::memcpy(&location.length, record + 16, 8);
+            auto key = KeyFromBytes(record + 24);
+            m_recordCount++;
+            valid = offset + RecordSize;
+
+            RemoveEntry(key);
+            if (type == static_cast<uint32_t>(RecordType::Add) && OpenSegmentFile(location.fileId) &&
+                location.offset + location.length <= m_files[location.fileId].size)
+            {
+                Insert(key, location);
+            }
+        }
+        // A torn record at the end is dropped, so that new records follow the last valid one.
+        if (valid != records.size())
+        {
+            m_index->Truncate(sizeof(magic) + valid);
+        }
+
+        DeleteUnusedSegmentFiles();
+        m_metrics.SizeInBytes = 0;
+        for (auto& file : m_files)
+        {
+            m_currentId = std::max(m_currentId, file.first);
+            m_metrics.SizeInBytes += file.second.size;
+        }
+    }
+
+    // Opens a segment file referred to by the index; returns false if it is missing.
+    bool OpenSegmentFile(uint32_t id)
+    {
+        if (m_files.count(id) != 0)
+        {
+            return true;
+        }
+        try
+        {
+            SegmentFile segment;
+            segment.file = std::make_shared<Details::CacheFile>(GetSegmentPath(id), O_RDONLY);
+            segment.size = segment.file->GetSize();
+            m_files[id] = segment;
+            return true;
+        }
+        catch (const std::exception&)
+        {
+            return false;
+        }
+    }
+
+    void DeleteUnusedSegmentFiles()
+    {
+        for (auto it = m_files.begin(); it != m_files.end();)
+        {
+            if (it->second.liveCount == 0 && it->first != m_currentId)
+            {
+                ::unlink(it->second.file->path.c_str());
+                it = m_files.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        // Files left by a crash before their first entry was indexed.
+        auto dir = ::opendir(m_directory.c_str());
+        if (dir == nullptr)
+        {
+            return;
+        }
+        while (auto item = ::readdir(dir))
+        {
+            unsigned int id = 0;
+            char suffix[8] = {};
+            if (std::sscanf(item->d_name, "segment-%8x.%3s", &id, suffix) == 2 && std::strcmp(suffix, "bin") == 0 && m_files.count(id) == 0)
+            {
+                ::unlink((m_directory + "/" + item->d_name).c_str());
+            }
+        }
+        ::closedir(dir);
+    }
+
+    // Segment files are only ever appended to and deleted, never overwritten, so that mapped entries stay valid.
+    void StartSegmentFile()
+    {
+        m_currentId++;
+        m_current = std::make_shared<Details::CacheFile>(GetSegmentPath(m_currentId), O_RDWR | O_CREAT | O_TRUNC);
+        SegmentFile segment;
+        segment.file = m_current;
+        m_files[m_currentId] = segment;
+    }
+
+    void AppendRecord(RecordType type, const std::string& key, const Location& location)
+    {
+        uint8_t record[RecordSize];
+        auto typeValue = static_cast<uint32_t>(type);
+        std::memcpy(record, &typeValue, 4);
+        std::memcpy(record + 4, &location.fileId, 4);
+        std::memcpy(record + 8, &location.offset, 8);
+        std::memcpy(record + 16, &location.length, 8);
+        KeyToBytes(key, record + 24);
+        auto crc = Details::Crc32(record, RecordSize - 4);
+        std::memcpy(record + RecordSize - 4, &crc, 4);
+        m_index->Write(record, RecordSize);
+        m_recordCount++;
+    }
+
+    void Insert(const std::string& key, Location location)
+    {
+        location.recency = m_lru.insert(m_lru.end(), key);
+        auto& file = m_files[location.fileId];
+        file.liveSize += location.length;
+        file.liveCount++;
+        m_metrics.Entries++;
+        m_metrics.EntriesSizeInBytes += location.length;
+        m_entries[key] = location;
+    }
+
+    bool RemoveEntry(const std::string& key)
+    {
+        auto it = m_entries.find(key);
+        if (it == m_entries.end())
+        {
+            return false;
+        }
+        auto& file = m_files[it->second.fileId];
+        file.liveSize -= it->second.length;
+        file.liveCount--;
+        m_metrics.Entries--;
+        m_metrics.EntriesSizeInBytes -= it->second.length;
+        m_lru.erase(it->second.recency);
+        m_entries.erase(it);
+        return true;
+    }
+
+    bool Remove(const std::string& key, std::unique_lock<std::mutex>&)
+    {
+        auto it = m_entries.find(key);
+        if (it == m_entries.end())
+        {
+            return false;
+        }
+        AppendRecord(RecordType::Remove, key, it->second);
+        RemoveEntry(key);
+        return true;
+    }
+
+    // Evicts the least recently used entries until the files fit into the maximum size, counting the removed entries
+    // of files being reclaimed as free. Returns a file mostly holding removed entries to be reclaimed with
+    // ReclaimSegmentFiles, if there is one, instead of evicting more; otherwise 0.
+    uint32_t Trim()
+    {
+        CompactIndex();
+
+        while (m_metrics.SizeInBytes - m_reclaimingSize > m_options.MaxSizeInBytes)
+        {
+            auto reclaim = m_files.end();
+            for (auto it = m_files.begin(); it != m_files.end(); ++it)
+            {
+                if (it->second.size > 0 && it->second.pendingWrites == 0 && it->second.reclaimingSize == 0 && it->second.liveSize <= it->second.size / 2 &&
+                    (reclaim == m_files.end() || it->second.size - it->second.liveSize > reclaim->second.size - reclaim->second.liveSize))
+                {
+                    reclaim = it;
+                }
+            }
+
+            if (reclaim != m_files.end())
+            {
+                // Nothing is added to the file any more.
+                if (reclaim->first == m_currentId)
+                {
+                    m_current.reset();
+                }
+                reclaim->second.reclaimingSize = reclaim->second.size - reclaim->second.liveSize;
+                m_reclaimingSize += reclaim->second.reclaimingSize;
+                return reclaim->first;
+            }
+            else if (!m_lru.empty())
+            {
+                auto key = m_lru.front();
+                AppendRecord(RecordType::Remove, key, m_entries[key]);
+                RemoveEntry(key);
+                m_metrics.Evictions++;
+            }
+            else
+            {
+                break;
+            }
+        }
+        return 0;
+    }
+
+    // Reclaims the file selected by Trim, and the ones selected by trimming again after it.
+    void ReclaimSegmentFiles(uint32_t id, std::unique_lock<std::mutex>& lock)
+    {
+        while (id != 0 && ReclaimSegmentFile(id, lock))
+        {
+            id = Trim();
+        }
+    }
+
+    // Moves the remaining entries of the file to the current file, then deletes it. The entries are copied and
+    // synced outside of the lock, like additions; entries removed or replaced meanwhile are left behind. Returns
+    // false if the entries could not be copied, leaving the file in place.
+    bool ReclaimSegmentFile(uint32_t id, std::unique_lock<std::mutex>& lock)
+    {
+        std::vector<std::pair<std::string, Location>> moved;
+        uint64_t length = 0;
+        for (auto& entry : m_entries)
+        {
+            if (entry.second.fileId == id)
+            {
+                moved.emplace_back(entry.first, entry.second);
+                length += entry.second.length;
+            }
+        }
+
+        auto source = m_files[id].file;
+        std::shared_ptr<Details::CacheFile> target;
+        uint32_t targetId = 0;
+        uint64_t targetOffset = 0;
+        if (!moved.empty())
+        {
+            if (m_current == nullptr || m_files[m_currentId].size >= m_options.SegmentFileSize)
+            {
+                StartSegmentFile();
+            }
+            target = m_current;
+            targetId = m_currentId;
+            targetOffset = m_files[targetId].size;
+            m_files[targetId].size += length;
+            m_files[targetId].pendingWrites++;
+            m_metrics.SizeInBytes += length;
+        }
+        lock.unlock();
+
+        std::vector<bool> copied(moved.size(), false);
+        try
+        {
+            std::vector<uint8_t> buffer;
+            auto offset = targetOffset;
+            for (size_t i = 0; i < moved.size(); i++)
+            {
+                buffer.resize(static_cast<size_t>(moved[i].second.length));
+                if (source->Read(moved[i].second.offset, buffer.data(), buffer.size()))
+                {
+                    target->WriteAt(offset, buffer.data(), buffer.size());
+                    copied[i] = true;
+                }
+                offset += moved[i].second.length;
+            }
+            // The data must be on disk before the index refers to it.
+            if (target != nullptr)
+            {
+                target->Flush();
+            }
+        }
+        catch (const std::exception& ex)
+        {
+            SPX_TRACE_ERROR("Unable to reclaim speech synthesis cache file %s: %s", source->path.c_str(), ex.what());
+            (void)ex;
+
+            // As for a failed addition, the range stays unused and later entries go to a new file.
+            lock.lock();
+            if (target != nullptr)
+            {
+                m_files[targetId].pendingWrites--;
+                if (m_current == target)
+                {
+                    m_current.reset();
+                }
+            }
+            auto& file = m_files[id];
+            m_reclaimingSize -= file.reclaimingSize;
+            file.reclaimingSize = 0;
+            return false;
+        }
+
+        lock.lock();
+        if (target != nullptr)
+        {
+            m_files[targetId].pendingWrites--;
+        }
+        auto offset = targetOffset;
+        for (size_t i = 0; i < moved.size(); i++)
+        {
+            auto& key = moved[i].first;
+            auto entryLength = moved[i].second.length;
+            auto it = m_entries.find(key);
+            if (it != m_entries.end() && it->second.fileId == id && it->second.offset == moved[i].second.offset)
+            {
+                if (copied[i])
+                {
+                    // Moved in place, keeping the recency of the entry.
+                    m_files[id].liveSize -= entryLength;
+                    m_files[id].liveCount--;
+                    m_files[targetId].liveSize += entryLength;
+                    m_files[targetId].liveCount++;
+                    it->second.fileId = targetId;
+                    it->second.offset = offset;
+                    AppendRecord(RecordType::Add, key, it->second);
+                }
+                else
+                {
+                    Remove(key, lock);
+                }
+            }
+            offset += entryLength;
+        }
+        auto index = m_index;
+        lock.unlock();
+
+        // The records must be on disk before the data they refer to is gone.
+        index->Flush();
+
+        lock.lock();
+        auto& file = m_files[id];
+        m_metrics.SizeInBytes -= file.size;
+        m_reclaimingSize -= file.reclaimingSize;
+        ::unlink(file.file->path.c_str());
+        m_files.erase(id);
+        return true;
+    }
+
+    // Rewrites the index once most of its records are obsolete, in recency order, and replaces it atomically.
+    void CompactIndex()
+    {
+        if (m_recordCount < 1024 || m_recordCount < 4 * m_entries.size())
+        {
+            return;
+        }
+
+        auto path = GetIndexPath() + ".tmp";
+        auto index = std::make_shared<Details::CacheFile>(path, O_RDWR | O_CREAT | O_TRUNC | O_APPEND);
+        auto previous = m_index;
+        m_index = index;
+        m_recordCount = 0;
+        try
+        {
+            m_index->Write(reinterpret_cast<const uint8_t*>(IndexMagic()), 8);
+            for (auto& key : m_lru)
+            {
+                AppendRecord(RecordType::Add, key, m_entries[key]);
+            }
+            m_index->Flush();
+            SPX_THROW_HR_IF(SPXERR_RUNTIME_ERROR, ::rename(path.c_str(), GetIndexPath().c_str()) != 0);
+        }
+        catch (...)
+        {
+            m_index = previous;
+            m_recordCount = m_entries.size();
+            ::unlink(path.c_str());
+            throw;
+        }
+    }
+
+    const std::string m_directory;
+    const SpeechSynthesisCacheOptions m_options;
+
+    mutable std::mutex m_mutex;
+    std::shared_ptr<Details::CacheFile> m_index;
+    uint64_t m_recordCount = 0;
+    std::map<uint32_t, SegmentFile> m_files;
+    std::shared_ptr<Details::CacheFile> m_current;
+    uint32_t m_currentId = 0;
+    std::map<std::string, Location> m_entries;
+    std::list<std::string> m_lru;
+    uint64_t m_reclaimingSize = 0;
+    SpeechSynthesisCacheMetrics m_metrics;
+};
+
+} } } // Microsoft::CognitiveServices::Speech
@@ -0,0 +1,207 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_speech_synthesis_coalescer.h: Public API declarations for SpeechSynthesisCoalescer C++ class
+//
+
+#pragma once
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "speechapi_cxx_common.h"
+#include "speechapi_cxx_async_executor.h"
+#include "speechapi_cxx_speech_synthesizer.h"
+#include "speechapi_cxx_ssml_segmenter.h"
+#include "speechapi_cxx_parallel_speech_synthesizer.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+
+/// <summary>
+/// Counters of a <see cref="SpeechSynthesisCoalescer"/>.
+/// </summary>
+struct SpeechSynthesisCoalescerMetrics
+{
+    /// <summary>
+    /// Number of synthesis requests.
+    /// </summary>
+    uint64_t Requests = 0;
+
+    /// <summary>
+    /// Number of requests that were synthesized.
+    /// </summary>
+    uint64_t Synthesized = 0;
+
+    /// <summary>
+    /// Number of requests that got the result of an identical request in flight.
+    /// </summary>
+    uint64_t Coalesced = 0;
+
+    /// <summary>
+    /// Number of syntheses currently in flight.
+    /// </summary>
+    size_t InFlight = 0;
+
+    /// <summary>
+    /// Gets the share of requests that were coalesced.
+    /// </summary>
+    /// <returns>The ratio, between 0 and 1.</returns>
+    double GetCoalescedRatio() const
+    {
+        return Requests == 0 ? 0.0 : static_cast<double>(Coalesced) / static_cast<double>(Requests);
+    }
+};
+
+/// <summary>
+/// Coalesces identical synthesis requests that are in flight at the same time: only the first one is synthesized, and
+/// the others wait for it and get the same <see cref="SpeechSynthesisResult"/> object, sharing its audio.
+/// Requests are identical if their SSML or text is the same apart from whitespace, and the synthesizers have the same
+/// voice, language, output format and endpoint id.
+/// </summary>
+/// <remarks>
+/// Word boundary, bookmark and other events are raised only by the synthesizer that synthesizes, not by those of the
+/// coalesced requests. Exceptions and canceled results are shared the same way.
+/// </remarks>
+class SpeechSynthesisCoalescer : public std::enable_shared_from_this<SpeechSynthesisCoalescer>
+{
+public:
+
+    /// <summary>
+    /// Creates a coalescer.
+    /// </summary>
+    /// <returns>A smart pointer wrapped coalescer.</returns>
+    static std::shared_ptr<SpeechSynthesisCoalescer> Create()
+    {
+        return std::shared_ptr<SpeechSynthesisCoalescer>(new SpeechSynthesisCoalescer());
+    }
+
+    /// <summary>
+    /// Synthesizes an SSML document with the given synthesizer, unless an identical request is in flight.
+    /// </summary>
+    /// <param name="synthesizer">The synthesizer.</param>
+    /// <param name="ssml">The SSML document.</param>
+    /// <returns>The result, possibly shared with other requests.</returns>
+    std::shared_ptr<SpeechSynthesisResult> SpeakSsml(const std::shared_ptr<SpeechSynthesizer>& synthesizer, const std::string& ssml)
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, synthesizer == nullptr);
+        return Speak(GetKey("ssml\n", *synthesizer, ssml), [&] { return synthesizer->SpeakSsml(ssml); });
+    }
+
+    /// <summary>
+    /// Synthesizes a plain text with the given synthesizer, unless an identical request is in flight.
+    /// </summary>
+    /// <param name="synthesizer">The synthesizer.</param>
+    /// <param name="text">The text.</param>
+    /// <returns>The result, possibly shared with other requests.</returns>
+    std::shared_ptr<SpeechSynthesisResult> SpeakText(const std::shared_ptr<SpeechSynthesizer>& synthesizer, const std::string& text)
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, synthesizer == nullptr);
+        return Speak(GetKey("text\n", *synthesizer, text), [&] { return synthesizer->SpeakText(text); });
+    }
+
+    /// <summary>
+    /// Synthesizes an SSML document with the given synthesizer, unless an identical request is in flight, asynchronously.
+    /// </summary>
+    /// <param name="synthesizer">The synthesizer.</param>
+    /// <param name="ssml">The SSML document.</param>
+    /// <returns>An asynchronous operation representing the synthesis. It returns a value of <see cref="SpeechSynthesisResult"/> as result.</returns>
+    std::future<std::shared_ptr<SpeechSynthesisResult>> SpeakSsmlAsync(const std::shared_ptr<SpeechSynthesizer>& synthesizer, const std::string& ssml)
+    {
+        auto keepAlive = this->shared_from_this();
+        return Details::RunAsync([keepAlive, this, synthesizer, ssml]() { return SpeakSsml(synthesizer, ssml); });
+    }
+
+    /// <summary>
+    /// Synthesizes a plain text with the given synthesizer, unless an identical request is in flight, asynchronously.
+    /// </summary>
+    /// <param name="synthesizer">The synthesizer.</param>
+    /// <param name="text">The text.</param>
+    /// <returns>An asynchronous operation representing the synthesis. It returns a value of <see cref="SpeechSynthesisResult"/> as result.</returns>
+    std::future<std::shared_ptr<SpeechSynthesisResult>> SpeakTextAsync(const std::shared_ptr<SpeechSynthesizer>& synthesizer, const std::string& text)
+    {
+        auto keepAlive = this->shared_from_this();
+        return Details::RunAsync([keepAlive, this, synthesizer, text]() { return SpeakText(synthesizer, text); });
+    }
+
+    /// <summary>
+    /// Gets the counters of the coalescer.
+    /// </summary>
+    /// <returns>A copy of the counters.</returns>
+    SpeechSynthesisCoalescerMetrics GetMetrics() const
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_metrics;
+    }
+
+private:
+
+    SpeechSynthesisCoalescer() = default;
+
+    DISABLE_COPY_AND_MOVE(SpeechSynthesisCoalescer);
+
+    using Flight_Type = std::shared_future<std::shared_ptr<SpeechSynthesisResult>>;
+
+    static std::string GetKey(const char* kind, const SpeechSynthesizer& synthesizer, const std::string& content)
+    {
+        return Details::HashContent(kind + Details::GetSynthesisSettings(synthesizer) + Details::NormalizeContent(content));
+    }
+
+    template <class TSpeak>
+    std::shared_ptr<SpeechSynthesisResult> Speak(const std::string& key, TSpeak speak)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_metrics.Requests++;
+        auto it = m_flights.find(key);
+        if (it != m_flights.end())
+        {
+            m_metrics.Coalesced++;
+            auto flight = it->second;
+            lock.unlock();
+            return flight.get();
+        }
+
+        std::promise<std::shared_ptr<SpeechSynthesisResult>> promise;
+        m_flights.emplace(key, promise.get_future().share());
+        m_metrics.Synthesized++;
+        m_metrics.InFlight++;
+        lock.unlock();
+
+        std::shared_ptr<SpeechSynthesisResult> result;
+        std::exception_ptr error;
+        try
+        {
+            result = speak();
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        // Requests arriving from now on synthesize again, rather than getting a result that may be outdated.
+        lock.lock();
+        m_flights.erase(key);
+        m_metrics.InFlight--;
+        lock.unlock();
+
+        if (error != nullptr)
+        {
+            promise.set_exception(error);
+            std::rethrow_exception(error);
+        }
+        promise.set_value(result);
+        return result;
+    }
+
+    mutable std::mutex m_mutex;
+    std::map<std::string, Flight_Type> m_flights;
+    SpeechSynthesisCoalescerMetrics m_metrics;
+};
+
+} } } // Microsoft::CognitiveServices::Speech
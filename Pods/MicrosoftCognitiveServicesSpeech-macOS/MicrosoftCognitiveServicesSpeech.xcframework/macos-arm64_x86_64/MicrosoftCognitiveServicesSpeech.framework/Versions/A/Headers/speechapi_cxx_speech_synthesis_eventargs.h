@@ -6,6 +6,9 @@
 //
 
 #pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
 #include "speechapi_cxx_common.h"
 #include "speechapi_cxx_string_helpers.h"
 #include "speechapi_cxx_eventargs.h"
@@ -21,6 +24,11 @@ namespace Speech {
 /// Class for speech synthesis event arguments.
 /// Added in version 1.4.0
 /// </summary>
+/// <remarks>
+/// The result is created with the arguments, reading its id, reason and duration; its audio is only copied on the
+/// first <see cref="SpeechSynthesisResult::GetAudioData"/>. Streaming consumers that must not allocate per chunk
+/// opt in by connecting <see cref="SpeechSynthesizer::SynthesizingAudio"/> instead of Synthesizing.
+/// </remarks>
 class SpeechSynthesisEventArgs : public EventArgs
 {
 private:
@@ -67,4 +75,115 @@ private:
 
 };
 
+/// <summary>
+/// Class for the arguments of <see cref="SpeechSynthesizer::SynthesizingAudio"/>, which carry a chunk of synthesized audio.
+/// </summary>
+/// <remarks>
+/// The arguments live on the stack of the native callback and are always delivered synchronously; nothing is allocated
+/// per chunk once the thread's audio buffer has grown to the chunk size. Unlike <see cref="SpeechSynthesisEventArgs"/>,
+/// no <see cref="SpeechSynthesisResult"/> is created; use <see cref="CopyAudio"/> to keep the audio past the callback.
+/// </remarks>
+class SpeechSynthesisAudioEventArgs : public EventArgs
+{
+public:
+
+    /// <summary>
+    /// Constructor.
+    /// </summary>
+    /// <param name="hevent">Event handle</param>
+    explicit SpeechSynthesisAudioEventArgs(SPXEVENTHANDLE hevent) :
+        SpeechSynthesisAudioEventArgs(hevent, true)
+    {
+    }
+
+    /*! \cond PROTECTED */
+
+    /// <summary>
+    /// Constructor.
+    /// </summary>
+    /// <param name="hevent">Event handle</param>
+    /// <param name="ownsEvent">Whether the event handle is released with the arguments.</param>
+    SpeechSynthesisAudioEventArgs(SPXEVENTHANDLE hevent, bool ownsEvent) :
+        m_hevent(ownsEvent ? hevent : SPXHANDLE_INVALID)
+    {
+        SPX_THROW_ON_FAIL(synthesizer_synthesis_event_get_result(hevent, &m_hresult));
+    }
+
+    /*! \endcond */
+
+    /// <inheritdoc/>
+    virtual ~SpeechSynthesisAudioEventArgs()
+    {
+        SPX_REPORT_ON_FAIL(synthesizer_result_handle_release(m_hresult));
+        if (m_hevent != SPXHANDLE_INVALID)
+        {
+            SPX_REPORT_ON_FAIL(synthesizer_event_handle_release(m_hevent));
+        }
+    }
+
+    /// <summary>
+    /// Gets the reason of the event's result.
+    /// </summary>
+    /// <returns>The result reason.</returns>
+    ResultReason GetReason() const
+    {
+        Result_Reason reason;
+        SPX_THROW_ON_FAIL(synth_result_get_reason(m_hresult, &reason));
+        return static_cast<ResultReason>(reason);
+    }
+
+    /// <summary>
+    /// Gets the audio carried by this event.
+    /// The bytes are held in a buffer of the calling thread and only valid for the duration of the callback.
+    /// </summary>
+    /// <returns>A view of the audio bytes.</returns>
+    SpeechSynthesisAudioSpan GetAudio() const
+    {
+        if (m_audio == nullptr)
+        {
+            uint32_t audioLength = 0;
+            uint64_t audioDuration = 0;
+            SPX_THROW_ON_FAIL(synth_result_get_audio_length_duration(m_hresult, &audioLength, &audioDuration));
+
+            auto& buffer = ThreadAudioBuffer();
+            if (buffer.size() < audioLength)
+            {
+                buffer.resize(audioLength);
+            }
+            if (audioLength > 0)
+            {
+                SPX_THROW_ON_FAIL(synth_result_get_audio_data(m_hresult, buffer.data(), audioLength, &m_audioSize));
+            }
+            m_audio = buffer.data();
+        }
+        return SpeechSynthesisAudioSpan(m_audio, m_audioSize);
+    }
+
+    /// <summary>
+    /// Copies the audio carried by this event into a buffer owned by the caller.
+    /// </summary>
+    /// <returns>The audio bytes.</returns>
+    std::vector<uint8_t> CopyAudio() const
+    {
+        auto audio = GetAudio();
+        return std::vector<uint8_t>(audio.begin(), audio.end());
+    }
+
+private:
+
+    DISABLE_DEFAULT_CTORS(SpeechSynthesisAudioEventArgs);
+
+    static std::vector<uint8_t>& ThreadAudioBuffer()
+    {
+        static thread_local std::vector<uint8_t> buffer;
+        return buffer;
+    }
+
+    SPXEVENTHANDLE m_hevent;
+    SPXRESULTHANDLE m_hresult = SPXHANDLE_INVALID;
+
+    mutable const uint8_t* m_audio = nullptr;
+    mutable uint32_t m_audioSize = 0;
+};
+
 } } } // Microsoft::CognitiveServices::Speech
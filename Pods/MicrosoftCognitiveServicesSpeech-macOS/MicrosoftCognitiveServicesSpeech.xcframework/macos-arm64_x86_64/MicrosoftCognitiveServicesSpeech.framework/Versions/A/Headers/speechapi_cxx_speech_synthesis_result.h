@@ -6,13 +6,21 @@
 //
 
 #pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <chrono>
+#include <vector>
 #include "speechapi_cxx_common.h"
 #include "speechapi_cxx_string_helpers.h"
 #include "speechapi_cxx_enums.h"
 #include "speechapi_cxx_properties.h"
 #include "speechapi_cxx_audio_data_stream.h"
+#include "speechapi_cxx_smart_handle.h"
 #include "speechapi_c_result.h"
 #include "speechapi_c_synthesizer.h"
 
@@ -20,12 +28,74 @@ namespace Microsoft {
 namespace CognitiveServices {
 namespace Speech {
 
+/// <summary>
+/// Read-only view of synthesized audio bytes that are owned elsewhere.
+/// </summary>
+class SpeechSynthesisAudioSpan
+{
+public:
+
+    /// <summary>
+    /// Constructs an empty view.
+    /// </summary>
+    SpeechSynthesisAudioSpan() : m_data(nullptr), m_size(0)
+    {
+    }
+
+    /// <summary>
+    /// Constructs a view over the given bytes.
+    /// </summary>
+    /// <param name="data">Pointer to the first byte.</param>
+    /// <param name="size">Number of bytes.</param>
+    SpeechSynthesisAudioSpan(const uint8_t* data, size_t size) : m_data(data), m_size(size)
+    {
+    }
+
+    /// <summary>
+    /// Pointer to the first byte.
+    /// </summary>
+    /// <returns>The audio bytes.</returns>
+    const uint8_t* Data() const { return m_data; }
+
+    /// <summary>
+    /// Number of bytes.
+    /// </summary>
+    /// <returns>The size in bytes.</returns>
+    size_t Size() const { return m_size; }
+
+    /// <summary>
+    /// Checks if the view is empty.
+    /// </summary>
+    /// <returns>true if there are no bytes.</returns>
+    bool Empty() const { return m_size == 0; }
+
+    /// <summary>
+    /// Iterator to the first byte.
+    /// </summary>
+    const uint8_t* begin() const { return m_data; }
+
+    /// <summary>
+    /// Iterator past the last byte.
+    /// </summary>
+    const uint8_t* end() const { return m_data + m_size; }
+
+private:
+
+    const uint8_t* m_data;
+    size_t m_size;
+};
+
 /// <summary>
 /// Contains information about result from text-to-speech synthesis.
 /// Added in version 1.4.0
 /// </summary>
+/// <remarks>
+/// The synthesized audio stays in the native result until <see cref="GetAudioData"/> is called. Consumers that stream the audio
+/// through <see cref="AudioDataStream::FromResult"/> or <see cref="ReadAudio"/> never pay for a copy held by this object.
+/// </remarks>
 class SpeechSynthesisResult
 {
+    friend class SpeechSynthesizer;
 private:
 
     /// <summary>
@@ -46,6 +116,8 @@ private:
             return hpropbag;
         }())
         {
+            // Results do not change once received.
+            EnableReadCache();
         }
     };
 
@@ -82,18 +154,9 @@ public:
         SPX_THROW_ON_FAIL(synth_result_get_reason(hresult, &resultReason));
         m_reason = static_cast<ResultReason>(resultReason);
 
-        uint32_t audioLength = 0;
         uint64_t audioDuration = 0;
-        SPX_THROW_ON_FAIL(synth_result_get_audio_length_duration(m_hresult, &audioLength, &audioDuration));
+        SPX_THROW_ON_FAIL(synth_result_get_audio_length_duration(m_hresult, &m_audioLength, &audioDuration));
         m_audioDuration = std::chrono::milliseconds(audioDuration);
-
-        m_audioData = std::make_shared<std::vector<uint8_t>>(audioLength);
-
-        if (audioLength > 0)
-        {
-            uint32_t filledSize = 0;
-            SPX_THROW_ON_FAIL(synth_result_get_audio_data(m_hresult, m_audioData->data(), audioLength, &filledSize));
-        }
     }
 
     /// <summary>
@@ -102,18 +165,68 @@ public:
     /// <returns>Length of synthesized audio</returns>
     uint32_t GetAudioLength()
     {
-        return static_cast<uint32_t>(m_audioData->size());
+        return m_audioLength;
     }
 
     /// <summary>
-    /// Gets the synthesized audio.
+    /// Gets the synthesized audio. The audio is copied out of the native result on the first call.
     /// </summary>
     /// <returns>Synthesized audio data</returns>
     std::shared_ptr<std::vector<uint8_t>> GetAudioData()
     {
+        std::lock_guard<std::mutex> lock(m_audioMutex);
+        if (m_audioData == nullptr)
+        {
+            auto audioData = std::make_shared<std::vector<uint8_t>>(m_audioLength);
+            if (m_audioLength > 0)
+            {
+                uint32_t filledSize = 0;
+                SPX_THROW_ON_FAIL(synth_result_get_audio_data(m_hresult, audioData->data(), m_audioLength, &filledSize));
+                audioData->resize(filledSize);
+            }
+            m_audioData = audioData;
+        }
         return m_audioData;
     }
 
+    /// <summary>
+    /// Reads part of the synthesized audio into the given buffer, without copying the whole audio into this object.
+    /// Concurrent calls on the same result are serialized, since they share one native stream.
+    /// </summary>
+    /// <param name="offset">Byte offset from the start of the audio.</param>
+    /// <param name="buffer">A buffer to receive the audio.</param>
+    /// <param name="bufferSize">Size of the buffer.</param>
+    /// <returns>Number of bytes filled, 0 if <paramref name="offset"/> is at or past the end of the audio.</returns>
+    uint32_t ReadAudio(uint32_t offset, uint8_t* buffer, uint32_t bufferSize)
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, buffer == nullptr && bufferSize > 0);
+        if (offset >= m_audioLength || bufferSize == 0)
+        {
+            return 0;
+        }
+
+        std::lock_guard<std::mutex> lock(m_audioMutex);
+        if (m_audioData != nullptr)
+        {
+            if (offset >= m_audioData->size())
+            {
+                return 0;
+            }
+            auto filledSize = static_cast<uint32_t>(std::min<size_t>(bufferSize, m_audioData->size() - offset));
+            std::memcpy(buffer, m_audioData->data() + offset, filledSize);
+            return filledSize;
+        }
+
+        if (m_audioReader == SPXHANDLE_INVALID)
+        {
+            SPX_THROW_ON_FAIL(audio_data_stream_create_from_result(&m_audioReader, m_hresult));
+        }
+
+        uint32_t filledSize = 0;
+        SPX_THROW_ON_FAIL(audio_data_stream_read_from_position(m_audioReader, buffer, bufferSize, offset, &filledSize));
+        return filledSize;
+    }
+
     /// <summary>
     /// Explicit conversion operator.
     /// </summary>
@@ -126,6 +239,7 @@ public:
     ~SpeechSynthesisResult()
     {
         SPX_DBG_TRACE_SCOPE(__FUNCTION__, __FUNCTION__);
+        m_audioReader.reset();
         synthesizer_result_handle_release(m_hresult);
     }
 
@@ -165,10 +279,25 @@ private:
     ResultReason m_reason;
 
     /// <summary>
-    /// Internal member variable that holds the audio data
+    /// Internal member variable that holds the audio length in bytes.
+    /// </summary>
+    uint32_t m_audioLength{ 0 };
+
+    /// <summary>
+    /// Internal member variable that guards the audio data and the native stream.
+    /// </summary>
+    std::mutex m_audioMutex;
+
+    /// <summary>
+    /// Internal member variable that holds the audio data, once copied out of the native result.
     /// </summary>
     std::shared_ptr<std::vector<uint8_t>> m_audioData;
 
+    /// <summary>
+    /// Internal member variable that holds the native stream <see cref="ReadAudio"/> reads from.
+    /// </summary>
+    SmartHandle<SPXAUDIOSTREAMHANDLE, &audio_data_stream_release> m_audioReader;
+
     /// <summary>
     /// Internal member variable that holds the audio duration
     // </summary>
@@ -6,9 +6,18 @@
 //
 
 #pragma once
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <exception>
 #include <future>
 #include <memory>
+#include <mutex>
+#include <vector>
 #include "speechapi_cxx_common.h"
+#include "speechapi_cxx_async_executor.h"
+#include "speechapi_cxx_async_operation.h"
+#include "speechapi_cxx_cancellation_token.h"
 #include "speechapi_cxx_string_helpers.h"
 #include "speechapi_c.h"
 #include "speechapi_cxx_properties.h"
@@ -22,6 +31,7 @@
 #include "speechapi_cxx_speech_synthesis_word_boundary_eventargs.h"
 #include "speechapi_cxx_speech_synthesis_viseme_eventargs.h"
 #include "speechapi_cxx_speech_synthesis_bookmark_eventargs.h"
+#include "speechapi_cxx_speech_synthesis_batch_eventargs.h"
 
 namespace Microsoft {
 namespace CognitiveServices {
@@ -219,10 +229,9 @@ public:
     /// <returns>A smart pointer wrapping a speech synthesis result.</returns>
     std::shared_ptr<SpeechSynthesisResult> SpeakText(const std::string& text)
     {
-        SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
-        SPX_THROW_ON_FAIL(::synthesizer_speak_text(m_hsynth, text.data(), static_cast<uint32_t>(text.length()), &hresult));
-
-        return std::make_shared<SpeechSynthesisResult>(hresult);
+        return SpeakInternal([this, &text](SPXASYNCHANDLE* phasync) {
+            return ::synthesizer_speak_text_async(m_hsynth, text.data(), static_cast<uint32_t>(text.length()), phasync);
+        });
     }
 
     /// <summary>
@@ -243,10 +252,9 @@ public:
     /// <returns>A smart pointer wrapping a speech synthesis result.</returns>
     std::shared_ptr<SpeechSynthesisResult> SpeakSsml(const std::string& ssml)
     {
-        SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
-        SPX_THROW_ON_FAIL(::synthesizer_speak_ssml(m_hsynth, ssml.data(), static_cast<uint32_t>(ssml.length()), &hresult));
-
-        return std::make_shared<SpeechSynthesisResult>(hresult);
+        return SpeakInternal([this, &ssml](SPXASYNCHANDLE* phasync) {
+            return ::synthesizer_speak_ssml_async(m_hsynth, ssml.data(), static_cast<uint32_t>(ssml.length()), phasync);
+        });
     }
 
     /// <summary>
@@ -270,10 +278,9 @@ public:
     /// <returns>A smart pointer wrapping a speech synthesis result.</returns>
     std::shared_ptr<SpeechSynthesisResult> Speak(const std::shared_ptr<SpeechSynthesisRequest>& request)
     {
-        SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
-        SPX_THROW_ON_FAIL(::synthesizer_speak_request(m_hsynth, Utils::HandleOrInvalid<SPXREQUESTHANDLE, SpeechSynthesisRequest>(request), &hresult));
-
-        return std::make_shared<SpeechSynthesisResult>(hresult);
+        return SpeakInternal([this, &request](SPXASYNCHANDLE* phasync) {
+            return ::synthesizer_speak_request_async(m_hsynth, Utils::HandleOrInvalid<SPXREQUESTHANDLE, SpeechSynthesisRequest>(request), phasync);
+        });
     }
 
     /// <summary>
@@ -283,22 +290,11 @@ public:
     /// <returns>An asynchronous operation representing the synthesis. It returns a value of <see cref="SpeechSynthesisResult"/> as result.</returns>
     std::future<std::shared_ptr<SpeechSynthesisResult>> SpeakTextAsync(const std::string& text)
     {
-        auto keepAlive = this->shared_from_this();
-
-        auto future = std::async(std::launch::async, [keepAlive, this, text]() -> std::shared_ptr<SpeechSynthesisResult> {
-            SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
-            SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
-            SPX_THROW_ON_FAIL(::synthesizer_speak_text_async(m_hsynth, text.data(), static_cast<uint32_t>(text.length()), &hasync));
-            SPX_EXITFN_ON_FAIL(::synthesizer_speak_async_wait_for(hasync, UINT32_MAX, &hresult));
-
-        SPX_EXITFN_CLEANUP:
-            auto releaseHr = synthesizer_async_handle_release(hasync);
-            SPX_REPORT_ON_FAIL(releaseHr);
-
-            return std::make_shared<SpeechSynthesisResult>(hresult);
-        });
-
-        return future;
+        SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
+        auto startHr = StartRequest([this, &text](SPXASYNCHANDLE* phasync) {
+            return ::synthesizer_speak_text_async(m_hsynth, text.data(), static_cast<uint32_t>(text.length()), phasync);
+        }, &hasync);
+        return WaitForSpeakAsync(startHr, hasync);
     }
 
     /// <summary>
@@ -319,22 +315,11 @@ public:
     /// <returns>An asynchronous operation representing the synthesis. It returns a value of <see cref="SpeechSynthesisResult"/> as result.</returns>
     std::future<std::shared_ptr<SpeechSynthesisResult>> SpeakSsmlAsync(const std::string& ssml)
     {
-        auto keepAlive = this->shared_from_this();
-
-        auto future = std::async(std::launch::async, [keepAlive, this, ssml]() -> std::shared_ptr<SpeechSynthesisResult> {
-            SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
-            SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
-            SPX_THROW_ON_FAIL(::synthesizer_speak_ssml_async(m_hsynth, ssml.data(), static_cast<uint32_t>(ssml.length()), &hasync));
-            SPX_EXITFN_ON_FAIL(::synthesizer_speak_async_wait_for(hasync, UINT32_MAX, &hresult));
-
-        SPX_EXITFN_CLEANUP:
-            auto releaseHr = synthesizer_async_handle_release(hasync);
-            SPX_REPORT_ON_FAIL(releaseHr);
-
-            return std::make_shared<SpeechSynthesisResult>(hresult);
-        });
-
-        return future;
+        SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
+        auto startHr = StartRequest([this, &ssml](SPXASYNCHANDLE* phasync) {
+            return ::synthesizer_speak_ssml_async(m_hsynth, ssml.data(), static_cast<uint32_t>(ssml.length()), phasync);
+        }, &hasync);
+        return WaitForSpeakAsync(startHr, hasync);
     }
 
     /// <summary>
@@ -358,22 +343,11 @@ public:
     /// <returns>An asynchronous operation representing the synthesis. It returns a value of <see cref="SpeechSynthesisResult"/> as result.</returns>
     std::future<std::shared_ptr<SpeechSynthesisResult>> SpeakAsync(const std::shared_ptr<SpeechSynthesisRequest>& request)
     {
-        auto keepAlive = this->shared_from_this();
-
-        auto future = std::async(std::launch::async, [keepAlive, this, request]() -> std::shared_ptr<SpeechSynthesisResult> {
-            SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
-            SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
-            SPX_THROW_ON_FAIL(::synthesizer_speak_request_async(m_hsynth, Utils::HandleOrInvalid<SPXREQUESTHANDLE, SpeechSynthesisRequest>(request), &hasync));
-            SPX_EXITFN_ON_FAIL(::synthesizer_speak_async_wait_for(hasync, UINT32_MAX, &hresult));
-
-        SPX_EXITFN_CLEANUP:
-            auto releaseHr = synthesizer_async_handle_release(hasync);
-            SPX_REPORT_ON_FAIL(releaseHr);
-
-            return std::make_shared<SpeechSynthesisResult>(hresult);
-        });
-
-        return future;
+        SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
+        auto startHr = StartRequest([this, &request](SPXASYNCHANDLE* phasync) {
+            return ::synthesizer_speak_request_async(m_hsynth, Utils::HandleOrInvalid<SPXREQUESTHANDLE, SpeechSynthesisRequest>(request), phasync);
+        }, &hasync);
+        return WaitForSpeakAsync(startHr, hasync);
     }
 
     /// <summary>
@@ -383,10 +357,9 @@ public:
     /// <returns>A smart pointer wrapping a speech synthesis result.</returns>
     std::shared_ptr<SpeechSynthesisResult> StartSpeakingText(const std::string& text)
     {
-        SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
-        SPX_THROW_ON_FAIL(::synthesizer_start_speaking_text(m_hsynth, text.data(), static_cast<uint32_t>(text.length()), &hresult));
-
-        return std::make_shared<SpeechSynthesisResult>(hresult);
+        return SpeakInternal([this, &text](SPXASYNCHANDLE* phasync) {
+            return ::synthesizer_start_speaking_text_async(m_hsynth, text.data(), static_cast<uint32_t>(text.length()), phasync);
+        });
     }
 
     /// <summary>
@@ -407,10 +380,9 @@ public:
     /// <returns>A smart pointer wrapping a speech synthesis result.</returns>
     std::shared_ptr<SpeechSynthesisResult> StartSpeakingSsml(const std::string& ssml)
     {
-        SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
-        SPX_THROW_ON_FAIL(::synthesizer_start_speaking_ssml(m_hsynth, ssml.data(), static_cast<uint32_t>(ssml.length()), &hresult));
-
-        return std::make_shared<SpeechSynthesisResult>(hresult);
+        return SpeakInternal([this, &ssml](SPXASYNCHANDLE* phasync) {
+            return ::synthesizer_start_speaking_ssml_async(m_hsynth, ssml.data(), static_cast<uint32_t>(ssml.length()), phasync);
+        });
     }
 
     /// <summary>
@@ -434,8 +406,12 @@ public:
     /// <returns>A smart pointer wrapping a speech synthesis result.</returns>
     std::shared_ptr<SpeechSynthesisResult> StartSpeaking(const std::shared_ptr<SpeechSynthesisRequest>& request)
     {
+        // There is no asynchronous variant to start it with, so other requests are started once this one started.
+        std::unique_lock<std::mutex> startLock(m_startMutex);
         SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
         SPX_THROW_ON_FAIL(::synthesizer_start_speaking_request(m_hsynth, Utils::HandleOrInvalid<SPXREQUESTHANDLE, SpeechSynthesisRequest>(request), &hresult));
+        m_startedRequests++;
+        startLock.unlock();
 
         return std::make_shared<SpeechSynthesisResult>(hresult);
     }
@@ -447,22 +423,11 @@ public:
     /// <returns>An asynchronous operation representing the synthesis. It returns a value of <see cref="SpeechSynthesisResult"/> as result.</returns>
     std::future<std::shared_ptr<SpeechSynthesisResult>> StartSpeakingTextAsync(const std::string& text)
     {
-        auto keepAlive = this->shared_from_this();
-
-        auto future = std::async(std::launch::async, [keepAlive, this, text]() -> std::shared_ptr<SpeechSynthesisResult> {
-            SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
-            SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
-            SPX_THROW_ON_FAIL(::synthesizer_start_speaking_text_async(m_hsynth, text.data(), static_cast<uint32_t>(text.length()), &hasync));
-            SPX_EXITFN_ON_FAIL(::synthesizer_speak_async_wait_for(hasync, UINT32_MAX, &hresult));
-
-        SPX_EXITFN_CLEANUP:
-            auto releaseHr = synthesizer_async_handle_release(hasync);
-            SPX_REPORT_ON_FAIL(releaseHr);
-
-            return std::make_shared<SpeechSynthesisResult>(hresult);
-        });
-
-        return future;
+        SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
+        auto startHr = StartRequest([this, &text](SPXASYNCHANDLE* phasync) {
+            return ::synthesizer_start_speaking_text_async(m_hsynth, text.data(), static_cast<uint32_t>(text.length()), phasync);
+        }, &hasync);
+        return WaitForSpeakAsync(startHr, hasync);
     }
 
     /// <summary>
@@ -483,22 +448,11 @@ public:
     /// <returns>An asynchronous operation representing the synthesis. It returns a value of <see cref="SpeechSynthesisResult"/> as result.</returns>
     std::future<std::shared_ptr<SpeechSynthesisResult>> StartSpeakingSsmlAsync(const std::string& ssml)
     {
-        auto keepAlive = this->shared_from_this();
-
-        auto future = std::async(std::launch::async, [keepAlive, this, ssml]() -> std::shared_ptr<SpeechSynthesisResult> {
-            SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
-            SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
-            SPX_THROW_ON_FAIL(::synthesizer_start_speaking_ssml_async(m_hsynth, ssml.data(), static_cast<uint32_t>(ssml.length()), &hasync));
-            SPX_EXITFN_ON_FAIL(::synthesizer_speak_async_wait_for(hasync, UINT32_MAX, &hresult));
-
-        SPX_EXITFN_CLEANUP:
-            auto releaseHr = synthesizer_async_handle_release(hasync);
-            SPX_REPORT_ON_FAIL(releaseHr);
-
-            return std::make_shared<SpeechSynthesisResult>(hresult);
-        });
-
-        return future;
+        SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
+        auto startHr = StartRequest([this, &ssml](SPXASYNCHANDLE* phasync) {
+            return ::synthesizer_start_speaking_ssml_async(m_hsynth, ssml.data(), static_cast<uint32_t>(ssml.length()), phasync);
+        }, &hasync);
+        return WaitForSpeakAsync(startHr, hasync);
     }
 
     /// <summary>
@@ -521,9 +475,13 @@ public:
     {
         auto keepAlive = this->shared_from_this();
 
-        auto future = std::async(std::launch::async, [keepAlive, this]() -> void {
-            SPXASYNCHANDLE hasyncStop = SPXHANDLE_INVALID;
-            SPX_THROW_ON_FAIL(::synthesizer_stop_speaking_async(m_hsynth, &hasyncStop));
+        // The stop is requested on the calling thread, so that it does not wait for an executor thread behind the
+        // synthesis requests it ends; only the wait for its completion runs on the executor.
+        SPXASYNCHANDLE hasyncStop = SPXHANDLE_INVALID;
+        auto stopHr = ::synthesizer_stop_speaking_async(m_hsynth, &hasyncStop);
+
+        auto future = Details::RunAsync([keepAlive, stopHr, hasyncStop]() -> void {
+            SPX_THROW_ON_FAIL(stopHr);
             SPX_EXITFN_ON_FAIL(::synthesizer_stop_speaking_async_wait_for(hasyncStop, UINT32_MAX));
 
         SPX_EXITFN_CLEANUP:
@@ -544,10 +502,13 @@ public:
     {
         const auto keepAlive = this->shared_from_this();
 
-        auto future = std::async(std::launch::async, [keepAlive, locale, this]() -> std::shared_ptr<SynthesisVoicesResult> {
+        // Started on the calling thread like the synthesis requests; only the wait runs on the executor.
+        SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
+        auto startHr = ::synthesizer_get_voices_list_async(m_hsynth, Utils::ToUTF8(locale).c_str(), &hasync);
+
+        auto future = Details::RunAsync([keepAlive, startHr, hasync]() -> std::shared_ptr<SynthesisVoicesResult> {
+            SPX_THROW_ON_FAIL(startHr);
             SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
-            SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
-            SPX_THROW_ON_FAIL(::synthesizer_get_voices_list_async(m_hsynth, Utils::ToUTF8(locale).c_str(), &hasync));
             SPX_EXITFN_ON_FAIL(::synthesizer_get_voices_list_async_wait_for(hasync, UINT32_MAX, &hresult));
 
         SPX_EXITFN_CLEANUP:
@@ -560,6 +521,243 @@ public:
         return future;
     }
 
+    /// <summary>
+    /// Execute the speech synthesis on plain text, asynchronously, until the given token expires.
+    /// On expiry the synthesizer is stopped as by <see cref="StopSpeakingAsync"/>, see <see cref="CancellationToken"/>.
+    /// </summary>
+    /// <param name="text">The plain text for synthesis.</param>
+    /// <param name="token">The token bounding the wait.</param>
+    /// <returns>An asynchronous operation representing the synthesis. It returns a value of <see cref="SpeechSynthesisResult"/> as result.</returns>
+    std::future<std::shared_ptr<SpeechSynthesisResult>> SpeakTextAsync(const std::string& text, const CancellationToken& token)
+    {
+        return SpeakAsyncInternal([this, text](SPXASYNCHANDLE* phasync) {
+            return ::synthesizer_speak_text_async(m_hsynth, text.data(), static_cast<uint32_t>(text.length()), phasync);
+        }, token);
+    }
+
+    /// <summary>
+    /// Execute the speech synthesis on SSML, asynchronously, until the given token expires.
+    /// On expiry the synthesizer is stopped as by <see cref="StopSpeakingAsync"/>, see <see cref="CancellationToken"/>.
+    /// </summary>
+    /// <param name="ssml">The SSML for synthesis.</param>
+    /// <param name="token">The token bounding the wait.</param>
+    /// <returns>An asynchronous operation representing the synthesis. It returns a value of <see cref="SpeechSynthesisResult"/> as result.</returns>
+    std::future<std::shared_ptr<SpeechSynthesisResult>> SpeakSsmlAsync(const std::string& ssml, const CancellationToken& token)
+    {
+        return SpeakAsyncInternal([this, ssml](SPXASYNCHANDLE* phasync) {
+            return ::synthesizer_speak_ssml_async(m_hsynth, ssml.data(), static_cast<uint32_t>(ssml.length()), phasync);
+        }, token);
+    }
+
+    /// <summary>
+    /// Execute the speech synthesis on a request, asynchronously, until the given token expires.
+    /// On expiry the synthesizer is stopped as by <see cref="StopSpeakingAsync"/>, see <see cref="CancellationToken"/>.
+    /// </summary>
+    /// <param name="request">The synthesis request.</param>
+    /// <param name="token">The token bounding the wait.</param>
+    /// <returns>An asynchronous operation representing the synthesis. It returns a value of <see cref="SpeechSynthesisResult"/> as result.</returns>
+    std::future<std::shared_ptr<SpeechSynthesisResult>> SpeakAsync(const std::shared_ptr<SpeechSynthesisRequest>& request, const CancellationToken& token)
+    {
+        return SpeakAsyncInternal([this, request](SPXASYNCHANDLE* phasync) {
+            return ::synthesizer_speak_request_async(m_hsynth, Utils::HandleOrInvalid<SPXREQUESTHANDLE, SpeechSynthesisRequest>(request), phasync);
+        }, token);
+    }
+
+    /// <summary>
+    /// Start the speech synthesis on plain text, asynchronously, until the given token expires.
+    /// On expiry the synthesizer is stopped as by <see cref="StopSpeakingAsync"/>, see <see cref="CancellationToken"/>.
+    /// </summary>
+    /// <param name="text">The plain text for synthesis.</param>
+    /// <param name="token">The token bounding the wait.</param>
+    /// <returns>An asynchronous operation representing the synthesis. It returns a value of <see cref="SpeechSynthesisResult"/> as result.</returns>
+    std::future<std::shared_ptr<SpeechSynthesisResult>> StartSpeakingTextAsync(const std::string& text, const CancellationToken& token)
+    {
+        return SpeakAsyncInternal([this, text](SPXASYNCHANDLE* phasync) {
+            return ::synthesizer_start_speaking_text_async(m_hsynth, text.data(), static_cast<uint32_t>(text.length()), phasync);
+        }, token);
+    }
+
+    /// <summary>
+    /// Start the speech synthesis on SSML, asynchronously, until the given token expires.
+    /// On expiry the synthesizer is stopped as by <see cref="StopSpeakingAsync"/>, see <see cref="CancellationToken"/>.
+    /// </summary>
+    /// <param name="ssml">The SSML for synthesis.</param>
+    /// <param name="token">The token bounding the wait.</param>
+    /// <returns>An asynchronous operation representing the synthesis. It returns a value of <see cref="SpeechSynthesisResult"/> as result.</returns>
+    std::future<std::shared_ptr<SpeechSynthesisResult>> StartSpeakingSsmlAsync(const std::string& ssml, const CancellationToken& token)
+    {
+        return SpeakAsyncInternal([this, ssml](SPXASYNCHANDLE* phasync) {
+            return ::synthesizer_start_speaking_ssml_async(m_hsynth, ssml.data(), static_cast<uint32_t>(ssml.length()), phasync);
+        }, token);
+    }
+
+    /// <summary>
+    /// Stop the speech synthesis, asynchronously, until the given token expires.
+    /// </summary>
+    /// <param name="token">The token bounding the wait.</param>
+    /// <returns>An empty future. It throws an exception with SPXERR_TIMEOUT if the token expires first.</returns>
+    std::future<void> StopSpeakingAsync(const CancellationToken& token)
+    {
+        auto keepAlive = this->shared_from_this();
+
+        // As in StopSpeakingAsync(), the stop is requested on the calling thread.
+        SPXASYNCHANDLE hasyncStop = SPXHANDLE_INVALID;
+        auto stopHr = ::synthesizer_stop_speaking_async(m_hsynth, &hasyncStop);
+
+        auto future = Details::RunAsync([keepAlive, stopHr, hasyncStop, token]() -> void {
+            SPX_THROW_ON_FAIL(stopHr);
+            auto hr = Details::WaitForAsync([hasyncStop](uint32_t milliseconds) {
+                return ::synthesizer_stop_speaking_async_wait_for(hasyncStop, milliseconds);
+            }, token);
+            if (hr == SPXERR_TIMEOUT)
+            {
+                // The stop is still running; its handle may only be released once it ended.
+                Details::FinishInBackground([keepAlive, hasyncStop]() {
+                    SPX_REPORT_ON_FAIL(::synthesizer_stop_speaking_async_wait_for(hasyncStop, UINT32_MAX));
+                    SPX_REPORT_ON_FAIL(synthesizer_async_handle_release(hasyncStop));
+                });
+                SPX_THROW_HR(hr);
+            }
+
+            SPX_REPORT_ON_FAIL(synthesizer_async_handle_release(hasyncStop));
+            SPX_THROW_ON_FAIL(hr);
+        });
+
+        return future;
+    }
+
+    /// <summary>
+    /// Get the available voices, asynchronously, until the given token expires.
+    /// </summary>
+    /// <param name="locale">Specify the locale of voices, in BCP-47 format; or leave it empty to get all available voices.</param>
+    /// <param name="token">The token bounding the wait.</param>
+    /// <returns>An asynchronous operation representing the voices list. It throws an exception with SPXERR_TIMEOUT if the token expires first.</returns>
+    std::future<std::shared_ptr<SynthesisVoicesResult>> GetVoicesAsync(const SPXSTRING& locale, const CancellationToken& token)
+    {
+        const auto keepAlive = this->shared_from_this();
+
+        auto future = Details::RunAsync([keepAlive, locale, token, this]() -> std::shared_ptr<SynthesisVoicesResult> {
+            SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
+            SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
+            SPX_THROW_ON_FAIL(::synthesizer_get_voices_list_async(m_hsynth, Utils::ToUTF8(locale).c_str(), &hasync));
+            auto hr = Details::WaitForAsync([hasync, &hresult](uint32_t milliseconds) {
+                return ::synthesizer_get_voices_list_async_wait_for(hasync, milliseconds, &hresult);
+            }, token);
+            if (hr == SPXERR_TIMEOUT)
+            {
+                // The voice listing cannot be stopped; release its handle and late result once it ended.
+                Details::FinishInBackground([keepAlive, hasync]() {
+                    SPXRESULTHANDLE hlateResult = SPXHANDLE_INVALID;
+                    if (SPX_SUCCEEDED(::synthesizer_get_voices_list_async_wait_for(hasync, UINT32_MAX, &hlateResult)))
+                    {
+                        SPX_REPORT_ON_FAIL(synthesizer_result_handle_release(hlateResult));
+                    }
+                    SPX_REPORT_ON_FAIL(synthesizer_async_handle_release(hasync));
+                });
+                SPX_THROW_HR(hr);
+            }
+
+            SPX_REPORT_ON_FAIL(synthesizer_async_handle_release(hasync));
+            SPX_THROW_ON_FAIL(hr);
+
+            return std::make_shared<SynthesisVoicesResult>(hresult);
+        });
+
+        return future;
+    }
+
+    /// <summary>
+    /// Execute the speech synthesis on SSML, as an operation that can be awaited with co_await.
+    /// Unlike <see cref="SpeakSsmlAsync"/>, no thread waits for the synthesis: the operation is completed by the
+    /// synthesis completed or canceled event of the request, and the awaiting coroutine is resumed on the default <see cref="AsyncExecutor"/>.
+    /// </summary>
+    /// <param name="ssml">The SSML for synthesis.</param>
+    /// <returns>An awaitable operation representing the synthesis. It returns a value of <see cref="SpeechSynthesisResult"/> as result.</returns>
+    AsyncOperation<std::shared_ptr<SpeechSynthesisResult>> SpeakSsmlAwaitable(const std::string& ssml)
+    {
+        return SpeakAwaitableInternal([this, &ssml](SPXASYNCHANDLE* phasync) {
+            return ::synthesizer_speak_ssml_async(m_hsynth, ssml.data(), static_cast<uint32_t>(ssml.length()), phasync);
+        }, false);
+    }
+
+    /// <summary>
+    /// Execute the speech synthesis on SSML, as an operation that can be awaited with co_await.
+    /// </summary>
+    /// <param name="ssml">The SSML for synthesis.</param>
+    /// <returns>An awaitable operation representing the synthesis. It returns a value of <see cref="SpeechSynthesisResult"/> as result.</returns>
+    AsyncOperation<std::shared_ptr<SpeechSynthesisResult>> SpeakSsmlAwaitable(const std::wstring& ssml)
+    {
+        return SpeakSsmlAwaitable(Utils::ToUTF8(ssml));
+    }
+
+    /// <summary>
+    /// Execute the speech synthesis on a request, as an operation that can be awaited with co_await.
+    /// See <see cref="SpeakSsmlAwaitable"/> for how completion is detected.
+    /// </summary>
+    /// <param name="request">The synthesis request.</param>
+    /// <returns>An awaitable operation representing the synthesis. It returns a value of <see cref="SpeechSynthesisResult"/> as result.</returns>
+    AsyncOperation<std::shared_ptr<SpeechSynthesisResult>> SpeakAwaitable(const std::shared_ptr<SpeechSynthesisRequest>& request)
+    {
+        return SpeakAwaitableInternal([this, &request](SPXASYNCHANDLE* phasync) {
+            return ::synthesizer_speak_request_async(m_hsynth, Utils::HandleOrInvalid<SPXREQUESTHANDLE, SpeechSynthesisRequest>(request), phasync);
+        }, false);
+    }
+
+    /// <summary>
+    /// Start the speech synthesis on SSML, as an operation that can be awaited with co_await.
+    /// The operation is completed by the synthesis started event of the request, or by its canceled event if it ends before it starts.
+    /// </summary>
+    /// <param name="ssml">The SSML for synthesis.</param>
+    /// <returns>An awaitable operation representing the synthesis. It returns a value of <see cref="SpeechSynthesisResult"/> as result.</returns>
+    AsyncOperation<std::shared_ptr<SpeechSynthesisResult>> StartSpeakingSsmlAwaitable(const std::string& ssml)
+    {
+        return SpeakAwaitableInternal([this, &ssml](SPXASYNCHANDLE* phasync) {
+            return ::synthesizer_start_speaking_ssml_async(m_hsynth, ssml.data(), static_cast<uint32_t>(ssml.length()), phasync);
+        }, true);
+    }
+
+    /// <summary>
+    /// Start the speech synthesis on SSML, as an operation that can be awaited with co_await.
+    /// </summary>
+    /// <param name="ssml">The SSML for synthesis.</param>
+    /// <returns>An awaitable operation representing the synthesis. It returns a value of <see cref="SpeechSynthesisResult"/> as result.</returns>
+    AsyncOperation<std::shared_ptr<SpeechSynthesisResult>> StartSpeakingSsmlAwaitable(const std::wstring& ssml)
+    {
+        return StartSpeakingSsmlAwaitable(Utils::ToUTF8(ssml));
+    }
+
+    /// <summary>
+    /// Get the available voices, as an operation that can be awaited with co_await.
+    /// The voices list raises no events, so a thread of the blocking <see cref="AsyncExecutor"/> waits for it.
+    /// </summary>
+    /// <param name="locale">Specify the locale of voices, in BCP-47 format; or leave it empty to get all available voices.</param>
+    /// <returns>An awaitable operation representing the voices list. It returns a value of <see cref="SynthesisVoicesResult"/> as result.</returns>
+    AsyncOperation<std::shared_ptr<SynthesisVoicesResult>> GetVoicesAwaitable(const SPXSTRING& locale = SPXSTRING())
+    {
+        auto keepAlive = this->shared_from_this();
+        auto state = std::make_shared<Details::AsyncOperationState<std::shared_ptr<SynthesisVoicesResult>>>();
+
+        SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
+        SPX_THROW_ON_FAIL(::synthesizer_get_voices_list_async(m_hsynth, Utils::ToUTF8(locale).c_str(), &hasync));
+
+        Details::FinishInBackground([keepAlive, state, hasync]() {
+            SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
+            auto hr = ::synthesizer_get_voices_list_async_wait_for(hasync, UINT32_MAX, &hresult);
+            SPX_REPORT_ON_FAIL(synthesizer_async_handle_release(hasync));
+            try
+            {
+                SPX_THROW_ON_FAIL(hr);
+                state->SetResult(std::make_shared<SynthesisVoicesResult>(hresult));
+            }
+            catch (...)
+            {
+                state->SetException(std::current_exception());
+            }
+        });
+
+        return AsyncOperation<std::shared_ptr<SynthesisVoicesResult>>(state);
+    }
+
     /// <summary>
     /// Sets the authorization token that will be used for connecting to the service.
     /// Note: The caller needs to ensure that the authorization token is valid. Before the authorization token
@@ -583,6 +781,17 @@ public:
         return Properties.GetProperty(PropertyId::SpeechServiceAuthorization_Token, SPXSTRING());
     }
 
+    /// <summary>
+    /// Sets when <see cref="WordBoundaryBatch"/> and <see cref="VisemeBatch"/> deliver their accumulated entries.
+    /// Pending entries are delivered before the new options take effect.
+    /// </summary>
+    /// <param name="options">Batch size and delay thresholds.</param>
+    void SetEventBatchOptions(const SpeechSynthesisEventBatchOptions& options)
+    {
+        m_wordBoundaryBatcher.SetOptions(options);
+        m_visemeBatcher.SetOptions(options);
+    }
+
     /// <summary>
     /// Destructor.
     /// </summary>
@@ -591,14 +800,20 @@ public:
         SPX_DBG_TRACE_SCOPE(__FUNCTION__, __FUNCTION__);
 
         // Disconnect the event signals in reverse construction order
+        VisemeBatch.DisconnectAll();
+        WordBoundaryBatch.DisconnectAll();
         BookmarkReached.DisconnectAll();
         VisemeReceived.DisconnectAll();
         WordBoundary.DisconnectAll();
         SynthesisCanceled.DisconnectAll();
         SynthesisCompleted.DisconnectAll();
+        SynthesizingAudio.DisconnectAll();
         Synthesizing.DisconnectAll();
         SynthesisStarted.DisconnectAll();
 
+        synthesizer_started_set_callback(m_hsynth, nullptr, this);
+        synthesizer_completed_set_callback(m_hsynth, nullptr, this);
+        synthesizer_canceled_set_callback(m_hsynth, nullptr, this);
         synthesizer_handle_release(m_hsynth);
     }
 
@@ -614,9 +829,19 @@ public:
 
     /// <summary>
     /// The event signals that a speech synthesis result is received while the synthesis is on going.
+    /// Each chunk creates a <see cref="SpeechSynthesisResult"/>, which copies the audio only when it is requested;
+    /// see <see cref="SynthesizingAudio"/> for the opt-in allocation-free event.
     /// </summary>
     EventSignal<const SpeechSynthesisEventArgs&> Synthesizing;
 
+    /// <summary>
+    /// The event signals that a chunk of audio is received while the synthesis is on going, like <see cref="Synthesizing"/>
+    /// but without creating a <see cref="SpeechSynthesisResult"/> or allocating per chunk. Connecting it is the opt-in
+    /// allocation-free path; existing Synthesizing handlers keep their arguments.
+    /// Callbacks always run synchronously on the thread that produced the audio; asynchronous dispatch does not apply.
+    /// </summary>
+    EventSignal<const SpeechSynthesisAudioEventArgs&> SynthesizingAudio;
+
     /// <summary>
     /// The event signals that a speech synthesis result is received when the synthesis completed.
     /// </summary>
@@ -645,8 +870,48 @@ public:
     /// </summary>
     EventSignal<const SpeechSynthesisBookmarkEventArgs&> BookmarkReached;
 
+    /// <summary>
+    /// The event signals batches of word boundaries while the synthesis is on going, see <see cref="SetEventBatchOptions"/>.
+    /// Unlike <see cref="WordBoundary"/>, no per-word event arguments, text or result id are materialized.
+    /// </summary>
+    EventSignal<const SpeechSynthesisWordBoundaryBatchEventArgs&> WordBoundaryBatch;
+
+    /// <summary>
+    /// The event signals batches of visemes while the synthesis is on going, see <see cref="SetEventBatchOptions"/>.
+    /// Unlike <see cref="VisemeReceived"/>, no per-viseme event arguments, animation or result id are materialized.
+    /// </summary>
+    EventSignal<const SpeechSynthesisVisemeBatchEventArgs&> VisemeBatch;
+
 private:
 
+    /*! \cond PRIVATE */
+
+    SpeechSynthesisEventBatcher<SpeechSynthesisWordBoundaryEntry> m_wordBoundaryBatcher;
+    SpeechSynthesisEventBatcher<SpeechSynthesisVisemeEntry> m_visemeBatcher;
+
+    using PendingSpeak_Type = Details::EventCompletedOperation<std::shared_ptr<SpeechSynthesisResult>>;
+
+    struct PendingRequest
+    {
+        uint64_t sequence;
+        bool completeOnStart;
+        std::shared_ptr<PendingSpeak_Type> awaitable;
+    };
+
+    // Held while a request is started, so that sequence numbers follow the order of the native queue.
+    std::mutex m_startMutex;
+    uint64_t m_startedRequests = 0;
+
+    // Never held while calling the native library, as the event callbacks take it.
+    std::mutex m_requestsMutex;
+    uint64_t m_endedRequests = 0;
+    std::deque<PendingRequest> m_pendingAwaitables;
+
+    // Set once an awaitable start-speaking operation was started; the started event then stays observed.
+    std::atomic<bool> m_awaitingCompletions{ false };
+
+    /*! \endcond */
+
     /// <summary>
     /// Internal constructor. Creates a new instance using the provided handle.
     /// </summary>
@@ -657,13 +922,23 @@ private:
         Properties(m_properties),
         SynthesisStarted(GetSpeechSynthesisEventConnectionsChangedCallback()),
         Synthesizing(GetSpeechSynthesisEventConnectionsChangedCallback()),
+        SynthesizingAudio(GetSynthesizingAudioEventConnectionsChangedCallback()),
         SynthesisCompleted(GetSpeechSynthesisEventConnectionsChangedCallback()),
         SynthesisCanceled(GetSpeechSynthesisEventConnectionsChangedCallback()),
         WordBoundary(GetWordBoundaryEventConnectionsChangedCallback()),
         VisemeReceived(GetVisemeEventConnectionsChangedCallback()),
-        BookmarkReached(GetBookmarkEventConnectionsChangedCallback())
+        BookmarkReached(GetBookmarkEventConnectionsChangedCallback()),
+        WordBoundaryBatch(GetWordBoundaryBatchEventConnectionsChangedCallback()),
+        VisemeBatch(GetVisemeBatchEventConnectionsChangedCallback()),
+        m_wordBoundaryBatcher(WordBoundaryBatch),
+        m_visemeBatcher(VisemeBatch)
     {
         SPX_DBG_TRACE_SCOPE(__FUNCTION__, __FUNCTION__);
+
+        // Completion and cancellation also flush pending batches, count the ended requests and complete awaitable
+        // operations, so they are always observed; see StartRequest.
+        synthesizer_completed_set_callback(m_hsynth, FireEvent_SynthesisCompleted, this);
+        synthesizer_canceled_set_callback(m_hsynth, FireEvent_SynthesisCanceled, this);
     }
 
     std::function<void(const EventSignal<const SpeechSynthesisEventArgs&>&)> GetSpeechSynthesisEventConnectionsChangedCallback()
@@ -671,19 +946,21 @@ private:
         return [=](const EventSignal<const SpeechSynthesisEventArgs&>& eventSignal) {
             if (&eventSignal == &SynthesisStarted)
             {
-                synthesizer_started_set_callback(m_hsynth, SynthesisStarted.IsConnected() ? FireEvent_SynthesisStarted : nullptr, this);
+                UpdateSynthesisStartedCallback();
             }
             else if (&eventSignal == &Synthesizing)
             {
-                synthesizer_synthesizing_set_callback(m_hsynth, Synthesizing.IsConnected() ? FireEvent_Synthesizing : nullptr, this);
-            }
-            else if (&eventSignal == &SynthesisCompleted)
-            {
-                synthesizer_completed_set_callback(m_hsynth, SynthesisCompleted.IsConnected() ? FireEvent_SynthesisCompleted : nullptr, this);
+                UpdateSynthesizingCallback();
             }
-            else if (&eventSignal == &SynthesisCanceled)
+        };
+    }
+
+    std::function<void(const EventSignal<const SpeechSynthesisAudioEventArgs&>&)> GetSynthesizingAudioEventConnectionsChangedCallback()
+    {
+        return [=](const EventSignal<const SpeechSynthesisAudioEventArgs&>& eventSignal) {
+            if (&eventSignal == &SynthesizingAudio)
             {
-                synthesizer_canceled_set_callback(m_hsynth, SynthesisCanceled.IsConnected() ? FireEvent_SynthesisCanceled : nullptr, this);
+                UpdateSynthesizingCallback();
             }
         };
     }
@@ -693,7 +970,7 @@ private:
         return [=](const EventSignal<const SpeechSynthesisWordBoundaryEventArgs&>& eventSignal) {
             if (&eventSignal == &WordBoundary)
             {
-                synthesizer_word_boundary_set_callback(m_hsynth, WordBoundary.IsConnected() ? FireEvent_WordBoundary : nullptr, this);
+                UpdateWordBoundaryCallback();
             }
         };
     }
@@ -703,7 +980,7 @@ private:
         return [=](const EventSignal<const SpeechSynthesisVisemeEventArgs&>& eventSignal) {
             if (&eventSignal == &VisemeReceived)
             {
-                synthesizer_viseme_received_set_callback(m_hsynth, VisemeReceived.IsConnected() ? FireEvent_VisemeReceived : nullptr, this);
+                UpdateVisemeCallback();
             }
         };
     }
@@ -718,74 +995,438 @@ private:
         };
     }
 
+    std::function<void(const EventSignal<const SpeechSynthesisWordBoundaryBatchEventArgs&>&)> GetWordBoundaryBatchEventConnectionsChangedCallback()
+    {
+        return [=](const EventSignal<const SpeechSynthesisWordBoundaryBatchEventArgs&>& eventSignal) {
+            if (&eventSignal == &WordBoundaryBatch)
+            {
+                if (!WordBoundaryBatch.IsConnected())
+                {
+                    m_wordBoundaryBatcher.Reset();
+                }
+                UpdateWordBoundaryCallback();
+            }
+        };
+    }
+
+    std::function<void(const EventSignal<const SpeechSynthesisVisemeBatchEventArgs&>&)> GetVisemeBatchEventConnectionsChangedCallback()
+    {
+        return [=](const EventSignal<const SpeechSynthesisVisemeBatchEventArgs&>& eventSignal) {
+            if (&eventSignal == &VisemeBatch)
+            {
+                if (!VisemeBatch.IsConnected())
+                {
+                    m_visemeBatcher.Reset();
+                }
+                UpdateVisemeCallback();
+            }
+        };
+    }
+
+    void UpdateSynthesizingCallback()
+    {
+        auto connected = Synthesizing.IsConnected() || SynthesizingAudio.IsConnected();
+        synthesizer_synthesizing_set_callback(m_hsynth, connected ? FireEvent_Synthesizing : nullptr, this);
+    }
+
+    // Awaitable start-speaking operations complete when the synthesis starts.
+    void UpdateSynthesisStartedCallback()
+    {
+        synthesizer_started_set_callback(m_hsynth, SynthesisStarted.IsConnected() || m_awaitingCompletions ? FireEvent_SynthesisStarted : nullptr, this);
+    }
+
+    void UpdateWordBoundaryCallback()
+    {
+        auto connected = WordBoundary.IsConnected() || WordBoundaryBatch.IsConnected();
+        synthesizer_word_boundary_set_callback(m_hsynth, connected ? FireEvent_WordBoundary : nullptr, this);
+    }
+
+    void UpdateVisemeCallback()
+    {
+        auto connected = VisemeReceived.IsConnected() || VisemeBatch.IsConnected();
+        synthesizer_viseme_received_set_callback(m_hsynth, connected ? FireEvent_VisemeReceived : nullptr, this);
+    }
+
+    // Synthesis requests are started on the calling thread, so that they keep their order and a stop ends them even
+    // while their waits are queued behind others on the bounded blocking executor; only the wait runs there.
+    std::future<std::shared_ptr<SpeechSynthesisResult>> WaitForSpeakAsync(SPXHR startHr, SPXASYNCHANDLE hasync)
+    {
+        auto keepAlive = this->shared_from_this();
+
+        auto future = Details::RunAsync([keepAlive, startHr, hasync]() -> std::shared_ptr<SpeechSynthesisResult> {
+            SPX_THROW_ON_FAIL(startHr);
+            SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
+            SPX_EXITFN_ON_FAIL(::synthesizer_speak_async_wait_for(hasync, UINT32_MAX, &hresult));
+
+        SPX_EXITFN_CLEANUP:
+            auto releaseHr = synthesizer_async_handle_release(hasync);
+            SPX_REPORT_ON_FAIL(releaseHr);
+
+            return std::make_shared<SpeechSynthesisResult>(hresult);
+        });
+
+        return future;
+    }
+
+    template <class TStart>
+    std::future<std::shared_ptr<SpeechSynthesisResult>> SpeakAsyncInternal(TStart start, const CancellationToken& token)
+    {
+        auto keepAlive = this->shared_from_this();
+
+        SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
+        auto startHr = StartRequest(start, &hasync);
+
+        auto future = Details::RunAsync([keepAlive, this, startHr, hasync, token]() -> std::shared_ptr<SpeechSynthesisResult> {
+            SPX_THROW_ON_FAIL(startHr);
+
+            SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
+            auto hr = Details::WaitForAsync([hasync, &hresult](uint32_t milliseconds) {
+                return ::synthesizer_speak_async_wait_for(hasync, milliseconds, &hresult);
+            }, token);
+
+            auto expired = hr == SPXERR_TIMEOUT;
+            auto timedOut = expired && !token.IsCancellationRequested();
+            if (expired)
+            {
+                // Stopping ends the synthesis with a canceled result; give it the stop timeout to arrive.
+                auto stopTimeout = static_cast<uint32_t>(token.GetStopTimeout().count());
+                SPXASYNCHANDLE hasyncStop = SPXHANDLE_INVALID;
+                if (SPX_SUCCEEDED(::synthesizer_stop_speaking_async(m_hsynth, &hasyncStop)))
+                {
+                    SPX_REPORT_ON_FAIL(::synthesizer_stop_speaking_async_wait_for(hasyncStop, stopTimeout));
+                    SPX_REPORT_ON_FAIL(synthesizer_async_handle_release(hasyncStop));
+                }
+                hr = ::synthesizer_speak_async_wait_for(hasync, stopTimeout, &hresult);
+                if (hr == SPXERR_TIMEOUT)
+                {
+                    Details::FinishInBackground([keepAlive, hasync]() {
+                        SPXRESULTHANDLE hlateResult = SPXHANDLE_INVALID;
+                        if (SPX_SUCCEEDED(::synthesizer_speak_async_wait_for(hasync, UINT32_MAX, &hlateResult)))
+                        {
+                            SPX_REPORT_ON_FAIL(synthesizer_result_handle_release(hlateResult));
+                        }
+                        SPX_REPORT_ON_FAIL(synthesizer_async_handle_release(hasync));
+                    });
+                    SPX_THROW_HR(hr);
+                }
+            }
+
+            SPX_REPORT_ON_FAIL(synthesizer_async_handle_release(hasync));
+            SPX_THROW_ON_FAIL(hr);
+
+            auto result = std::make_shared<SpeechSynthesisResult>(hresult);
+            if (timedOut && result->m_reason == ResultReason::Canceled)
+            {
+                result->m_reason = ResultReason::TimedOut;
+            }
+            return result;
+        });
+
+        return future;
+    }
+
+    // Every synthesis request is started here, so that requests are numbered in the order the native synthesizer
+    // queues them. It processes them one at a time and ends each with a completed or canceled event, so the number
+    // of ended requests identifies the request each event belongs to.
+    template <class TStart>
+    SPXHR StartRequest(TStart start, SPXASYNCHANDLE* phasync, std::shared_ptr<PendingSpeak_Type> awaitable = nullptr, bool completeOnStart = false)
+    {
+        std::unique_lock<std::mutex> startLock(m_startMutex);
+        if (awaitable != nullptr)
+        {
+            std::unique_lock<std::mutex> lock(m_requestsMutex);
+            m_pendingAwaitables.push_back(PendingRequest{ m_startedRequests, completeOnStart, awaitable });
+        }
+
+        auto hr = start(phasync);
+        if (SPX_SUCCEEDED(hr))
+        {
+            m_startedRequests++;
+        }
+        else if (awaitable != nullptr)
+        {
+            std::unique_lock<std::mutex> lock(m_requestsMutex);
+            if (!m_pendingAwaitables.empty() && m_pendingAwaitables.back().awaitable == awaitable)
+            {
+                m_pendingAwaitables.pop_back();
+            }
+        }
+        return hr;
+    }
+
+    template <class TStart>
+    std::shared_ptr<SpeechSynthesisResult> SpeakInternal(TStart start)
+    {
+        SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
+        SPX_THROW_ON_FAIL(StartRequest(start, &hasync));
+
+        SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
+        auto hr = ::synthesizer_speak_async_wait_for(hasync, UINT32_MAX, &hresult);
+        SPX_REPORT_ON_FAIL(synthesizer_async_handle_release(hasync));
+        SPX_THROW_ON_FAIL(hr);
+
+        return std::make_shared<SpeechSynthesisResult>(hresult);
+    }
+
+    template <class TStart>
+    AsyncOperation<std::shared_ptr<SpeechSynthesisResult>> SpeakAwaitableInternal(TStart start, bool completeOnStart)
+    {
+        if (!m_awaitingCompletions.exchange(true))
+        {
+            UpdateSynthesisStartedCallback();
+        }
+
+        auto awaitable = std::make_shared<PendingSpeak_Type>();
+        SPXASYNCHANDLE hasync = SPXHANDLE_INVALID;
+        SPX_THROW_ON_FAIL(StartRequest(start, &hasync, awaitable, completeOnStart));
+        FinishAwaitable(awaitable, awaitable->SetHandle(hasync));
+
+        return AsyncOperation<std::shared_ptr<SpeechSynthesisResult>>(awaitable->GetState());
+    }
+
+    // Releases the handle of an awaitable request that ended. The native operation returns just after the event
+    // ending it, so the wait is short; if that event was missed, the operation is completed from the wait instead.
+    void FinishAwaitable(std::shared_ptr<PendingSpeak_Type> awaitable, SPXASYNCHANDLE hasync)
+    {
+        if (hasync == SPXHANDLE_INVALID)
+        {
+            return;
+        }
+
+        auto keepAlive = this->shared_from_this();
+        Details::FinishInBackground([keepAlive, awaitable, hasync]() {
+            SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
+            auto hr = ::synthesizer_speak_async_wait_for(hasync, UINT32_MAX, &hresult);
+            SPX_REPORT_ON_FAIL(synthesizer_async_handle_release(hasync));
+
+            auto completed = awaitable->Complete([hr, hresult]() {
+                SPX_THROW_ON_FAIL(hr);
+                return std::make_shared<SpeechSynthesisResult>(hresult);
+            });
+            if (!completed && SPX_SUCCEEDED(hr))
+            {
+                SPX_REPORT_ON_FAIL(synthesizer_result_handle_release(hresult));
+            }
+        });
+    }
+
+    static std::shared_ptr<SpeechSynthesisResult> ResultFromEvent(SPXEVENTHANDLE hevent)
+    {
+        SPXRESULTHANDLE hresult = SPXHANDLE_INVALID;
+        SPX_THROW_ON_FAIL(synthesizer_synthesis_event_get_result(hevent, &hresult));
+        return std::make_shared<SpeechSynthesisResult>(hresult);
+    }
+
+    // The request that starts is always the oldest one that has not ended.
+    void OnRequestStarted(SPXEVENTHANDLE hevent)
+    {
+        std::shared_ptr<PendingSpeak_Type> awaitable;
+        {
+            std::unique_lock<std::mutex> lock(m_requestsMutex);
+            if (!m_pendingAwaitables.empty() && m_pendingAwaitables.front().sequence == m_endedRequests && m_pendingAwaitables.front().completeOnStart)
+            {
+                awaitable = m_pendingAwaitables.front().awaitable;
+            }
+        }
+
+        if (awaitable != nullptr)
+        {
+            awaitable->Complete([hevent]() { return ResultFromEvent(hevent); });
+        }
+    }
+
+    void OnRequestEnded(SPXEVENTHANDLE hevent)
+    {
+        std::vector<std::shared_ptr<PendingSpeak_Type>> ended;
+        std::shared_ptr<PendingSpeak_Type> awaitable;
+        {
+            std::unique_lock<std::mutex> lock(m_requestsMutex);
+            auto sequence = m_endedRequests++;
+            while (!m_pendingAwaitables.empty() && m_pendingAwaitables.front().sequence <= sequence)
+            {
+                // Earlier entries missed their event; they are completed once their wait returns.
+                ended.push_back(m_pendingAwaitables.front().awaitable);
+                if (m_pendingAwaitables.front().sequence == sequence)
+                {
+                    awaitable = m_pendingAwaitables.front().awaitable;
+                }
+                m_pendingAwaitables.pop_front();
+            }
+        }
+
+        if (awaitable != nullptr)
+        {
+            awaitable->Complete([hevent]() { return ResultFromEvent(hevent); });
+        }
+        for (auto& entry : ended)
+        {
+            FinishAwaitable(entry, entry->End());
+        }
+    }
+
+    void FlushEventBatches()
+    {
+        m_wordBoundaryBatcher.Flush();
+        m_visemeBatcher.Flush();
+    }
+
+    template <class TEventArgs, class... TArgs>
+    static std::shared_ptr<TEventArgs> MakeEventArgs(SPXEVENTHANDLE hevent, std::shared_ptr<SpeechSynthesizer> keepAlive, TArgs&&... args)
+    {
+        // The event arguments keep the synthesizer alive until every callback has run, including when
+        // the signal queues them for asynchronous dispatch (see EventSignal::EnableAsyncDispatch).
+        return std::shared_ptr<TEventArgs>(new TEventArgs(hevent, std::forward<TArgs>(args)...), [keepAlive](TEventArgs* eventArgs) { delete eventArgs; });
+    }
+
     static void FireEvent_SynthesisStarted(SPXSYNTHHANDLE hsynth, SPXEVENTHANDLE hevent, void* pvContext)
     {
         UNUSED(hsynth);
-        std::unique_ptr<SpeechSynthesisEventArgs> synthEvent{ new SpeechSynthesisEventArgs(hevent) };
-
         auto pThis = static_cast<SpeechSynthesizer*>(pvContext);
         auto keepAlive = pThis->shared_from_this();
-        pThis->SynthesisStarted.Signal(*synthEvent.get());
+
+        pThis->OnRequestStarted(hevent);
+
+        if (pThis->SynthesisStarted.IsConnected())
+        {
+            auto synthEvent = MakeEventArgs<SpeechSynthesisEventArgs>(hevent, keepAlive);
+            pThis->SynthesisStarted.SignalOwned(synthEvent);
+        }
+        else
+        {
+            SPX_REPORT_ON_FAIL(synthesizer_event_handle_release(hevent));
+        }
     }
 
     static void FireEvent_Synthesizing(SPXSYNTHHANDLE hsynth, SPXEVENTHANDLE hevent, void* pvContext)
     {
         UNUSED(hsynth);
-        std::unique_ptr<SpeechSynthesisEventArgs> synthEvent{ new SpeechSynthesisEventArgs(hevent) };
-
         auto pThis = static_cast<SpeechSynthesizer*>(pvContext);
         auto keepAlive = pThis->shared_from_this();
-        pThis->Synthesizing.Signal(*synthEvent.get());
+        pThis->m_wordBoundaryBatcher.FlushIfDue();
+        pThis->m_visemeBatcher.FlushIfDue();
+
+        // The audio event arguments only own the event handle if the Synthesizing event arguments do not take it.
+        auto synthesizing = pThis->Synthesizing.IsConnected();
+        if (pThis->SynthesizingAudio.IsConnected())
+        {
+            SpeechSynthesisAudioEventArgs audioEvent(hevent, !synthesizing);
+            pThis->SynthesizingAudio.Signal(audioEvent);
+        }
+        else if (!synthesizing)
+        {
+            SPX_REPORT_ON_FAIL(synthesizer_event_handle_release(hevent));
+        }
+
+        if (synthesizing)
+        {
+            auto synthEvent = MakeEventArgs<SpeechSynthesisEventArgs>(hevent, keepAlive);
+            pThis->Synthesizing.SignalOwned(synthEvent);
+        }
     }
 
     static void FireEvent_SynthesisCompleted(SPXSYNTHHANDLE hsynth, SPXEVENTHANDLE hevent, void* pvContext)
     {
         UNUSED(hsynth);
-        std::unique_ptr<SpeechSynthesisEventArgs> synthEvent{ new SpeechSynthesisEventArgs(hevent) };
-
         auto pThis = static_cast<SpeechSynthesizer*>(pvContext);
         auto keepAlive = pThis->shared_from_this();
-        pThis->SynthesisCompleted.Signal(*synthEvent.get());
+        pThis->FlushEventBatches();
+        pThis->OnRequestEnded(hevent);
+
+        if (pThis->SynthesisCompleted.IsConnected())
+        {
+            auto synthEvent = MakeEventArgs<SpeechSynthesisEventArgs>(hevent, keepAlive);
+            pThis->SynthesisCompleted.SignalOwned(synthEvent);
+        }
+        else
+        {
+            SPX_REPORT_ON_FAIL(synthesizer_event_handle_release(hevent));
+        }
     }
 
     static void FireEvent_SynthesisCanceled(SPXSYNTHHANDLE hsynth, SPXEVENTHANDLE hevent, void* pvContext)
     {
         UNUSED(hsynth);
-        std::unique_ptr<SpeechSynthesisEventArgs> synthEvent{ new SpeechSynthesisEventArgs(hevent) };
-
         auto pThis = static_cast<SpeechSynthesizer*>(pvContext);
         auto keepAlive = pThis->shared_from_this();
-        pThis->SynthesisCanceled.Signal(*synthEvent.get());
+        pThis->FlushEventBatches();
+        pThis->OnRequestEnded(hevent);
+
+        if (pThis->SynthesisCanceled.IsConnected())
+        {
+            auto synthEvent = MakeEventArgs<SpeechSynthesisEventArgs>(hevent, keepAlive);
+            pThis->SynthesisCanceled.SignalOwned(synthEvent);
+        }
+        else
+        {
+            SPX_REPORT_ON_FAIL(synthesizer_event_handle_release(hevent));
+        }
     }
 
     static void FireEvent_WordBoundary(SPXSYNTHHANDLE hsynth, SPXEVENTHANDLE hevent, void* pvContext)
     {
         UNUSED(hsynth);
-        std::unique_ptr<SpeechSynthesisWordBoundaryEventArgs> wordBoundaryEvent{ new SpeechSynthesisWordBoundaryEventArgs(hevent) };
-
         auto pThis = static_cast<SpeechSynthesizer*>(pvContext);
         auto keepAlive = pThis->shared_from_this();
-        pThis->WordBoundary.Signal(*wordBoundaryEvent.get());
+
+        if (pThis->WordBoundaryBatch.IsConnected())
+        {
+            SpeechSynthesisWordBoundaryEntry entry{};
+            SpeechSynthesis_BoundaryType boundaryType = SpeechSynthesis_BoundaryType_Word;
+            auto hr = synthesizer_word_boundary_event_get_values(hevent, &entry.AudioOffset, &entry.Duration, &entry.TextOffset, &entry.WordLength, &boundaryType);
+            SPX_REPORT_ON_FAIL(hr);
+            if (SPX_SUCCEEDED(hr))
+            {
+                entry.BoundaryType = static_cast<SpeechSynthesisBoundaryType>(boundaryType);
+                pThis->m_wordBoundaryBatcher.Append(entry);
+            }
+        }
+        pThis->m_visemeBatcher.FlushIfDue();
+
+        if (!pThis->WordBoundary.IsConnected())
+        {
+            SPX_REPORT_ON_FAIL(synthesizer_event_handle_release(hevent));
+            return;
+        }
+
+        auto wordBoundaryEvent = MakeEventArgs<SpeechSynthesisWordBoundaryEventArgs>(hevent, keepAlive);
+        pThis->WordBoundary.SignalOwned(wordBoundaryEvent);
     }
 
     static void FireEvent_VisemeReceived(SPXSYNTHHANDLE hsynth, SPXEVENTHANDLE hevent, void* pvContext)
     {
         UNUSED(hsynth);
-        std::unique_ptr<SpeechSynthesisVisemeEventArgs> visemeReceivedEvent{ new SpeechSynthesisVisemeEventArgs(hevent) };
-
         auto pThis = static_cast<SpeechSynthesizer*>(pvContext);
         auto keepAlive = pThis->shared_from_this();
-        pThis->VisemeReceived.Signal(*visemeReceivedEvent.get());
+
+        if (pThis->VisemeBatch.IsConnected())
+        {
+            SpeechSynthesisVisemeEntry entry{};
+            auto hr = synthesizer_viseme_event_get_values(hevent, &entry.AudioOffset, &entry.VisemeId);
+            SPX_REPORT_ON_FAIL(hr);
+            if (SPX_SUCCEEDED(hr))
+            {
+                pThis->m_visemeBatcher.Append(entry);
+            }
+        }
+        pThis->m_wordBoundaryBatcher.FlushIfDue();
+
+        if (!pThis->VisemeReceived.IsConnected())
+        {
+            SPX_REPORT_ON_FAIL(synthesizer_event_handle_release(hevent));
+            return;
+        }
+
+        auto visemeReceivedEvent = MakeEventArgs<SpeechSynthesisVisemeEventArgs>(hevent, keepAlive);
+        pThis->VisemeReceived.SignalOwned(visemeReceivedEvent);
     }
 
     static void FireEvent_BookmarkReached(SPXSYNTHHANDLE hsynth, SPXEVENTHANDLE hevent, void* pvContext)
     {
         UNUSED(hsynth);
-        std::unique_ptr<SpeechSynthesisBookmarkEventArgs> bookmarkReachedEvent{ new SpeechSynthesisBookmarkEventArgs(hevent) };
-
         auto pThis = static_cast<SpeechSynthesizer*>(pvContext);
-        auto keepAlive = pThis->shared_from_this();
-        pThis->BookmarkReached.Signal(*bookmarkReachedEvent.get());
+        auto bookmarkReachedEvent = MakeEventArgs<SpeechSynthesisBookmarkEventArgs>(hevent, pThis->shared_from_this());
+
+        pThis->BookmarkReached.SignalOwned(bookmarkReachedEvent);
     }
 };
 
@@ -0,0 +1,620 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_speech_synthesizer_pool.h: Public API declarations for SpeechSynthesizerPool and SpeechSynthesizerLease C++ classes
+//
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "speechapi_cxx_common.h"
+#include "speechapi_cxx_enums.h"
+#include "speechapi_cxx_speech_config.h"
+#include "speechapi_cxx_speech_synthesizer.h"
+#include "speechapi_cxx_connection.h"
+#include "speechapi_cxx_cancellation_token.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+
+/// <summary>
+/// Options of a <see cref="SpeechSynthesizerPool"/>.
+/// </summary>
+struct SpeechSynthesizerPoolOptions
+{
+    /// <summary>
+    /// Maximum number of synthesizers per configuration. <see cref="SpeechSynthesizerPool::Acquire"/> waits while all of them are leased.
+    /// </summary>
+    size_t MaxSynthesizersPerConfig = 8;
+
+    /// <summary>
+    /// Idle synthesizers are released after this time, together with their connection.
+    /// </summary>
+    std::chrono::milliseconds IdleTimeout{ std::chrono::minutes(2) };
+
+    /// <summary>
+    /// Whether new synthesizers open their connection right away, and leased ones reopen it if the service closed it.
+    /// </summary>
+    bool OpenConnections = true;
+};
+
+/// <summary>
+/// Counters of a <see cref="SpeechSynthesizerPool"/>.
+/// </summary>
+struct SpeechSynthesizerPoolMetrics
+{
+    /// <summary>
+    /// Number of leases handed out.
+    /// </summary>
+    uint64_t Leases = 0;
+
+    /// <summary>
+    /// Number of leases that got an existing synthesizer.
+    /// </summary>
+    uint64_t Reuses = 0;
+
+    /// <summary>
+    /// Number of synthesizers created, including those created by <see cref="SpeechSynthesizerPool::Prewarm"/>.
+    /// </summary>
+    uint64_t Creations = 0;
+
+    /// <summary>
+    /// Number of idle synthesizers released after <see cref="SpeechSynthesizerPoolOptions::IdleTimeout"/>.
+    /// </summary>
+    uint64_t Evictions = 0;
+
+    /// <summary>
+    /// Number of synthesizers released by <see cref="SpeechSynthesizerLease::Discard"/>.
+    /// </summary>
+    uint64_t Discards = 0;
+
+    /// <summary>
+    /// Total time spent in <see cref="SpeechSynthesizerPool::Acquire"/>, including creating synthesizers.
+    /// </summary>
+    std::chrono::microseconds TotalLeaseWait{ 0 };
+
+    /// <summary>
+    /// Longest time spent in a single <see cref="SpeechSynthesizerPool::Acquire"/>.
+    /// </summary>
+    std::chrono::microseconds MaxLeaseWait{ 0 };
+
+    /// <summary>
+    /// Number of synthesizers currently leased.
+    /// </summary>
+    size_t Leased = 0;
+
+    /// <summary>
+    /// Number of synthesizers currently idle in the pool.
+    /// </summary>
+    size_t Idle = 0;
+
+    /// <summary>
+    /// Gets the share of leases that reused a synthesizer.
+    /// </summary>
+    /// <returns>The ratio, between 0 and 1.</returns>
+    double GetReuseRatio() const
+    {
+        return Leases == 0 ? 0.0 : static_cast<double>(Reuses) / static_cast<double>(Leases);
+    }
+
+    /// <summary>
+    /// Gets the average time spent in <see cref="SpeechSynthesizerPool::Acquire"/>.
+    /// </summary>
+    /// <returns>The average wait.</returns>
+    std::chrono::microseconds GetAverageLeaseWait() const
+    {
+        return Leases == 0 ? std::chrono::microseconds(0) : std::chrono::microseconds(TotalLeaseWait.count() / static_cast<int64_t>(Leases));
+    }
+};
+
+/*! \cond PRIVATE */
+
+namespace Details {
+
+    // A pooled synthesizer and its connection.
+    class PooledSpeechSynthesizer
+    {
+    public:
+
+        PooledSpeechSynthesizer(std::string key, std::shared_ptr<SpeechSynthesizer> synthesizer, bool openConnection) :
+            key(std::move(key)),
+            synthesizer(std::move(synthesizer)),
+            connection(Connection::FromSpeechSynthesizer(this->synthesizer)),
+            m_connected(std::make_shared<std::atomic<bool>>(false))
+        {
+            auto connected = m_connected;
+            connection->Connected += [connected](const ConnectionEventArgs&) { connected->store(true); };
+            connection->Disconnected += [connected](const ConnectionEventArgs&) { connected->store(false); };
+            if (openConnection)
+            {
+                Open();
+            }
+        }
+
+        ~PooledSpeechSynthesizer()
+        {
+            connection->Connected.DisconnectAll();
+            connection->Disconnected.DisconnectAll();
+        }
+
+        // Opening only sets up the connection in advance; the synthesizer connects by itself if it fails.
+        void Open()
+        {
+            if (m_connected->load())
+            {
+                return;
+            }
+            try
+            {
+                connection->Open(true);
+            }
+            catch (const std::exception& ex)
+            {
+                SPX_TRACE_ERROR("Unable to open the connection of a pooled speech synthesizer: %s", ex.what());
+                (void)ex;
+            }
+        }
+
+        const std::string key;
+        const std::shared_ptr<SpeechSynthesizer> synthesizer;
+        const std::shared_ptr<Connection> connection;
+        std::chrono::steady_clock::time_point lastReleased;
+
+    private:
+
+        DISABLE_COPY_AND_MOVE(PooledSpeechSynthesizer);
+
+        std::shared_ptr<std::atomic<bool>> m_connected;
+    };
+
+    // Shared by the pool and its leases, which may outlive it.
+    class SpeechSynthesizerPoolState
+    {
+    public:
+
+        explicit SpeechSynthesizerPoolState(const SpeechSynthesizerPoolOptions& options) :
+            options(options)
+        {
+        }
+
+        struct Bucket
+        {
+            std::vector<std::unique_ptr<PooledSpeechSynthesizer>> idle;
+            size_t count = 0;
+        };
+
+        void Release(std::unique_ptr<PooledSpeechSynthesizer> pooled, bool discard)
+        {
+            std::vector<std::unique_ptr<PooledSpeechSynthesizer>> expired;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                metrics.Leased--;
+                auto& bucket = buckets[pooled->key];
+                if (discard || closed)
+                {
+                    bucket.count--;
+                    metrics.Discards += discard ? 1 : 0;
+                    expired.push_back(std::move(pooled));
+                }
+                else
+                {
+                    pooled->lastReleased = std::chrono::steady_clock::now();
+                    bucket.idle.push_back(std::move(pooled));
+                    metrics.Idle++;
+                }
+                CollectExpired(expired);
+                available.notify_all();
+            }
+            // Synthesizers are destroyed outside the lock, since that waits for their callbacks.
+        }
+
+        // Moves idle synthesizers that timed out to expired.
+        void CollectExpired(std::vector<std::unique_ptr<PooledSpeechSynthesizer>>& expired)
+        {
+            auto deadline = std::chrono::steady_clock::now() - options.IdleTimeout;
+            for (auto it = buckets.begin(); it != buckets.end();)
+            {
+                auto& idle = it->second.idle;
+                // The idle list is ordered by release time, oldest first.
+                auto end = std::find_if(idle.begin(), idle.end(), [deadline](const std::unique_ptr<PooledSpeechSynthesizer>& pooled) { return pooled->lastReleased > deadline; });
+                auto count = static_cast<size_t>(end - idle.begin());
+                std::move(idle.begin(), end, std::back_inserter(expired));
+                idle.erase(idle.begin(), end);
+                it->second.count -= count;
+                metrics.Evictions += count;
+                metrics.Idle -= count;
+                it = it->second.count == 0 ? buckets.erase(it) : std::next(it);
+            }
+        }
+
+        const SpeechSynthesizerPoolOptions options;
+
+        std::mutex mutex;
+        std::condition_variable available;
+        std::map<std::string, Bucket> buckets;
+        SpeechSynthesizerPoolMetrics metrics;
+        bool closed = false;
+
+    private:
+
+        DISABLE_COPY_AND_MOVE(SpeechSynthesizerPoolState);
+    };
+
+}
+
+/*! \endcond */
+
+/// <summary>
+/// A speech synthesizer leased from a <see cref="SpeechSynthesizerPool"/>. It returns the synthesizer to the pool when destroyed.
+/// </summary>
+class SpeechSynthesizerLease
+{
+public:
+
+    /// <summary>
+    /// Constructs an empty lease.
+    /// </summary>
+    SpeechSynthesizerLease() = default;
+
+    /// <summary>
+    /// Move constructor.
+    /// </summary>
+    /// <param name="other">The lease to take over.</param>
+    SpeechSynthesizerLease(SpeechSynthesizerLease&& other) :
+        m_state(std::move(other.m_state)),
+        m_pooled(std::move(other.m_pooled))
+    {
+    }
+
+    /// <summary>
+    /// Move assignment. Returns the synthesizer held so far to the pool.
+    /// </summary>
+    /// <param name="other">The lease to take over.</param>
+    /// <returns>This lease.</returns>
+    SpeechSynthesizerLease& operator=(SpeechSynthesizerLease&& other)
+    {
+        if (this != &other)
+        {
+            Return(false);
+            m_state = std::move(other.m_state);
+            m_pooled = std::move(other.m_pooled);
+        }
+        return *this;
+    }
+
+    /// <summary>
+    /// Destructor. Returns the synthesizer to the pool.
+    /// </summary>
+    ~SpeechSynthesizerLease()
+    {
+        Return(false);
+    }
+
+    /// <summary>
+    /// Gets the synthesizer. It must not be used after the lease ends.
+    /// </summary>
+    /// <returns>The synthesizer.</returns>
+    const std::shared_ptr<SpeechSynthesizer>& Get() const
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_STATE, m_pooled == nullptr);
+        return m_pooled->synthesizer;
+    }
+
+    /// <summary>
+    /// Member access to the synthesizer.
+    /// </summary>
+    SpeechSynthesizer* operator->() const { return Get().get(); }
+
+    /// <summary>
+    /// Dereferences the synthesizer.
+    /// </summary>
+    SpeechSynthesizer& operator*() const { return *Get(); }
+
+    /// <summary>
+    /// Checks if the lease holds a synthesizer.
+    /// </summary>
+    explicit operator bool() const { return m_pooled != nullptr; }
+
+    /// <summary>
+    /// Ends the lease and releases the synthesizer instead of returning it to the pool, e.g. after it failed or its
+    /// event handlers were changed.
+    /// </summary>
+    void Discard()
+    {
+        Return(true);
+    }
+
+private:
+
+    friend class SpeechSynthesizerPool;
+
+    SpeechSynthesizerLease(std::shared_ptr<Details::SpeechSynthesizerPoolState> state, std::unique_ptr<Details::PooledSpeechSynthesizer> pooled) :
+        m_state(std::move(state)),
+        m_pooled(std::move(pooled))
+    {
+    }
+
+    SpeechSynthesizerLease(const SpeechSynthesizerLease&) = delete;
+    SpeechSynthesizerLease& operator=(const SpeechSynthesizerLease&) = delete;
+
+    void Return(bool discard)
+    {
+        if (m_pooled != nullptr)
+        {
+            m_state->Release(std::move(m_pooled), discard);
+            m_state.reset();
+        }
+    }
+
+    std::shared_ptr<Details::SpeechSynthesizerPoolState> m_state;
+    std::unique_ptr<Details::PooledSpeechSynthesizer> m_pooled;
+};
+
+/// <summary>
+/// Keeps speech synthesizers and their service connections warm for reuse, so that a synthesis does not pay for creating
+/// the synthesizer and connecting to the service. Synthesizers are shared between configurations with the same endpoint,
+/// host, region, credentials, output format and voice.
+/// </summary>
+/// <remarks>
+/// Pooled synthesizers have no audio output; get the audio from the result, or from an <see cref="AudioDataStream"/>.
+/// Event handlers connected during a lease stay connected when the synthesizer is returned, so disconnect them first,
+/// or end the lease with <see cref="SpeechSynthesizerLease::Discard"/>.
+/// </remarks>
+class SpeechSynthesizerPool
+{
+public:
+
+    /// <summary>
+    /// Creates a pool.
+    /// </summary>
+    /// <param name="options">Options.</param>
+    /// <returns>A smart pointer wrapped pool.</returns>
+    static std::shared_ptr<SpeechSynthesizerPool> Create(const SpeechSynthesizerPoolOptions& options = SpeechSynthesizerPoolOptions())
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, options.MaxSynthesizersPerConfig == 0);
+        return std::shared_ptr<SpeechSynthesizerPool>(new SpeechSynthesizerPool(options));
+    }
+
+    /// <summary>
+    /// Destructor. Releases the idle synthesizers; leased ones are released when their lease ends.
+    /// </summary>
+    ~SpeechSynthesizerPool()
+    {
+        std::vector<std::unique_ptr<Details::PooledSpeechSynthesizer>> idle;
+        std::unique_lock<std::mutex> lock(m_state->mutex);
+        m_state->closed = true;
+        for (auto& bucket : m_state->buckets)
+        {
+            std::move(bucket.second.idle.begin(), bucket.second.idle.end(), std::back_inserter(idle));
+            bucket.second.count -= bucket.second.idle.size();
+            bucket.second.idle.clear();
+        }
+        m_state->metrics.Idle = 0;
+        lock.unlock();
+    }
+
+    /// <summary>
+    /// Leases a synthesizer for the given configuration, reusing an idle one if possible. Waits while
+    /// <see cref="SpeechSynthesizerPoolOptions::MaxSynthesizersPerConfig"/> synthesizers of the configuration are leased.
+    /// </summary>
+    /// <param name="speechConfig">Speech configuration.</param>
+    /// <returns>The lease.</returns>
+    SpeechSynthesizerLease Acquire(std::shared_ptr<SpeechConfig> speechConfig)
+    {
+        return Acquire(std::move(speechConfig), CancellationToken());
+    }
+
+    /// <summary>
+    /// Leases a synthesizer for the given configuration, waiting at most until the token expires.
+    /// </summary>
+    /// <param name="speechConfig">Speech configuration.</param>
+    /// <param name="token">The token bounding the wait. If it expires, an exception with SPXERR_TIMEOUT is thrown.</param>
+    /// <returns>The lease.</returns>
+    SpeechSynthesizerLease Acquire(std::shared_ptr<SpeechConfig> speechConfig, const CancellationToken& token)
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, speechConfig == nullptr);
+
+        auto start = std::chrono::steady_clock::now();
+        auto key = GetKey(*speechConfig);
+
+        std::vector<std::unique_ptr<Details::PooledSpeechSynthesizer>> expired;
+        std::unique_ptr<Details::PooledSpeechSynthesizer> pooled;
+        std::unique_lock<std::mutex> lock(m_state->mutex);
+        m_state->CollectExpired(expired);
+        for (;;)
+        {
+            auto& bucket = m_state->buckets[key];
+            if (!bucket.idle.empty())
+            {
+                // The most recently used synthesizer is the most likely to still be connected.
+                pooled = std::move(bucket.idle.back());
+                bucket.idle.pop_back();
+                m_state->metrics.Idle--;
+                m_state->metrics.Reuses++;
+                break;
+            }
+            if (bucket.count < m_state->options.MaxSynthesizersPerConfig)
+            {
+                bucket.count++;
+                break;
+            }
+
+            SPX_THROW_HR_IF(SPXERR_TIMEOUT, token.IsExpired());
+            auto wait = std::chrono::milliseconds(100);
+            if (token.GetDeadline() != CancellationToken::Clock_Type::time_point::max())
+            {
+                wait = std::min(wait, std::chrono::duration_cast<std::chrono::milliseconds>(token.GetDeadline() - CancellationToken::Clock_Type::now()) + std::chrono::milliseconds(1));
+            }
+            m_state->available.wait_for(lock, wait);
+        }
+        m_state->metrics.Leased++;
+        lock.unlock();
+        expired.clear();
+
+        if (pooled == nullptr)
+        {
+            try
+            {
+                pooled = Create(key, speechConfig);
+            }
+            catch (...)
+            {
+                lock.lock();
+                m_state->buckets[key].count--;
+                m_state->metrics.Leased--;
+                m_state->available.notify_all();
+                throw;
+            }
+        }
+        else if (m_state->options.OpenConnections)
+        {
+            pooled->Open();
+        }
+
+        auto wait = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        lock.lock();
+        m_state->metrics.Leases++;
+        m_state->metrics.TotalLeaseWait += wait;
+        m_state->metrics.MaxLeaseWait = std::max(m_state->metrics.MaxLeaseWait, wait);
+        lock.unlock();
+
+        return SpeechSynthesizerLease(m_state, std::move(pooled));
+    }
+
+    /// <summary>
+    /// Creates idle synthesizers for the given configuration, up to the given number, and opens their connections.
+    /// </summary>
+    /// <param name="speechConfig">Speech configuration.</param>
+    /// <param name="count">Number of idle synthesizers wanted, at most <see cref="SpeechSynthesizerPoolOptions::MaxSynthesizersPerConfig"/>.</param>
+    void Prewarm(std::shared_ptr<SpeechConfig> speechConfig, size_t count)
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, speechConfig == nullptr);
+
+        auto key = GetKey(*speechConfig);
+        std::unique_lock<std::mutex> lock(m_state->mutex);
+        auto& bucket = m_state->buckets[key];
+        auto missing = count > bucket.idle.size() ? count - bucket.idle.size() : 0;
+        missing = std::min(missing, m_state->options.MaxSynthesizersPerConfig - bucket.count);
+        bucket.count += missing;
+        lock.unlock();
+
+        std::vector<std::unique_ptr<Details::PooledSpeechSynthesizer>> created;
+        try
+        {
+            for (size_t i = 0; i < missing; i++)
+            {
+                created.push_back(Create(key, speechConfig));
+            }
+        }
+        catch (...)
+        {
+            lock.lock();
+            m_state->buckets[key].count -= missing - created.size();
+            AddIdle(key, created);
+            throw;
+        }
+
+        lock.lock();
+        AddIdle(key, created);
+    }
+
+    /// <summary>
+    /// Releases the synthesizers that have been idle longer than <see cref="SpeechSynthesizerPoolOptions::IdleTimeout"/>.
+    /// This also happens whenever a synthesizer is leased or returned.
+    /// </summary>
+    /// <returns>The number of synthesizers released.</returns>
+    size_t EvictIdle()
+    {
+        std::vector<std::unique_ptr<Details::PooledSpeechSynthesizer>> expired;
+        std::unique_lock<std::mutex> lock(m_state->mutex);
+        m_state->CollectExpired(expired);
+        lock.unlock();
+        return expired.size();
+    }
+
+    /// <summary>
+    /// Gets the counters of the pool.
+    /// </summary>
+    /// <returns>A copy of the counters.</returns>
+    SpeechSynthesizerPoolMetrics GetMetrics() const
+    {
+        std::unique_lock<std::mutex> lock(m_state->mutex);
+        return m_state->metrics;
+    }
+
+private:
+
+    explicit SpeechSynthesizerPool(const SpeechSynthesizerPoolOptions& options) :
+        m_state(std::make_shared<Details::SpeechSynthesizerPoolState>(options))
+    {
+    }
+
+    DISABLE_COPY_AND_MOVE(SpeechSynthesizerPool);
+
+    // Configurations differing in anything else share synthesizers, so they must not differ in anything that matters.
+    static std::string GetKey(const SpeechConfig& config)
+    {
+        static const PropertyId keyProperties[] = {
+            PropertyId::SpeechServiceConnection_Endpoint,
+            PropertyId::SpeechServiceConnection_EndpointId,
+            PropertyId::SpeechServiceConnection_Host,
+            PropertyId::SpeechServiceConnection_Region,
+            PropertyId::SpeechServiceConnection_Key,
+            PropertyId::SpeechServiceAuthorization_Token,
+            PropertyId::SpeechServiceConnection_SynthOutputFormat,
+            PropertyId::SpeechServiceConnection_SynthLanguage,
+            PropertyId::SpeechServiceConnection_SynthVoice,
+        };
+
+        std::string key;
+        for (auto id : keyProperties)
+        {
+            key += Utils::ToUTF8(config.GetProperty(id));
+            key += '\n';
+        }
+        return key;
+    }
+
+    std::unique_ptr<Details::PooledSpeechSynthesizer> Create(const std::string& key, const std::shared_ptr<SpeechConfig>& speechConfig)
+    {
+        auto synthesizer = SpeechSynthesizer::FromConfig(speechConfig, nullptr);
+        std::unique_ptr<Details::PooledSpeechSynthesizer> pooled(new Details::PooledSpeechSynthesizer(key, std::move(synthesizer), m_state->options.OpenConnections));
+
+        std::unique_lock<std::mutex> lock(m_state->mutex);
+        m_state->metrics.Creations++;
+        return pooled;
+    }
+
+    // Called with the lock held.
+    void AddIdle(const std::string& key, std::vector<std::unique_ptr<Details::PooledSpeechSynthesizer>>& created)
+    {
+        auto& bucket = m_state->buckets[key];
+        auto now = std::chrono::steady_clock::now();
+        for (auto& pooled : created)
+        {
+            // The newest entries go last, keeping the idle list ordered by release time for CollectExpired.
+            pooled->lastReleased = now;
+            bucket.idle.push_back(std::move(pooled));
+            m_state->metrics.Idle++;
+        }
+        m_state->available.notify_all();
+    }
+
+    std::shared_ptr<Details::SpeechSynthesizerPoolState> m_state;
+};
+
+} } } // Microsoft::CognitiveServices::Speech
@@ -0,0 +1,412 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_ssml_dialogue_converter.h: Public API declarations for SsmlDialogueConverter C++ class
+//
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <memory>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "speechapi_cxx_common.h"
+#include "speechapi_cxx_async_executor.h"
+#include "speechapi_cxx_mapped_file.h"
+#include "speechapi_cxx_ssml_writer.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+
+/*! \cond PRIVATE */
+
+namespace Details {
+
+    // Aho-Corasick automaton over UTF-8 bytes, finding the lowest index of the patterns occurring in a text in one pass.
+    class PatternMatcher
+    {
+    public:
+
+        enum : size_t { NoMatch = static_cast<size_t>(-1) };
+
+        explicit PatternMatcher(const std::vector<std::string>& patterns)
+        {
+            m_next.emplace_back();
+            m_next[0].fill(-1);
+            m_match.push_back(NoMatch);
+
+            for (size_t index = 0; index < patterns.size(); index++)
+            {
+                int32_t state = 0;
+                for (auto ch : patterns[index])
+                {
+                    auto& next = m_next[state][static_cast<unsigned char>(ch)];
+                    if (next < 0)
+                    {
+                        next = static_cast<int32_t>(m_next.size());
+                        m_next.emplace_back();
+                        m_next.back().fill(-1);
+                        m_match.push_back(NoMatch);
+                    }
+                    state = m_next[state][static_cast<unsigned char>(ch)];
+                }
+                if (!patterns[index].empty())
+                {
+                    m_match[state] = std::min(m_match[state], index);
+                }
+            }
+
+            // Breadth-first, turning failure links into direct transitions, so that matching takes one lookup per byte.
+            std::vector<int32_t> fail(m_next.size(), 0);
+            std::queue<int32_t> queue;
+            for (auto& next : m_next[0])
+            {
+                if (next < 0)
+                {
+                    next = 0;
+                }
+                else
+                {
+                    queue.push(next);
+                }
+            }
+            while (!queue.empty())
+            {
+                auto state = queue.front();
+                queue.pop();
+                m_match[state] = std::min(m_match[state], m_match[fail[state]]);
+                for (size_t ch = 0; ch < 256; ch++)
+                {
+                    auto& next = m_next[state][ch];
+                    if (next < 0)
+                    {
+                        next = m_next[fail[state]][ch];
+                    }
+                    else
+                    {
+                        fail[next] = m_next[fail[state]][ch];
+                        queue.push(next);
+                    }
+                }
+            }
+        }
+
+        size_t FindFirst(const char* data, size_t size) const
+        {
+            size_t first = NoMatch;
+            int32_t state = 0;
+            for (size_t pos = 0; pos < size && first != 0; pos++)
+            {
+                state = m_next[state][static_cast<unsigned char>(data[pos])];
+                first = std::min(first, m_match[state]);
+            }
+            return first;
+        }
+
+    private:
+
+        std::vector<std::array<int32_t, 256>> m_next;
+        std::vector<size_t> m_match;
+    };
+
+}
+
+/*! \endcond */
+
+/// <summary>
+/// A speaker of a <see cref="SsmlDialogueConverter"/>.
+/// </summary>
+struct SsmlDialogueRole
+{
+    /// <summary>
+    /// The name of the role, as it appears before the quote or separator in the text.
+    /// </summary>
+    std::string Name;
+
+    /// <summary>
+    /// The voice speaking for the role, e.g. "zh-CN-YunxiNeural".
+    /// </summary>
+    std::string VoiceName;
+
+    /// <summary>
+    /// The bookmark written before the role's lines. Optional.
+    /// </summary>
+    std::string Bookmark;
+};
+
+/// <summary>
+/// Options of a <see cref="SsmlDialogueConverter"/>.
+/// </summary>
+struct SsmlDialogueConverterOptions
+{
+    /// <summary>
+    /// The language of the document.
+    /// </summary>
+    std::string Language = "zh-CN";
+
+    /// <summary>
+    /// The quote mark opening spoken words, in UTF-8.
+    /// </summary>
+    std::string QuoteMark = "\xe2\x80\x9c";
+
+    /// <summary>
+    /// The separator between a speaker and their words, in UTF-8.
+    /// </summary>
+    std::string Separator = "\xef\xbc\x9a";
+
+    /// <summary>
+    /// The pause after each line, in milliseconds.
+    /// </summary>
+    uint32_t BreakAfterLine = 1000;
+
+    /// <summary>
+    /// The approximate size of the blocks of lines converted on different threads, in bytes.
+    /// </summary>
+    size_t BlockSize = 1024 * 1024;
+
+    /// <summary>
+    /// The maximum number of blocks converted at the same time, or 0 for the number of hardware threads.
+    /// </summary>
+    size_t MaxConcurrency = 0;
+};
+
+/// <summary>
+/// Converts plain text dialogue into SSML, one line at a time, giving each line the voice of its speaker.
+/// </summary>
+/// <remarks>
+/// A line is spoken by a role if the role's name occurs in the part of the line before the speaker's words:
+/// - If the quote mark splits the line into exactly three parts, the first part is the speaker and the second part
+///   their words.
+/// - If the separator splits the line into exactly two parts, the first part is the speaker and the second part their
+///   words.
+/// If several roles match, the first one in the role table wins, and the quote mark wins over the separator for the
+/// same role. The speaker part is read by the narrator and the words by the role. Lines without a speaker are read by
+/// the narrator. Empty lines are skipped.
+/// Role names are matched with an automaton built once, so the cost per line does not grow with the number of roles.
+/// The converter can be used from several threads at the same time.
+/// </remarks>
+class SsmlDialogueConverter
+{
+public:
+
+    /// <summary>
+    /// Creates a converter.
+    /// </summary>
+    /// <param name="narrator">The role reading lines without a speaker. Its name is not matched.</param>
+    /// <param name="roles">The roles, in order of priority.</param>
+    /// <param name="options">The options of the converter.</param>
+    /// <returns>A smart pointer wrapped converter.</returns>
+    static std::shared_ptr<SsmlDialogueConverter> Create(const SsmlDialogueRole& narrator, const std::vector<SsmlDialogueRole>& roles, const SsmlDialogueConverterOptions& options = SsmlDialogueConverterOptions())
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, narrator.VoiceName.empty());
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, options.Language.empty() || options.QuoteMark.empty() || options.Separator.empty());
+        for (const auto& role : roles)
+        {
+            SPX_THROW_HR_IF(SPXERR_INVALID_ARG, role.Name.empty() || role.VoiceName.empty());
+        }
+        return std::shared_ptr<SsmlDialogueConverter>(new SsmlDialogueConverter(narrator, roles, options));
+    }
+
+    /// <summary>
+    /// Converts a text into an SSML document.
+    /// </summary>
+    /// <param name="text">The text, in UTF-8, with one line per paragraph.</param>
+    /// <returns>The SSML document.</returns>
+    std::string ConvertText(const std::string& text) const
+    {
+        std::string ssml;
+        ssml.reserve(text.size() * 2);
+        Convert(text.data(), text.size(), [&ssml](const char* data, size_t size) { ssml.append(data, size); });
+        return ssml;
+    }
+
+    /// <summary>
+    /// Converts a text file into an SSML file. The text file is mapped into memory rather than read.
+    /// </summary>
+    /// <param name="inputPath">The path of the text file, in UTF-8.</param>
+    /// <param name="outputPath">The path of the SSML file, replaced if it exists.</param>
+    void ConvertFile(const std::string& inputPath, const std::string& outputPath) const
+    {
+        Details::MappedFile input(inputPath);
+        std::unique_ptr<FILE, int(*)(FILE*)> output(std::fopen(outputPath.c_str(), "wb"), std::fclose);
+        SPX_THROW_HR_IF(SPXERR_FILE_OPEN_FAILED, output == nullptr);
+        Convert(input.GetData(), input.GetSize(), [&output](const char* data, size_t size) {
+            SPX_THROW_HR_IF(SPXERR_RUNTIME_ERROR, std::fwrite(data, 1, size, output.get()) != size);
+        });
+        SPX_THROW_HR_IF(SPXERR_RUNTIME_ERROR, std::fclose(output.release()) != 0);
+    }
+
+private:
+
+    SsmlDialogueConverter(const SsmlDialogueRole& narrator, const std::vector<SsmlDialogueRole>& roles, const SsmlDialogueConverterOptions& options) :
+        m_narrator(narrator),
+        m_roles(roles),
+        m_options(options),
+        m_matcher(GetNames(roles))
+    {
+        SsmlWriter writer;
+        writer.StartSpeak({ m_options.Language });
+        m_header = writer.GetSsml();
+    }
+
+    DISABLE_COPY_AND_MOVE(SsmlDialogueConverter);
+
+    static std::vector<std::string> GetNames(const std::vector<SsmlDialogueRole>& roles)
+    {
+        std::vector<std::string> names;
+        for (const auto& role : roles)
+        {
+            names.push_back(role.Name);
+        }
+        return names;
+    }
+
+    // Converts blocks of lines in parallel, passing the document to the sink in order.
+    template <class TSink>
+    void Convert(const char* data, size_t size, TSink sink) const
+    {
+        static const char footer[] = "</speak>";
+        auto concurrency = m_options.MaxConcurrency != 0 ? m_options.MaxConcurrency : std::max<size_t>(1, std::thread::hardware_concurrency());
+        auto blockSize = std::max<size_t>(1, m_options.BlockSize);
+
+        std::deque<std::future<std::string>> pending;
+        try
+        {
+            sink(m_header.data(), m_header.size());
+            size_t pos = 0;
+            while (pos < size || !pending.empty())
+            {
+                if (pos < size && pending.size() < concurrency)
+                {
+                    auto end = std::min(size, pos + blockSize);
+                    auto newline = end < size ? static_cast<const char*>(std::memchr(data + end, '\n', size - end)) : nullptr;
+                    end = newline != nullptr ? static_cast<size_t>(newline - data) + 1 : size;
+                    auto block = data + pos;
+                    auto blockLength = end - pos;
+                    pending.push_back(Details::RunAsync([this, block, blockLength]() { return ConvertBlock(block, blockLength); }));
+                    pos = end;
+                    continue;
+                }
+                auto body = pending.front().get();
+                pending.pop_front();
+                sink(body.data(), body.size());
+            }
+            sink(footer, sizeof(footer) - 1);
+        }
+        catch (...)
+        {
+            // The blocks point into the input, which must outlive them.
+            for (auto& block : pending)
+            {
+                block.wait();
+            }
+            throw;
+        }
+    }
+
+    // Converts a block of lines, returning the elements inside the speak element.
+    std::string ConvertBlock(const char* data, size_t size) const
+    {
+        SsmlWriter writer;
+        writer.Reserve(m_header.size() + size * 2);
+        writer.StartSpeak({ m_options.Language });
+        std::string line;
+        size_t pos = 0;
+        while (pos < size)
+        {
+            auto newline = static_cast<const char*>(std::memchr(data + pos, '\n', size - pos));
+            auto end = newline != nullptr ? static_cast<size_t>(newline - data) : size;
+            auto length = end - pos;
+            if (length > 0 && data[pos + length - 1] == '\r')
+            {
+                length--;
+            }
+            if (length > 0)
+            {
+                line.assign(data + pos, length);
+                ConvertLine(line, writer);
+            }
+            pos = end + 1;
+        }
+        writer.EndDocument();
+        const auto& ssml = writer.GetSsml();
+        return ssml.substr(m_header.size(), ssml.size() - m_header.size() - std::strlen("</speak>"));
+    }
+
+    void ConvertLine(const std::string& line, SsmlWriter& writer) const
+    {
+        size_t quoteRole = Details::PatternMatcher::NoMatch;
+        size_t separatorRole = Details::PatternMatcher::NoMatch;
+        std::string quoteWords;
+        std::string separatorWords;
+
+        std::vector<size_t> quotes;
+        for (auto found = line.find(m_options.QuoteMark); found != std::string::npos && quotes.size() < 3; found = line.find(m_options.QuoteMark, found + m_options.QuoteMark.size()))
+        {
+            quotes.push_back(found);
+        }
+        if (quotes.size() == 2)
+        {
+            quoteRole = m_matcher.FindFirst(line.data(), quotes[0]);
+        }
+
+        auto separator = line.find(m_options.Separator);
+        if (separator != std::string::npos && quoteRole != 0 && line.find(m_options.Separator, separator + m_options.Separator.size()) == std::string::npos)
+        {
+            separatorRole = m_matcher.FindFirst(line.data(), separator);
+        }
+
+        if (quoteRole != Details::PatternMatcher::NoMatch && quoteRole <= separatorRole)
+        {
+            auto start = quotes[0] + m_options.QuoteMark.size();
+            WriteDialogue(writer, line.substr(0, quotes[0]), m_roles[quoteRole], line.substr(start, quotes[1] - start));
+        }
+        else if (separatorRole != Details::PatternMatcher::NoMatch)
+        {
+            WriteDialogue(writer, line.substr(0, separator + m_options.Separator.size()), m_roles[separatorRole], line.substr(separator + m_options.Separator.size()));
+        }
+        else
+        {
+            WriteVoice(writer, m_narrator, line, true);
+        }
+    }
+
+    void WriteDialogue(SsmlWriter& writer, const std::string& speaker, const SsmlDialogueRole& role, const std::string& words) const
+    {
+        WriteVoice(writer, m_narrator, speaker, false);
+        WriteVoice(writer, role, words, true);
+    }
+
+    void WriteVoice(SsmlWriter& writer, const SsmlDialogueRole& role, const std::string& text, bool pause) const
+    {
+        writer.StartVoice({ role.VoiceName });
+        if (!role.Bookmark.empty())
+        {
+            writer.Bookmark(role.Bookmark);
+        }
+        writer.Text(text);
+        if (pause && m_options.BreakAfterLine > 0)
+        {
+            writer.Break(m_options.BreakAfterLine);
+        }
+        writer.EndElement();
+    }
+
+    const SsmlDialogueRole m_narrator;
+    const std::vector<SsmlDialogueRole> m_roles;
+    const SsmlDialogueConverterOptions m_options;
+    const Details::PatternMatcher m_matcher;
+    std::string m_header;
+};
+
+} } } // Microsoft::CognitiveServices::Speech
@@ -0,0 +1,652 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_ssml_segmenter.h: Public API declarations for SsmlSegment and SsmlSegmenter C++ classes
+//
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "speechapi_cxx_common.h"
+#include "speechapi_cxx_enums.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+
+/*! \cond PRIVATE */
+
+namespace Details {
+
+    // 128 bit hash of content, as 32 hex digits. Not cryptographic; used to recognize content that was synthesized before.
+    inline std::string HashContent(const std::string& content)
+    {
+        auto mix = [](uint64_t x) {
+            x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ull;
+            x ^= x >> 27; x *= 0x94d049bb133111ebull;
+            x ^= x >> 31;
+            return x;
+        };
+
+        uint64_t h1 = 0x243f6a8885a308d3ull ^ content.size();
+        uint64_t h2 = 0x13198a2e03707344ull ^ (static_cast<uint64_t>(content.size()) << 1);
+        size_t i = 0;
+        for (; i + 8 <= content.size(); i += 8)
+        {
+            uint64_t chunk;
+            std::memcpy(&chunk, content.data() + i, 8);
+            h1 = mix(h1 ^ chunk);
+            h2 = mix(h2 + chunk * 0x9e3779b97f4a7c15ull) ^ h1;
+        }
+        uint64_t tail = 0;
+        std::memcpy(&tail, content.data() + i, content.size() - i);
+        h1 = mix(h1 ^ tail ^ 0xa4093822299f31d0ull);
+        h2 = mix(h2 + tail * 0x9e3779b97f4a7c15ull) ^ h1;
+
+        static const char digits[] = "0123456789abcdef";
+        std::string hex(32, '0');
+        for (int n = 0; n < 16; n++)
+        {
+            hex[15 - n] = digits[(h1 >> (4 * n)) & 0xf];
+            hex[31 - n] = digits[(h2 >> (4 * n)) & 0xf];
+        }
+        return hex;
+    }
+
+    // Collapses whitespace, so that reformatting a document does not change its hash.
+    inline std::string NormalizeContent(const std::string& content)
+    {
+        std::string normalized;
+        normalized.reserve(content.size());
+        bool space = false;
+        for (auto ch : content)
+        {
+            if (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n')
+            {
+                space = true;
+                continue;
+            }
+            if (space && !normalized.empty())
+            {
+                normalized += ' ';
+            }
+            space = false;
+            normalized += ch;
+        }
+        return normalized;
+    }
+
+}
+
+/*! \endcond */
+
+/// <summary>
+/// A part of an SSML document that can be synthesized on its own, see <see cref="SsmlSegmenter"/>.
+/// </summary>
+class SsmlSegment
+{
+public:
+
+    /// <summary>
+    /// The SSML of the segment: a complete &lt;speak&gt; document that re-opens the elements enclosing the body.
+    /// </summary>
+    std::string Ssml;
+
+    /// <summary>
+    /// Offset of the body in <see cref="Ssml"/>, in bytes.
+    /// </summary>
+    size_t BodyOffset = 0;
+
+    /// <summary>
+    /// Offset of the body in the source document, in bytes.
+    /// </summary>
+    size_t SourceOffset = 0;
+
+    /// <summary>
+    /// Length of the body, in bytes. The body is copied from the source document unchanged.
+    /// </summary>
+    size_t SourceLength = 0;
+
+    /// <summary>
+    /// Maps a text offset reported for this segment, e.g. by a word boundary event, to the same position in the source document.
+    /// Text offsets are counted in UTF-16 code units, like the offsets reported by the service.
+    /// </summary>
+    /// <param name="textOffset">Text offset in <see cref="Ssml"/>.</param>
+    /// <returns>Text offset in the source document, or textOffset unchanged if it does not point into the body.</returns>
+    uint32_t ToSourceTextOffset(uint32_t textOffset) const
+    {
+        if (textOffset < m_bodyTextOffset || textOffset == UINT32_MAX)
+        {
+            return textOffset;
+        }
+        return textOffset - m_bodyTextOffset + m_sourceTextOffset;
+    }
+
+private:
+
+    friend class SsmlSegmenter;
+
+    uint32_t m_bodyTextOffset = 0;
+    uint32_t m_sourceTextOffset = 0;
+};
+
+/// <summary>
+/// Splits an SSML document into segments of bounded size that can be synthesized independently and concurrently.
+/// </summary>
+/// <remarks>
+/// Segments end, in order of preference, between the children of &lt;speak&gt; (e.g. &lt;voice&gt; elements), after
+/// &lt;p&gt;, &lt;mstts:express-as&gt; or &lt;prosody&gt; elements, after sentences, and after &lt;break&gt; elements.
+/// Only &lt;speak&gt;, &lt;voice&gt;, &lt;mstts:express-as&gt;, &lt;prosody&gt;, &lt;lang&gt;, &lt;p&gt; and &lt;s&gt; are split;
+/// each segment re-opens them with their original attributes, and repeats the &lt;lexicon&gt; elements of the document.
+/// Segments without text or content elements are dropped. The document is checked for well-formed tags only.
+/// </remarks>
+class SsmlSegmenter
+{
+public:
+
+    /// <summary>
+    /// The default maximum size of a segment, in bytes.
+    /// </summary>
+    static constexpr size_t DefaultMaxSegmentLength = 4096;
+
+    /// <summary>
+    /// Splits an SSML document.
+    /// </summary>
+    /// <param name="ssml">The SSML document, UTF-8 encoded.</param>
+    /// <param name="maxSegmentLength">Maximum size of the SSML of a segment, in bytes. It is exceeded only where an element that is not split is larger.</param>
+    /// <param name="mode">Where segments end.</param>
+    /// <returns>The segments, in document order.</returns>
+    static std::vector<SsmlSegment> Split(const std::string& ssml, size_t maxSegmentLength = DefaultMaxSegmentLength, SsmlSegmentationMode mode = SsmlSegmentationMode::Packed)
+    {
+        SsmlSegmenter segmenter(ssml);
+        return segmenter.Split(maxSegmentLength, mode);
+    }
+
+private:
+
+    // Where a segment may end; higher ranks are preferred.
+    enum class CutRank : int { Word = 0, Break = 1, Sentence = 2, Element = 3, Child = 4, End = 5 };
+
+    struct Element
+    {
+        size_t tagBegin;
+        size_t tagEnd;
+        std::string name;
+        int parent;
+        size_t prefixLength;
+        size_t suffixLength;
+    };
+
+    struct Cut
+    {
+        size_t offset;
+        CutRank rank;
+        int element;
+    };
+
+    struct TextRun
+    {
+        size_t begin;
+        size_t end;
+        int element;
+    };
+
+    struct Content
+    {
+        size_t begin;
+        size_t end;
+        bool text;
+    };
+
+    explicit SsmlSegmenter(const std::string& ssml) :
+        m_ssml(ssml)
+    {
+        Parse();
+    }
+
+    static bool IsSplittable(const std::string& name)
+    {
+        return name == "speak" || name == "voice" || name == "mstts:express-as" || name == "prosody" ||
+            name == "lang" || name == "p" || name == "s";
+    }
+
+    static bool IsSpace(char ch)
+    {
+        return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n';
+    }
+
+    static bool IsContinuationByte(char ch)
+    {
+        return (static_cast<unsigned char>(ch) & 0xC0) == 0x80;
+    }
+
+    static uint32_t CountUtf16(const std::string& text, size_t begin, size_t end)
+    {
+        uint32_t count = 0;
+        for (auto i = begin; i < end; i++)
+        {
+            auto ch = static_cast<unsigned char>(text[i]);
+            count += IsContinuationByte(text[i]) ? 0 : (ch >= 0xF0 ? 2 : 1);
+        }
+        return count;
+    }
+
+    void Parse()
+    {
+        std::vector<int> open;
+        size_t i = 0;
+        while (i < m_ssml.size())
+        {
+            if (m_ssml[i] != '<')
+            {
+                auto end = std::min(m_ssml.find('<', i), m_ssml.size());
+                AddText(i, end, open, true);
+                i = end;
+            }
+            else if (m_ssml.compare(i, 4, "<!--") == 0)
+            {
+                i = FindEnd(i, "-->");
+            }
+            else if (m_ssml.compare(i, 9, "<![CDATA[") == 0)
+            {
+                auto end = FindEnd(i, "]]>");
+                AddText(i, end, open, false);
+                i = end;
+            }
+            else if (m_ssml.compare(i, 2, "<?") == 0)
+            {
+                i = FindEnd(i, "?>");
+            }
+            else if (m_ssml.compare(i, 2, "<!") == 0)
+            {
+                i = FindEnd(i, ">");
+            }
+            else
+            {
+                i = ParseTag(i, open);
+            }
+        }
+
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, m_root < 0 || !open.empty() || m_speakEnd == 0);
+        m_cuts.push_back(Cut{ m_speakEnd, CutRank::End, m_root });
+    }
+
+    size_t FindEnd(size_t begin, const char* terminator)
+    {
+        auto end = m_ssml.find(terminator, begin);
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, end == std::string::npos);
+        return end + std::char_traits<char>::length(terminator);
+    }
+
+    size_t ParseTag(size_t begin, std::vector<int>& open)
+    {
+        auto closing = m_ssml.compare(begin, 2, "</") == 0;
+        auto nameBegin = begin + (closing ? 2 : 1);
+        auto nameEnd = nameBegin;
+        while (nameEnd < m_ssml.size() && !IsSpace(m_ssml[nameEnd]) && m_ssml[nameEnd] != '>' && m_ssml[nameEnd] != '/')
+        {
+            nameEnd++;
+        }
+
+        // Find the end of the tag, skipping over quoted attribute values.
+        auto end = nameEnd;
+        char quote = 0;
+        while (end < m_ssml.size() && (quote != 0 || m_ssml[end] != '>'))
+        {
+            if (quote == 0 && (m_ssml[end] == '"' || m_ssml[end] == '\''))
+            {
+                quote = m_ssml[end];
+            }
+            else if (quote != 0 && m_ssml[end] == quote)
+            {
+                quote = 0;
+            }
+            end++;
+        }
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, end == m_ssml.size() || nameEnd == nameBegin);
+        end++;
+
+        auto name = m_ssml.substr(nameBegin, nameEnd - nameBegin);
+        auto parent = open.empty() ? -1 : open.back();
+        if (closing)
+        {
+            SPX_THROW_HR_IF(SPXERR_INVALID_ARG, open.empty() || m_elements[open.back()].name != name);
+            open.pop_back();
+            if (open.empty())
+            {
+                m_speakEnd = begin;
+            }
+            else if (IsAllSplittable(open.back()))
+            {
+                auto rank = open.back() == m_root ? CutRank::Child : (name == "s" ? CutRank::Sentence : CutRank::Element);
+                m_cuts.push_back(Cut{ end, IsSplittable(name) ? rank : CutRank::Break, open.back() });
+            }
+            return end;
+        }
+
+        auto empty = m_ssml[end - 2] == '/';
+        if (open.empty())
+        {
+            // The root, together with anything before it, opens every segment.
+            SPX_THROW_HR_IF(SPXERR_INVALID_ARG, name != "speak" || empty || m_root >= 0);
+            m_root = static_cast<int>(m_elements.size());
+            m_elements.push_back(Element{ 0, end, name, -1, end, name.size() + 3 });
+            open.push_back(m_root);
+            return end;
+        }
+
+        if (name == "lexicon" && parent == m_root)
+        {
+            m_lexicons += m_ssml.substr(begin, end - begin);
+        }
+        else if (!IsSplittable(name))
+        {
+            m_contents.push_back(Content{ begin, end, false });
+        }
+
+        if (empty)
+        {
+            // Other empty elements, such as bookmarks, stay with the content that follows them.
+            if (IsAllSplittable(parent) && (parent == m_root || name == "break"))
+            {
+                m_cuts.push_back(Cut{ end, parent == m_root ? CutRank::Child : CutRank::Break, parent });
+            }
+            return end;
+        }
+
+        auto& parentElement = m_elements[parent];
+        m_elements.push_back(Element{ begin, end, name, parent, parentElement.prefixLength + (end - begin), parentElement.suffixLength + name.size() + 3 });
+        open.push_back(static_cast<int>(m_elements.size() - 1));
+        return end;
+    }
+
+    void AddText(size_t begin, size_t end, const std::vector<int>& open, bool splittable)
+    {
+        auto nonSpace = begin;
+        while (nonSpace < end && IsSpace(m_ssml[nonSpace]))
+        {
+            nonSpace++;
+        }
+        if (nonSpace == end || open.empty())
+        {
+            return;
+        }
+
+        m_contents.push_back(Content{ begin, end, true });
+        auto element = open.back();
+        if (!splittable || !IsAllSplittable(element))
+        {
+            return;
+        }
+
+        m_textRuns.push_back(TextRun{ begin, end, element });
+        for (auto i = begin; i < end; i++)
+        {
+            auto sentenceEnd = EndOfSentence(i, end);
+            if (sentenceEnd != 0)
+            {
+                m_cuts.push_back(Cut{ sentenceEnd, CutRank::Sentence, element });
+                i = sentenceEnd - 1;
+            }
+        }
+    }
+
+    // Returns the offset after the sentence terminator at offset, including closing quotes, or 0.
+    size_t EndOfSentence(size_t offset, size_t end) const
+    {
+        static const char* const wideTerminators[] = { "\xE3\x80\x82", "\xEF\xBC\x81", "\xEF\xBC\x9F", "\xE2\x80\xA6", "\xEF\xBC\x9B" }; // 。！？…；
+        static const char* const closingQuotes[] = { "\"", "'", "\xE2\x80\x9D", "\xE2\x80\x99", "\xE3\x80\x8D", "\xE3\x80\x8F", "\xEF\xBC\x89" }; // " ' ” ’ 」 』 ）
+
+        size_t after = 0;
+        auto ch = m_ssml[offset];
+        if (ch == '.' || ch == '!' || ch == '?')
+        {
+            after = offset + 1;
+        }
+        for (auto terminator : wideTerminators)
+        {
+            if (after == 0 && m_ssml.compare(offset, 3, terminator) == 0)
+            {
+                after = offset + 3;
+            }
+        }
+        if (after == 0)
+        {
+            return 0;
+        }
+
+        // Runs of terminators (e.g. "?!" or "……") and closing quotes stay with the sentence.
+        for (auto more = true; more && after < end;)
+        {
+            more = false;
+            auto next = EndOfSentence(after, end);
+            if (next != 0)
+            {
+                after = next;
+                more = true;
+                continue;
+            }
+            for (auto quote : closingQuotes)
+            {
+                auto length = std::char_traits<char>::length(quote);
+                if (!more && m_ssml.compare(after, length, quote) == 0)
+                {
+                    after += length;
+                    more = true;
+                }
+            }
+        }
+
+        // ASCII terminators need whitespace after them, so that numbers and abbreviations are not split.
+        if (ch == '.' || ch == '!' || ch == '?')
+        {
+            return after == end || IsSpace(m_ssml[after]) ? after : 0;
+        }
+        return after;
+    }
+
+    bool IsAllSplittable(int element) const
+    {
+        for (; element >= 0; element = m_elements[element].parent)
+        {
+            if (!IsSplittable(m_elements[element].name))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t SegmentLength(size_t begin, int beginElement, size_t end, int endElement) const
+    {
+        auto lexicons = begin == m_elements[m_root].tagEnd ? 0 : m_lexicons.size();
+        return m_elements[beginElement].prefixLength + lexicons + (end - begin) + m_elements[endElement].suffixLength;
+    }
+
+    bool HasContent(size_t begin, size_t end) const
+    {
+        auto it = std::upper_bound(m_contents.begin(), m_contents.end(), begin,
+            [](size_t offset, const Content& content) { return offset < content.end; });
+        for (; it != m_contents.end() && it->begin < end; ++it)
+        {
+            if (!it->text)
+            {
+                return true;
+            }
+            for (auto i = std::max(it->begin, begin); i < std::min(it->end, end); i++)
+            {
+                if (!IsSpace(m_ssml[i]))
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Used when no element or sentence boundary fits: ends the segment in a text run, at whitespace if possible.
+    bool FindTextCut(size_t begin, int beginElement, size_t maxSegmentLength, Cut& cut) const
+    {
+        auto limit = std::upper_bound(m_textRuns.begin(), m_textRuns.end(), begin + maxSegmentLength,
+            [](size_t offset, const TextRun& run) { return offset < run.begin; });
+        for (auto it = std::reverse_iterator<decltype(limit)>(limit); it != m_textRuns.rend(); ++it)
+        {
+            if (it->end <= begin)
+            {
+                break;
+            }
+
+            auto runBegin = std::max(it->begin, begin) + 1;
+            auto fixedLength = SegmentLength(begin, beginElement, begin, it->element);
+            if (fixedLength >= maxSegmentLength || runBegin >= it->end)
+            {
+                continue;
+            }
+
+            auto last = std::min(it->end - 1, begin + (maxSegmentLength - fixedLength));
+            if (last < runBegin)
+            {
+                continue;
+            }
+
+            auto offset = last;
+            while (offset > runBegin && !IsSpace(m_ssml[offset]))
+            {
+                offset--;
+            }
+            if (!IsSpace(m_ssml[offset]))
+            {
+                offset = last;
+                while (offset > runBegin && IsContinuationByte(m_ssml[offset]))
+                {
+                    offset--;
+                }
+
+                // Do not split character references such as &amp;.
+                auto reference = m_ssml.rfind('&', offset);
+                if (reference != std::string::npos && reference >= runBegin && m_ssml.find(';', reference) >= offset)
+                {
+                    offset = reference;
+                }
+            }
+            if (!IsContinuationByte(m_ssml[offset]))
+            {
+                cut = Cut{ offset, CutRank::Word, it->element };
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<SsmlSegment> Split(size_t maxSegmentLength, SsmlSegmentationMode mode)
+    {
+        std::vector<SsmlSegment> segments;
+
+        auto begin = m_elements[m_root].tagEnd;
+        auto beginElement = m_root;
+        size_t next = 0;
+        uint32_t sourceTextOffset = CountUtf16(m_ssml, 0, begin);
+        size_t sourceTextCounted = begin;
+
+        while (begin < m_speakEnd)
+        {
+            // The latest of the highest ranked cuts that fit, or per element the first element cut that fits;
+            // if none fits, the first cut after begin.
+            const Cut* best = nullptr;
+            const Cut* first = nullptr;
+            for (auto i = next; i < m_cuts.size(); i++)
+            {
+                auto& cut = m_cuts[i];
+                if (cut.offset <= begin)
+                {
+                    next = i + 1;
+                    continue;
+                }
+                first = first != nullptr ? first : &cut;
+                if (SegmentLength(begin, beginElement, cut.offset, cut.element) > maxSegmentLength)
+                {
+                    break;
+                }
+                if (best == nullptr || cut.rank >= best->rank)
+                {
+                    best = &cut;
+                }
+                if (mode == SsmlSegmentationMode::PerElement && cut.rank >= CutRank::Element)
+                {
+                    break;
+                }
+            }
+
+            Cut textCut;
+            if (best == nullptr && FindTextCut(begin, beginElement, maxSegmentLength, textCut))
+            {
+                best = &textCut;
+            }
+            best = best != nullptr ? best : first;
+
+            if (HasContent(begin, best->offset))
+            {
+                sourceTextOffset += CountUtf16(m_ssml, sourceTextCounted, begin);
+                sourceTextCounted = begin;
+                segments.push_back(MakeSegment(begin, beginElement, best->offset, best->element, sourceTextOffset));
+            }
+
+            begin = best->offset;
+            beginElement = best->element;
+        }
+
+        return segments;
+    }
+
+    SsmlSegment MakeSegment(size_t begin, int beginElement, size_t end, int endElement, uint32_t sourceTextOffset) const
+    {
+        std::vector<int> opening;
+        for (auto element = beginElement; element >= 0; element = m_elements[element].parent)
+        {
+            opening.push_back(element);
+        }
+
+        SsmlSegment segment;
+        segment.Ssml.reserve(SegmentLength(begin, beginElement, end, endElement));
+        for (auto it = opening.rbegin(); it != opening.rend(); ++it)
+        {
+            auto& element = m_elements[*it];
+            segment.Ssml.append(m_ssml, element.tagBegin, element.tagEnd - element.tagBegin);
+            if (*it == m_root && begin != element.tagEnd)
+            {
+                segment.Ssml += m_lexicons;
+            }
+        }
+
+        segment.BodyOffset = segment.Ssml.size();
+        segment.SourceOffset = begin;
+        segment.SourceLength = end - begin;
+        segment.m_bodyTextOffset = CountUtf16(segment.Ssml, 0, segment.Ssml.size());
+        segment.m_sourceTextOffset = sourceTextOffset;
+        segment.Ssml.append(m_ssml, begin, end - begin);
+
+        for (auto element = endElement; element >= 0; element = m_elements[element].parent)
+        {
+            segment.Ssml += "</" + m_elements[element].name + ">";
+        }
+        return segment;
+    }
+
+    const std::string& m_ssml;
+
+    std::vector<Element> m_elements;
+    std::vector<Cut> m_cuts;
+    std::vector<TextRun> m_textRuns;
+    std::vector<Content> m_contents;
+    std::string m_lexicons;
+    int m_root = -1;
+    size_t m_speakEnd = 0;
+};
+
+} } } // Microsoft::CognitiveServices::Speech
@@ -0,0 +1,442 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_ssml_writer.h: Public API declarations for SsmlWriter C++ class
+//
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "speechapi_cxx_common.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+
+/*! \cond PRIVATE */
+
+namespace Details {
+
+    // Replacement of a byte in XML text or attribute values, or nullptr if the byte is written as is.
+    // Control characters other than tab and line breaks are not allowed in XML, even escaped, and are dropped.
+    inline const char* GetXmlEntity(unsigned char ch, bool attribute)
+    {
+        switch (ch)
+        {
+        case '&': return "&amp;";
+        case '<': return "&lt;";
+        case '>': return "&gt;";
+        case '"': return attribute ? "&quot;" : nullptr;
+        case '\'': return attribute ? "&apos;" : nullptr;
+        case '\t': case '\n': case '\r': return nullptr;
+        default: return ch < 0x20 ? "" : nullptr;
+        }
+    }
+
+    // Position of the first byte at or after pos that must be escaped, or size if there is none.
+    // Skips eight bytes at a time while none of them is a control character or markup.
+    inline size_t FindXmlEscape(const char* data, size_t size, size_t pos, bool attribute)
+    {
+        const uint64_t ones = 0x0101010101010101ull;
+        const uint64_t highs = 0x8080808080808080ull;
+        auto hasByte = [=](uint64_t word, unsigned char ch) {
+            auto x = word ^ (ones * ch);
+            return ((x - ones) & ~x & highs) != 0;
+        };
+
+        while (pos + 8 <= size)
+        {
+            uint64_t word;
+            std::memcpy(&word, data + pos, 8);
+            bool candidate = ((word - ones * 0x20) & ~word & highs) != 0
+                || hasByte(word, '&') || hasByte(word, '<') || hasByte(word, '>')
+                || (attribute && (hasByte(word, '"') || hasByte(word, '\'')));
+            if (candidate)
+            {
+                for (size_t end = pos + 8; pos < end; pos++)
+                {
+                    if (GetXmlEntity(static_cast<unsigned char>(data[pos]), attribute) != nullptr)
+                    {
+                        return pos;
+                    }
+                }
+                continue;
+            }
+            pos += 8;
+        }
+        for (; pos < size; pos++)
+        {
+            if (GetXmlEntity(static_cast<unsigned char>(data[pos]), attribute) != nullptr)
+            {
+                return pos;
+            }
+        }
+        return size;
+    }
+
+    enum class SsmlElement { Speak, Voice, ExpressAs, Prosody };
+
+}
+
+/*! \endcond */
+
+/// <summary>
+/// Attributes of the speak element written by <see cref="SsmlWriter::StartSpeak"/>.
+/// </summary>
+struct SsmlSpeakAttributes
+{
+    /// <summary>
+    /// The language of the document, e.g. "zh-CN". Required.
+    /// </summary>
+    std::string Language = "en-US";
+};
+
+/// <summary>
+/// Attributes of the voice element written by <see cref="SsmlWriter::StartVoice"/>.
+/// </summary>
+struct SsmlVoiceAttributes
+{
+    /// <summary>
+    /// The name of the voice, e.g. "zh-CN-YunxiNeural". Required.
+    /// </summary>
+    std::string Name;
+};
+
+/// <summary>
+/// Attributes of the mstts:express-as element written by <see cref="SsmlWriter::StartExpressAs"/>.
+/// Empty attributes are not written.
+/// </summary>
+struct SsmlExpressAsAttributes
+{
+    /// <summary>
+    /// The speaking style, e.g. "sad" or "chat". Required.
+    /// </summary>
+    std::string Style;
+
+    /// <summary>
+    /// The intensity of the style, e.g. "2.0".
+    /// </summary>
+    std::string StyleDegree;
+
+    /// <summary>
+    /// The role played by the voice, e.g. "Girl".
+    /// </summary>
+    std::string Role;
+};
+
+/// <summary>
+/// Attributes of the prosody element written by <see cref="SsmlWriter::StartProsody"/>.
+/// Empty attributes are not written.
+/// </summary>
+struct SsmlProsodyAttributes
+{
+    /// <summary>
+    /// The speaking rate, e.g. "0.8" or "-10%".
+    /// </summary>
+    std::string Rate;
+
+    /// <summary>
+    /// The baseline pitch, e.g. "high" or "+5%".
+    /// </summary>
+    std::string Pitch;
+
+    /// <summary>
+    /// The volume, e.g. "70" or "loud".
+    /// </summary>
+    std::string Volume;
+
+    /// <summary>
+    /// The pitch contour, e.g. "(0%,+20Hz) (50%,-10Hz)".
+    /// </summary>
+    std::string Contour;
+
+    /// <summary>
+    /// The pitch range, e.g. "x-high".
+    /// </summary>
+    std::string Range;
+};
+
+/// <summary>
+/// Writes an SSML document element by element into a buffer that is reused across documents, escaping text and
+/// attribute values. The result can be passed to <see cref="SpeechSynthesizer::SpeakSsml"/>, the parallel synthesizer,
+/// the cache or the coalescer.
+/// Each element has its own attribute set, so only attributes the element supports can be written.
+/// </summary>
+/// <remarks>
+/// Text, bookmarks and breaks must be written inside a voice element; elements must be nested as speak, voice, then
+/// any of express-as and prosody. Writing out of order throws.
+/// To allocate the buffer once, pass the code writing the document to <see cref="Measure"/> and the size it returns to
+/// <see cref="Reserve"/>, then write the document.
+/// </remarks>
+class SsmlWriter
+{
+public:
+
+    /// <summary>
+    /// Creates a writer with an empty buffer.
+    /// </summary>
+    SsmlWriter() = default;
+
+    /// <summary>
+    /// Gets the exact size of the document written by a function, without writing it.
+    /// </summary>
+    /// <param name="write">A function taking a <see cref="SsmlWriter"/> reference and writing the document to it.</param>
+    /// <returns>The size of the document in bytes.</returns>
+    template <class TWrite>
+    static size_t Measure(TWrite&& write)
+    {
+        SsmlWriter writer;
+        writer.m_measuring = true;
+        write(writer);
+        return writer.m_size;
+    }
+
+    /// <summary>
+    /// Reserves buffer space for a document.
+    /// </summary>
+    /// <param name="size">The size of the document in bytes, see <see cref="Measure"/>.</param>
+    void Reserve(size_t size)
+    {
+        if (!m_measuring)
+        {
+            m_buffer.reserve(size);
+        }
+    }
+
+    /// <summary>
+    /// Discards the document, keeping the buffer for the next one.
+    /// </summary>
+    void Reset()
+    {
+        m_buffer.clear();
+        m_open.clear();
+        m_size = 0;
+        m_ended = false;
+    }
+
+    /// <summary>
+    /// Starts the document with a speak element.
+    /// </summary>
+    /// <param name="attributes">The attributes of the element.</param>
+    void StartSpeak(const SsmlSpeakAttributes& attributes)
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_STATE, m_ended || !m_open.empty());
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, attributes.Language.empty());
+        Append("<speak version=\"1.0\" xmlns=\"http://www.w3.org/2001/10/synthesis\" xmlns:mstts=\"https://www.w3.org/2001/mstts\"");
+        AppendAttribute(" xml:lang=\"", attributes.Language);
+        Append(">");
+        m_open.push_back(Details::SsmlElement::Speak);
+    }
+
+    /// <summary>
+    /// Starts a voice element. It must be a child of the speak element.
+    /// </summary>
+    /// <param name="attributes">The attributes of the element.</param>
+    void StartVoice(const SsmlVoiceAttributes& attributes)
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_STATE, m_open.size() != 1);
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, attributes.Name.empty());
+        Append("<voice");
+        AppendAttribute(" name=\"", attributes.Name);
+        Append(">");
+        m_open.push_back(Details::SsmlElement::Voice);
+    }
+
+    /// <summary>
+    /// Starts an mstts:express-as element inside a voice element.
+    /// </summary>
+    /// <param name="attributes">The attributes of the element.</param>
+    void StartExpressAs(const SsmlExpressAsAttributes& attributes)
+    {
+        CheckInVoice();
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, attributes.Style.empty());
+        Append("<mstts:express-as");
+        AppendAttribute(" style=\"", attributes.Style);
+        AppendAttribute(" styledegree=\"", attributes.StyleDegree);
+        AppendAttribute(" role=\"", attributes.Role);
+        Append(">");
+        m_open.push_back(Details::SsmlElement::ExpressAs);
+    }
+
+    /// <summary>
+    /// Starts a prosody element inside a voice element.
+    /// </summary>
+    /// <param name="attributes">The attributes of the element.</param>
+    void StartProsody(const SsmlProsodyAttributes& attributes)
+    {
+        CheckInVoice();
+        Append("<prosody");
+        AppendAttribute(" rate=\"", attributes.Rate);
+        AppendAttribute(" pitch=\"", attributes.Pitch);
+        AppendAttribute(" volume=\"", attributes.Volume);
+        AppendAttribute(" contour=\"", attributes.Contour);
+        AppendAttribute(" range=\"", attributes.Range);
+        Append(">");
+        m_open.push_back(Details::SsmlElement::Prosody);
+    }
+
+    /// <summary>
+    /// Writes text to be spoken, escaping markup characters.
+    /// </summary>
+    /// <param name="text">The text, in UTF-8.</param>
+    void Text(const std::string& text)
+    {
+        CheckInVoice();
+        AppendEscaped(text, false);
+    }
+
+    /// <summary>
+    /// Writes a bookmark element, raising a bookmark event when the synthesis reaches it.
+    /// </summary>
+    /// <param name="mark">The name of the bookmark, not empty.</param>
+    void Bookmark(const std::string& mark)
+    {
+        CheckInVoice();
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, mark.empty());
+        AppendAttribute("<bookmark mark=\"", mark);
+        Append("/>");
+    }
+
+    /// <summary>
+    /// Writes a break element, a pause of the given length.
+    /// </summary>
+    /// <param name="milliseconds">The length of the pause in milliseconds.</param>
+    void Break(uint32_t milliseconds)
+    {
+        CheckInVoice();
+        Append("<break time=\"");
+        Append(std::to_string(milliseconds));
+        Append("ms\"/>");
+    }
+
+    /// <summary>
+    /// Ends the innermost element that is open.
+    /// </summary>
+    void EndElement()
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_STATE, m_open.empty());
+        switch (m_open.back())
+        {
+        case Details::SsmlElement::Speak:
+            Append("</speak>");
+            m_ended = true;
+            break;
+        case Details::SsmlElement::Voice: Append("</voice>"); break;
+        case Details::SsmlElement::ExpressAs: Append("</mstts:express-as>"); break;
+        case Details::SsmlElement::Prosody: Append("</prosody>"); break;
+        }
+        m_open.pop_back();
+    }
+
+    /// <summary>
+    /// Ends all elements that are open, completing the document.
+    /// </summary>
+    /// <returns>The document.</returns>
+    const std::string& EndDocument()
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_STATE, m_open.empty());
+        while (!m_open.empty())
+        {
+            EndElement();
+        }
+        return m_buffer;
+    }
+
+    /// <summary>
+    /// Gets whether the speak element has been ended.
+    /// </summary>
+    /// <returns>true if the document is complete.</returns>
+    bool IsComplete() const
+    {
+        return m_ended;
+    }
+
+    /// <summary>
+    /// Gets the document written so far.
+    /// </summary>
+    /// <returns>The document.</returns>
+    const std::string& GetSsml() const
+    {
+        return m_buffer;
+    }
+
+    /// <summary>
+    /// Gets the size of the document written so far.
+    /// </summary>
+    /// <returns>The size in bytes.</returns>
+    size_t GetSize() const
+    {
+        return m_size;
+    }
+
+private:
+
+    DISABLE_COPY_AND_MOVE(SsmlWriter);
+
+    void CheckInVoice() const
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_STATE, m_open.size() < 2);
+    }
+
+    void Append(const char* data, size_t size)
+    {
+        m_size += size;
+        if (!m_measuring)
+        {
+            m_buffer.append(data, size);
+        }
+    }
+
+    template <size_t N>
+    void Append(const char (&literal)[N])
+    {
+        Append(literal, N - 1);
+    }
+
+    void Append(const std::string& text)
+    {
+        Append(text.data(), text.size());
+    }
+
+    void AppendEscaped(const std::string& text, bool attribute)
+    {
+        auto data = text.data();
+        size_t pos = 0;
+        while (pos < text.size())
+        {
+            auto next = Details::FindXmlEscape(data, text.size(), pos, attribute);
+            Append(data + pos, next - pos);
+            if (next == text.size())
+            {
+                break;
+            }
+            auto entity = Details::GetXmlEntity(static_cast<unsigned char>(data[next]), attribute);
+            Append(entity, std::strlen(entity));
+            pos = next + 1;
+        }
+    }
+
+    template <size_t N>
+    void AppendAttribute(const char (&prefix)[N], const std::string& value)
+    {
+        if (!value.empty())
+        {
+            Append(prefix);
+            AppendEscaped(value, true);
+            Append("\"");
+        }
+    }
+
+    std::string m_buffer;
+    std::vector<Details::SsmlElement> m_open;
+    size_t m_size = 0;
+    bool m_ended = false;
+    bool m_measuring = false;
+};
+
+} } } // Microsoft::CognitiveServices::Speech
@@ -5,6 +5,9 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <codecvt>
 #include <locale>
@@ -83,6 +86,72 @@ inline static std::string CopyAndFreePropertyString(const char* value)
     return copy;
 }
 
+// Writes the decimal digits of a value and a terminating null into a buffer, without allocating. Returns the number of
+// digits, or 0 if the buffer is too small.
+inline size_t FormatDecimal(uint64_t value, char* buffer, size_t size)
+{
+    static const char pairs[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+
+    // Two digits per division, from the end of a local buffer.
+    char digits[20];
+    auto p = digits + sizeof(digits);
+    while (value >= 100)
+    {
+        auto pair = static_cast<size_t>(value % 100) * 2;
+        value /= 100;
+        *--p = pairs[pair + 1];
+        *--p = pairs[pair];
+    }
+    if (value >= 10)
+    {
+        auto pair = static_cast<size_t>(value) * 2;
+        *--p = pairs[pair + 1];
+        *--p = pairs[pair];
+    }
+    else
+    {
+        *--p = static_cast<char>('0' + value);
+    }
+
+    auto count = static_cast<size_t>(digits + sizeof(digits) - p);
+    if (count >= size)
+    {
+        return 0;
+    }
+    std::memcpy(buffer, p, count);
+    buffer[count] = '\0';
+    return count;
+}
+
+// Reads an unsigned decimal number made of digits only, independently of the locale. Returns false for an empty text,
+// any other character or a value that does not fit in 64 bits.
+inline bool ParseDecimal(const char* text, uint64_t& value)
+{
+    if (*text == '\0')
+    {
+        return false;
+    }
+    uint64_t result = 0;
+    for (; *text != '\0'; text++)
+    {
+        if (*text < '0' || *text > '9')
+        {
+            return false;
+        }
+        auto digit = static_cast<uint64_t>(*text - '0');
+        if (result > (UINT64_MAX - digit) / 10)
+        {
+            return false;
+        }
+        result = result * 10 + digit;
+    }
+    value = result;
+    return true;
+}
+
 template<typename TCHAR>
 inline static size_t Find(const TCHAR* pStr, const size_t numChars, const TCHAR find, size_t startAt = 0)
 {
@@ -46,6 +46,8 @@ private:
             return hpropbag;
         }())
         {
+            // Results do not change once received.
+            EnableReadCache();
         }
     };
 
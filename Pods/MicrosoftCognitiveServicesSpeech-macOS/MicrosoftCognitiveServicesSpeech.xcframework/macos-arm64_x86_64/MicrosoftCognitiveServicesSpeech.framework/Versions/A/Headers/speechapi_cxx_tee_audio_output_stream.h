@@ -0,0 +1,364 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_tee_audio_output_stream.h: Public API declarations for TeeAudioOutputStream C++ class
+//
+
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "speechapi_cxx_common.h"
+#include "speechapi_cxx_audio_stream.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+namespace Audio {
+
+/// <summary>
+/// Options of a sink of a <see cref="TeeAudioOutputStream"/>.
+/// </summary>
+struct TeeAudioSinkOptions
+{
+    /// <summary>
+    /// Maximum number of bytes waiting for the sink. A chunk that does not fit is dropped for this sink only, and
+    /// counted in its metrics; a chunk larger than this is still queued when the queue is empty. Raise it for sinks
+    /// that must get all the audio, such as files, by the most they may lag behind.
+    /// </summary>
+    size_t MaxQueuedBytes = 4 * 1024 * 1024;
+};
+
+/// <summary>
+/// Counters of a sink of a <see cref="TeeAudioOutputStream"/>.
+/// </summary>
+struct TeeAudioSinkMetrics
+{
+    /// <summary>
+    /// Number of bytes passed to the sink.
+    /// </summary>
+    uint64_t DeliveredBytes = 0;
+
+    /// <summary>
+    /// Number of bytes dropped because the queue was full.
+    /// </summary>
+    uint64_t DroppedBytes = 0;
+
+    /// <summary>
+    /// Number of chunks dropped because the queue was full.
+    /// </summary>
+    uint64_t DroppedChunks = 0;
+
+    /// <summary>
+    /// Number of bytes waiting for the sink.
+    /// </summary>
+    size_t QueuedBytes = 0;
+
+    /// <summary>
+    /// Highest number of bytes that waited for the sink at once.
+    /// </summary>
+    size_t MaxQueuedBytes = 0;
+
+    /// <summary>
+    /// How long the oldest chunk waiting for the sink has been waiting.
+    /// </summary>
+    std::chrono::milliseconds Lag{ 0 };
+
+    /// <summary>
+    /// Longest time a chunk waited before being passed to the sink.
+    /// </summary>
+    std::chrono::milliseconds MaxLag{ 0 };
+
+    /// <summary>
+    /// Whether the sink threw; it gets no more audio afterwards.
+    /// </summary>
+    bool Failed = false;
+};
+
+}
+
+/*! \cond PRIVATE */
+
+namespace Details {
+
+    struct TeeAudioChunk
+    {
+        std::shared_ptr<const std::vector<uint8_t>> data;
+        std::chrono::steady_clock::time_point written;
+    };
+
+    struct TeeAudioSink
+    {
+        std::function<void(const std::shared_ptr<const std::vector<uint8_t>>&)> write;
+        std::function<void()> close;
+        Audio::TeeAudioSinkOptions options;
+        Audio::TeeAudioSinkMetrics metrics;
+        std::deque<TeeAudioChunk> queue;
+        std::condition_variable ready;
+        bool draining = false;
+        bool closing = false;
+        bool stopping = false;
+    };
+
+    // Shared with the threads of the sinks, which may outlive the stream.
+    struct TeeAudioState
+    {
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::vector<std::shared_ptr<TeeAudioSink>> sinks;
+        bool closed = false;
+
+        // Runs on the thread of the sink: passes the queued chunks to it, then calls its close callback once the
+        // stream is closed, and exits. Exits after the queued chunks once the stream is destroyed.
+        static void RunSink(const std::shared_ptr<TeeAudioState>& state, const std::shared_ptr<TeeAudioSink>& sink)
+        {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            for (;;)
+            {
+                if (sink->queue.empty())
+                {
+                    if (sink->closing && sink->close)
+                    {
+                        auto close = std::move(sink->close);
+                        sink->close = nullptr;
+                        lock.unlock();
+                        auto failed = false;
+                        try
+                        {
+                            close();
+                        }
+                        catch (...)
+                        {
+                            failed = true;
+                        }
+                        lock.lock();
+                        sink->metrics.Failed = sink->metrics.Failed || failed;
+                        continue;
+                    }
+                    if (sink->draining)
+                    {
+                        sink->draining = false;
+                        state->changed.notify_all();
+                    }
+                    if (sink->closing || sink->stopping)
+                    {
+                        return;
+                    }
+                    sink->ready.wait(lock, [&sink]() { return !sink->queue.empty() || sink->closing || sink->stopping; });
+                    continue;
+                }
+
+                auto chunk = std::move(sink->queue.front());
+                sink->queue.pop_front();
+                auto lag = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - chunk.written);
+                sink->metrics.MaxLag = std::max(sink->metrics.MaxLag, lag);
+                auto failed = sink->metrics.Failed;
+                lock.unlock();
+                if (!failed)
+                {
+                    try
+                    {
+                        sink->write(chunk.data);
+                    }
+                    catch (...)
+                    {
+                        failed = true;
+                    }
+                }
+                lock.lock();
+                sink->metrics.QueuedBytes -= chunk.data->size();
+                if (failed)
+                {
+                    sink->metrics.Failed = true;
+                }
+                else
+                {
+                    sink->metrics.DeliveredBytes += chunk.data->size();
+                }
+            }
+        }
+    };
+
+}
+
+/*! \endcond */
+
+namespace Audio {
+
+/// <summary>
+/// A push audio output stream passing the synthesized audio to several sinks, e.g. live playback, a file and a meter,
+/// from a single synthesis.
+/// </summary>
+/// <remarks>
+/// Each chunk written by the synthesizer is copied once, and the same reference-counted chunk is passed to every sink.
+/// Each sink has its own bounded queue, drained by its own thread, so a slow sink only delays itself: when its queue
+/// is full, audio is dropped for that sink only. Writing to the stream never
+/// waits for a sink. Each sink is called on its own thread, in the order the audio was written; the thread exits
+/// after the close callback, or after the queued audio once the stream is destroyed.
+/// </remarks>
+class TeeAudioOutputStream : public PushAudioOutputStream
+{
+public:
+
+    using SinkWriteCallbackFunction_Type = ::std::function<void(const std::shared_ptr<const std::vector<uint8_t>>&)>;
+    using SinkCloseCallbackFunction_Type = ::std::function<void()>;
+
+    /// <summary>
+    /// Creates a stream without sinks.
+    /// </summary>
+    /// <returns>A shared pointer to the stream, to pass to <see cref="AudioConfig::FromStreamOutput"/>.</returns>
+    static std::shared_ptr<TeeAudioOutputStream> Create()
+    {
+        SPXAUDIOSTREAMHANDLE haudioStream = SPXHANDLE_INVALID;
+        SPX_THROW_ON_FAIL(audio_stream_create_push_audio_output_stream(&haudioStream));
+
+        auto stream = new TeeAudioOutputStream(haudioStream);
+        std::shared_ptr<TeeAudioOutputStream> ptr(stream);
+        SPX_THROW_ON_FAIL(push_audio_output_stream_set_callbacks(haudioStream, stream, WriteCallbackWrapper, CloseCallbackWrapper));
+        return ptr;
+    }
+
+    /// <summary>
+    /// Adds a sink. It gets the audio written from now on.
+    /// </summary>
+    /// <param name="writeCallback">Called with each chunk of audio. The chunk may be kept after the call.</param>
+    /// <param name="closeCallback">Called after the last chunk, once the synthesizer closed the stream.</param>
+    /// <param name="options">The options of the sink.</param>
+    /// <returns>The index of the sink, for <see cref="GetSinkMetrics"/>.</returns>
+    size_t AddSink(SinkWriteCallbackFunction_Type writeCallback, SinkCloseCallbackFunction_Type closeCallback = nullptr, const TeeAudioSinkOptions& options = TeeAudioSinkOptions())
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, writeCallback == nullptr);
+        auto sink = std::make_shared<Details::TeeAudioSink>();
+        sink->write = std::move(writeCallback);
+        sink->close = std::move(closeCallback);
+        sink->options = options;
+
+        std::unique_lock<std::mutex> lock(m_state->mutex);
+        SPX_THROW_HR_IF(SPXERR_INVALID_STATE, m_state->closed);
+        std::thread(Details::TeeAudioState::RunSink, m_state, sink).detach();
+        m_state->sinks.push_back(sink);
+        return m_state->sinks.size() - 1;
+    }
+
+    /// <summary>
+    /// Destructor. Does not wait for the sinks; their threads pass the audio already queued to them, then exit.
+    /// </summary>
+    ~TeeAudioOutputStream()
+    {
+        std::unique_lock<std::mutex> lock(m_state->mutex);
+        for (const auto& sink : m_state->sinks)
+        {
+            sink->stopping = true;
+            sink->ready.notify_one();
+        }
+    }
+
+    /// <summary>
+    /// Gets the counters of a sink.
+    /// </summary>
+    /// <param name="sink">The index returned by <see cref="AddSink"/>.</param>
+    /// <returns>A copy of the counters.</returns>
+    TeeAudioSinkMetrics GetSinkMetrics(size_t sink) const
+    {
+        std::unique_lock<std::mutex> lock(m_state->mutex);
+        SPX_THROW_HR_IF(SPXERR_OUT_OF_RANGE, sink >= m_state->sinks.size());
+        const auto& state = *m_state->sinks[sink];
+        auto metrics = state.metrics;
+        if (!state.queue.empty())
+        {
+            metrics.Lag = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - state.queue.front().written);
+        }
+        return metrics;
+    }
+
+    /// <summary>
+    /// Waits until all audio written so far has been passed to the sinks and, if the synthesizer closed the stream,
+    /// their close callbacks have returned.
+    /// </summary>
+    void WaitUntilDrained() const
+    {
+        std::unique_lock<std::mutex> lock(m_state->mutex);
+        m_state->changed.wait(lock, [this]() {
+            return std::all_of(m_state->sinks.begin(), m_state->sinks.end(), [](const std::shared_ptr<Details::TeeAudioSink>& sink) { return !sink->draining; });
+        });
+    }
+
+protected:
+
+    /*! \cond PROTECTED */
+
+    /// <summary>
+    /// Internal constructor. Creates a new instance using the provided handle.
+    /// </summary>
+    explicit TeeAudioOutputStream(SPXAUDIOSTREAMHANDLE haudioStream) :
+        PushAudioOutputStream(haudioStream),
+        m_state(std::make_shared<Details::TeeAudioState>())
+    {
+    }
+
+    /*! \endcond */
+
+private:
+
+    DISABLE_COPY_AND_MOVE(TeeAudioOutputStream);
+
+    static int WriteCallbackWrapper(void* pvContext, uint8_t* dataBuffer, uint32_t size)
+    {
+        auto stream = static_cast<TeeAudioOutputStream*>(pvContext);
+        auto& state = stream->m_state;
+        if (size == 0)
+        {
+            return 0;
+        }
+
+        Details::TeeAudioChunk chunk{ std::make_shared<const std::vector<uint8_t>>(dataBuffer, dataBuffer + size), std::chrono::steady_clock::now() };
+        std::unique_lock<std::mutex> lock(state->mutex);
+        for (const auto& sink : state->sinks)
+        {
+            if (sink->metrics.Failed)
+            {
+                continue;
+            }
+            auto fits = sink->metrics.QueuedBytes == 0 || sink->metrics.QueuedBytes + size <= sink->options.MaxQueuedBytes;
+            if (!fits)
+            {
+                sink->metrics.DroppedBytes += size;
+                sink->metrics.DroppedChunks++;
+                continue;
+            }
+            sink->queue.push_back(chunk);
+            sink->metrics.QueuedBytes += size;
+            sink->metrics.MaxQueuedBytes = std::max(sink->metrics.MaxQueuedBytes, sink->metrics.QueuedBytes);
+            sink->draining = true;
+            sink->ready.notify_one();
+        }
+        return static_cast<int>(size);
+    }
+
+    static void CloseCallbackWrapper(void* pvContext)
+    {
+        auto stream = static_cast<TeeAudioOutputStream*>(pvContext);
+        auto& state = stream->m_state;
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->closed = true;
+        for (const auto& sink : state->sinks)
+        {
+            sink->closing = true;
+            sink->draining = true;
+            sink->ready.notify_one();
+        }
+    }
+
+    std::shared_ptr<Details::TeeAudioState> m_state;
+};
+
+} } } } // Microsoft::CognitiveServices::Speech::Audio
@@ -43,6 +43,8 @@ private:
             return hpropbag;
         }())
         {
+            // Results do not change once received.
+            EnableReadCache();
         }
     };
 
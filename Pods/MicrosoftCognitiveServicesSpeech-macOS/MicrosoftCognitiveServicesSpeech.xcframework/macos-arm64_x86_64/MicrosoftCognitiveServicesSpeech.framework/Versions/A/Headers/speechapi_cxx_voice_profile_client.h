@@ -11,6 +11,7 @@
 
 #include "speechapi_c.h"
 #include "speechapi_cxx_common.h"
+#include "speechapi_cxx_async_executor.h"
 #include "speechapi_cxx_properties.h"
 #include "speechapi_cxx_voice_profile.h"
 #include "speechapi_cxx_voice_profile_result.h"
@@ -89,7 +90,7 @@ public:
     std::future<std::shared_ptr<VoiceProfile>> CreateProfileAsync(VoiceProfileType profileType, const SPXSTRING& locale)
     {
         auto keepAlive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [profileType, locale, this, keepAlive]() -> std::shared_ptr<VoiceProfile> {
+        auto future = Details::RunAsync([profileType, locale, this, keepAlive]() -> std::shared_ptr<VoiceProfile> {
             SPXVOICEPROFILEHANDLE hVoiceProfileHandle;
             SPX_THROW_ON_FAIL(::create_voice_profile(m_hVoiceProfileClient, static_cast<int>(profileType), Utils::ToUTF8(locale).c_str(), &hVoiceProfileHandle));
             return std::shared_ptr<VoiceProfile> { new VoiceProfile(hVoiceProfileHandle) };
@@ -107,7 +108,7 @@ public:
     std::future<std::shared_ptr<VoiceProfileEnrollmentResult>> EnrollProfileAsync(std::shared_ptr<VoiceProfile> profile, std::shared_ptr<Audio::AudioConfig> audioInput = nullptr)
     {
         auto keepAlive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [profile, audioInput, this, keepAlive]() -> std::shared_ptr<VoiceProfileEnrollmentResult> {
+        auto future = Details::RunAsync([profile, audioInput, this, keepAlive]() -> std::shared_ptr<VoiceProfileEnrollmentResult> {
              SPXRESULTHANDLE hresult;
             SPX_THROW_ON_FAIL(::enroll_voice_profile(m_hVoiceProfileClient,
                 Utils::HandleOrInvalid<SPXVOICEPROFILEHANDLE, VoiceProfile>(profile),
@@ -126,7 +127,7 @@ public:
     std::future<std::shared_ptr<VoiceProfileResult>> DeleteProfileAsync(std::shared_ptr<VoiceProfile> profile)
     {
         auto keepAlive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [profile, this, keepAlive]() -> std::shared_ptr<VoiceProfileResult> {
+        auto future = Details::RunAsync([profile, this, keepAlive]() -> std::shared_ptr<VoiceProfileResult> {
             SPXRESULTHANDLE hResultHandle;
             SPX_THROW_ON_FAIL(::delete_voice_profile(m_hVoiceProfileClient,
                 Utils::HandleOrInvalid<SPXVOICEPROFILEHANDLE, VoiceProfile>(profile),
@@ -144,7 +145,7 @@ public:
     std::future<std::shared_ptr<VoiceProfileResult>> ResetProfileAsync(std::shared_ptr<VoiceProfile> profile)
     {
         auto keepAlive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [profile, this, keepAlive]() -> std::shared_ptr<VoiceProfileResult> {
+        auto future = Details::RunAsync([profile, this, keepAlive]() -> std::shared_ptr<VoiceProfileResult> {
             SPXRESULTHANDLE hResultHandle;
             SPX_THROW_ON_FAIL(::reset_voice_profile(m_hVoiceProfileClient,
                 Utils::HandleOrInvalid<SPXVOICEPROFILEHANDLE, VoiceProfile>(profile),
@@ -163,7 +164,7 @@ public:
     std::future<std::shared_ptr<VoiceProfileEnrollmentResult>> RetrieveEnrollmentResultAsync(const SPXSTRING& voiceProfileId, VoiceProfileType voiceProfileType)
     {
         auto keepAlive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [voiceProfileId, voiceProfileType, this, keepAlive]() -> std::shared_ptr<VoiceProfileEnrollmentResult> {
+        auto future = Details::RunAsync([voiceProfileId, voiceProfileType, this, keepAlive]() -> std::shared_ptr<VoiceProfileEnrollmentResult> {
             SPXRESULTHANDLE hResultHandle;
             SPX_THROW_ON_FAIL(::retrieve_enrollment_result(m_hVoiceProfileClient, Utils::ToUTF8(voiceProfileId).c_str(), static_cast<int>(voiceProfileType), &hResultHandle));
             return std::make_shared<VoiceProfileEnrollmentResult>(hResultHandle);
@@ -189,7 +190,7 @@ public:
     std::future<std::vector<std::shared_ptr<VoiceProfile>>> GetAllProfilesAsync(VoiceProfileType voiceProfileType)
     {
         auto keepAlive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [voiceProfileType, this, keepAlive]() -> std::vector<std::shared_ptr<VoiceProfile>>
+        auto future = Details::RunAsync([voiceProfileType, this, keepAlive]() -> std::vector<std::shared_ptr<VoiceProfile>>
         {
             std::vector<std::shared_ptr<VoiceProfile>> list;
 
@@ -215,7 +216,7 @@ public:
     std::future<std::shared_ptr<VoiceProfilePhraseResult>> GetActivationPhrasesAsync(VoiceProfileType voiceProfileType, const SPXSTRING& locale)
     {
         auto keepAlive = this->shared_from_this();
-        auto future = std::async(std::launch::async, [voiceProfileType, locale, this, keepAlive]() -> std::shared_ptr<VoiceProfilePhraseResult> {
+        auto future = Details::RunAsync([voiceProfileType, locale, this, keepAlive]() -> std::shared_ptr<VoiceProfilePhraseResult> {
             SPXRESULTHANDLE hresult;
             SPX_THROW_ON_FAIL(::get_activation_phrases(m_hVoiceProfileClient,
                 Utils::ToUTF8(locale).c_str(),
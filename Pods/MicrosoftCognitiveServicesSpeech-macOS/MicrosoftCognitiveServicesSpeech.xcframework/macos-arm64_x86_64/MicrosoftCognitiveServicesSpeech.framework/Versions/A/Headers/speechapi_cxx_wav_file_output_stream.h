@@ -0,0 +1,288 @@
+//
+// Copyright (c) Microsoft. All rights reserved.
+// See https://aka.ms/csspeech/license for the full license information.
+//
+// speechapi_cxx_wav_file_output_stream.h: Public API declarations for WavFileOutputStreamCallback C++ class
+//
+
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "speechapi_cxx_common.h"
+#include "speechapi_cxx_audio_stream.h"
+
+namespace Microsoft {
+namespace CognitiveServices {
+namespace Speech {
+
+/*! \cond PRIVATE */
+
+namespace Details {
+
+    // Layout of the header written before the audio: the RIFF header, a JUNK chunk the size of a ds64 chunk, so that
+    // the file can become RF64 without moving the audio, the fmt chunk and the data chunk header.
+    struct WavLayout
+    {
+        static constexpr size_t Ds64Size = 28;
+        static constexpr size_t RiffSizeOffset = 4;
+        static constexpr size_t JunkOffset = 12;
+        static constexpr size_t FormatOffset = JunkOffset + 8 + Ds64Size;
+        static constexpr size_t DataOffset = FormatOffset + 8 + 16;
+        static constexpr size_t HeaderSize = DataOffset + 8;
+    };
+
+    inline uint8_t* PutLittleEndian(uint8_t* data, uint64_t value, size_t size)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            data[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+        return data + size;
+    }
+
+    inline uint8_t* PutTag(uint8_t* data, const char* tag)
+    {
+        std::memcpy(data, tag, 4);
+        return data + 4;
+    }
+
+}
+
+/*! \endcond */
+
+namespace Audio {
+
+/// <summary>
+/// A <see cref="PushAudioOutputStreamCallback"/> writing the synthesized PCM audio to a WAV file as it arrives, so that
+/// memory use does not depend on the length of the audio.
+/// </summary>
+/// <remarks>
+/// The header is written with provisional sizes and patched on <see cref="Close"/>. Files whose RIFF size does not fit
+/// in 32 bits are written as RF64. Audio is buffered and written in blocks of the buffer size, at file offsets that are
+/// multiples of it. Write errors are not thrown into the synthesizer; check <see cref="HasFailed"/> after Close.
+/// The synthesizer must produce raw PCM in the format given at creation, e.g. with
+/// SpeechSynthesisOutputFormat::Raw16Khz16BitMonoPcm.
+/// </remarks>
+class WavFileOutputStreamCallback : public PushAudioOutputStreamCallback
+{
+public:
+
+    /// <summary>
+    /// Creates the file and a callback writing to it.
+    /// </summary>
+    /// <param name="fileName">The path of the file, replaced if it exists.</param>
+    /// <param name="samplesPerSecond">The sample rate of the audio.</param>
+    /// <param name="bitsPerSample">The number of bits per sample.</param>
+    /// <param name="channels">The number of channels.</param>
+    /// <param name="bufferSize">The size of the write buffer in bytes.</param>
+    /// <returns>A shared pointer to the callback, to pass to <see cref="AudioOutputStream::CreatePushStream"/>.</returns>
+    static std::shared_ptr<WavFileOutputStreamCallback> Create(const std::string& fileName, uint32_t samplesPerSecond = 16000, uint8_t bitsPerSample = 16, uint8_t channels = 1, size_t bufferSize = 1024 * 1024)
+    {
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, samplesPerSecond == 0 || bitsPerSample == 0 || bitsPerSample % 8 != 0 || channels == 0);
+        SPX_THROW_HR_IF(SPXERR_INVALID_ARG, bufferSize < Details::WavLayout::HeaderSize);
+        return std::shared_ptr<WavFileOutputStreamCallback>(new WavFileOutputStreamCallback(fileName, samplesPerSecond, bitsPerSample, channels, bufferSize));
+    }
+
+    /// <summary>
+    /// Destructor. Completes the file if the stream was not closed.
+    /// </summary>
+    ~WavFileOutputStreamCallback()
+    {
+        Close();
+    }
+
+    /// <summary>
+    /// Appends audio to the file. Called by the synthesizer.
+    /// </summary>
+    /// <param name="dataBuffer">The audio data.</param>
+    /// <param name="size">The size of the audio data in bytes.</param>
+    /// <returns>The number of bytes written, or 0 after a write error.</returns>
+    int Write(uint8_t* dataBuffer, uint32_t size) override
+    {
+        if (m_fd < 0 || m_failed)
+        {
+            return 0;
+        }
+        m_dataSize += size;
+        auto remaining = static_cast<size_t>(size);
+        while (remaining > 0)
+        {
+            auto count = std::min(remaining, m_bufferSize - m_buffered);
+            std::memcpy(m_buffer.get() + m_buffered, dataBuffer, count);
+            m_buffered += count;
+            dataBuffer += count;
+            remaining -= count;
+            if (m_buffered == m_bufferSize && !FlushBuffer())
+            {
+                return 0;
+            }
+        }
+        return static_cast<int>(size);
+    }
+
+    /// <summary>
+    /// Writes the remaining audio, patches the header and closes the file. Called by the synthesizer.
+    /// </summary>
+    void Close() override
+    {
+        if (m_fd < 0)
+        {
+            return;
+        }
+        // Chunks are padded to an even size.
+        if (!m_failed && m_dataSize % 2 != 0 && (m_buffered < m_bufferSize || FlushBuffer()))
+        {
+            m_buffer[m_buffered++] = 0;
+        }
+        if (!m_failed && FlushBuffer())
+        {
+            PatchHeader();
+        }
+        m_failed = ::close(m_fd) != 0 || m_failed;
+        m_fd = -1;
+    }
+
+    /// <summary>
+    /// Gets the number of audio bytes written so far.
+    /// </summary>
+    /// <returns>The size of the audio in bytes.</returns>
+    uint64_t GetDataSize() const
+    {
+        return m_dataSize;
+    }
+
+    /// <summary>
+    /// Gets whether the file was written as RF64, because it is larger than a RIFF file can be. Valid after Close.
+    /// </summary>
+    /// <returns>true for an RF64 file.</returns>
+    bool IsRf64() const
+    {
+        return m_rf64;
+    }
+
+    /// <summary>
+    /// Gets whether writing the file failed. The file is incomplete in that case.
+    /// </summary>
+    /// <returns>true after a write error.</returns>
+    bool HasFailed() const
+    {
+        return m_failed;
+    }
+
+private:
+
+    WavFileOutputStreamCallback(const std::string& fileName, uint32_t samplesPerSecond, uint8_t bitsPerSample, uint8_t channels, size_t bufferSize) :
+        m_bufferSize(bufferSize),
+        m_buffer(new uint8_t[bufferSize]),
+        m_blockAlign(static_cast<uint16_t>(channels * (bitsPerSample / 8)))
+    {
+        do
+        {
+            m_fd = ::open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        } while (m_fd < 0 && errno == EINTR);
+        SPX_THROW_HR_IF(SPXERR_FILE_OPEN_FAILED, m_fd < 0);
+
+        // Provisional sizes as for a stream of unknown length, so that a file cut short is still readable.
+        auto p = m_buffer.get();
+        p = Details::PutTag(p, "RIFF");
+        p = Details::PutLittleEndian(p, 0xffffffff, 4);
+        p = Details::PutTag(p, "WAVE");
+        p = Details::PutTag(p, "JUNK");
+        p = Details::PutLittleEndian(p, Details::WavLayout::Ds64Size, 4);
+        std::memset(p, 0, Details::WavLayout::Ds64Size);
+        p += Details::WavLayout::Ds64Size;
+        p = Details::PutTag(p, "fmt ");
+        p = Details::PutLittleEndian(p, 16, 4);
+        p = Details::PutLittleEndian(p, 1, 2);
+        p = Details::PutLittleEndian(p, channels, 2);
+        p = Details::PutLittleEndian(p, samplesPerSecond, 4);
+        p = Details::PutLittleEndian(p, static_cast<uint64_t>(samplesPerSecond) * m_blockAlign, 4);
+        p = Details::PutLittleEndian(p, m_blockAlign, 2);
+        p = Details::PutLittleEndian(p, bitsPerSample, 2);
+        p = Details::PutTag(p, "data");
+        p = Details::PutLittleEndian(p, 0xffffffff, 4);
+        m_buffered = static_cast<size_t>(p - m_buffer.get());
+    }
+
+    DISABLE_COPY_AND_MOVE(WavFileOutputStreamCallback);
+
+    bool WriteAt(const uint8_t* data, size_t size, uint64_t offset)
+    {
+        while (size > 0)
+        {
+            auto written = ::pwrite(m_fd, data, size, static_cast<off_t>(offset));
+            if (written < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (written <= 0)
+            {
+                m_failed = true;
+                return false;
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+            offset += static_cast<uint64_t>(written);
+        }
+        return true;
+    }
+
+    bool FlushBuffer()
+    {
+        if (!WriteAt(m_buffer.get(), m_buffered, m_fileSize))
+        {
+            return false;
+        }
+        m_fileSize += m_buffered;
+        m_buffered = 0;
+        return true;
+    }
+
+    void PatchHeader()
+    {
+        auto paddedDataSize = m_dataSize + m_dataSize % 2;
+        auto riffSize = Details::WavLayout::HeaderSize - 8 + paddedDataSize;
+        uint8_t field[8];
+        if (riffSize <= 0xffffffff)
+        {
+            Details::PutLittleEndian(field, riffSize, 4);
+            WriteAt(field, 4, Details::WavLayout::RiffSizeOffset);
+            Details::PutLittleEndian(field, m_dataSize, 4);
+            WriteAt(field, 4, Details::WavLayout::DataOffset + 4);
+            return;
+        }
+
+        // RF64: the 32 bit sizes are set to -1 and the real ones go into the ds64 chunk replacing the JUNK chunk.
+        uint8_t ds64[8 + Details::WavLayout::Ds64Size];
+        auto p = Details::PutTag(ds64, "ds64");
+        p = Details::PutLittleEndian(p, Details::WavLayout::Ds64Size, 4);
+        p = Details::PutLittleEndian(p, riffSize, 8);
+        p = Details::PutLittleEndian(p, m_dataSize, 8);
+        p = Details::PutLittleEndian(p, m_dataSize / m_blockAlign, 8);
+        Details::PutLittleEndian(p, 0, 4);
+        WriteAt(ds64, sizeof(ds64), Details::WavLayout::JunkOffset);
+        Details::PutTag(field, "RF64");
+        WriteAt(field, 4, 0);
+        m_rf64 = true;
+    }
+
+    const size_t m_bufferSize;
+    const std::unique_ptr<uint8_t[]> m_buffer;
+    const uint16_t m_blockAlign;
+    int m_fd = -1;
+    size_t m_buffered = 0;
+    uint64_t m_fileSize = 0;
+    uint64_t m_dataSize = 0;
+    bool m_rf64 = false;
+    bool m_failed = false;
+};
+
+} } } } // Microsoft::CognitiveServices::Speech::Audio